@@ -1,5 +1,14 @@
 #include <iostream>         // cout, cerr
-#include <cstdlib>          // EXIT_FAILURE
+#include <cstdlib>          // EXIT_FAILURE, strtoull
+#include <cerrno>           // Range errors of parsed arguments
+#include <cstdint>          // SIZE_MAX
+#include <chrono>           // Startup time measurement
+#include <cstring>          // memcpy
+#include <algorithm>        // min, equal
+#include <fstream>          // Images read by the decoding benchmark
+#include <functional>       // Cases of the vertex builder benchmark
+#include <string>
+#include <vector>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #define STB_IMAGE_IMPLEMENTATION
@@ -12,8 +21,24 @@
 
 #include "camera.h" // Camera class
 #include "cylinder.h" // Cylinder objects
+#include "cylinderIndexed.h" // Cylinder rendered with one indexed draw call
 #include "tube.h"  // Modified cylinder for tube objects
+#include "tubeIndexed.h" // Tube rendered with indices
 #include "Sphere.h" // Sphere objects
+#include "sceneResources.h" // Static scene VAOs / VBOs
+#include "common/shaderProgram.h" // Shader program with uniform location cache
+#include "common/vertexBufferObject.h" // Camera uniform block streamed every frame
+#include "common/objectTransform.h" // Model matrices with precomputed normal matrices
+#include "common/pointLightBuffer.h" // Scene lights in shader storage buffer
+#include "common/renderQueue.h" // Draws sorted by state
+#include "common/indirectDrawList.h" // Multi-draw indirect of geometry arena meshes
+#include "common/textureArray.h" // Material textures as layers of one texture
+#include "common/textureLoader.h" // Parallel texture decoding
+#include "common/threadPool.h" // Threads of the parallel decoding benchmark
+#include "common/textureStreamer.h" // Texture uploads through pixel buffers
+#include "common/textureCache.h" // Names of block-compressed layers
+#include "common/assetPack.h" // Memory-mapped baked assets
+#include "common/gpuObjectCounter.h" // Live OpenGL objects, counted where they are created and deleted
 
 using namespace std; // Standard namespace
 
@@ -34,24 +59,75 @@ namespace
     // Main GLFW window
     GLFWwindow* gWindow = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_TITLE, NULL, NULL);
 
-    // Textures 
-    GLuint grassTexture;
-    GLuint doorTexture;
-    GLuint shedTexture;
-    GLuint roofTexture;
-    GLuint firepitTexture;
-    GLuint blueTexture;
-    GLuint chairTexture;
-    GLuint redTexture;
-    GLuint barkTexture;
-    GLuint pineTexture;
-    GLuint knobTexture;
+    // Material textures, all of them are layers of one texture array
+    const GLsizei MATERIAL_TEXTURE_SIZE = 1024; // Every texture is resampled to this size
+    TextureArray gMaterialTextures;
+    // Decoded layers are uploaded a few per frame through pixel buffers, so loading never stalls rendering
+    const int TEXTURE_STREAMING_BUFFERS = 4;
+    const int TEXTURE_UPLOADS_PER_FRAME = 2;
+    TextureStreamer gTextureStreamer;
+    TextureLoader gTextureLoader; // Declared after the streamer, its decoding threads stop before the streamer is gone
+
+    // Baked geometry and compressed textures, mapped at startup (run with --bake to build it)
+    const char* const ASSET_PACK_FILENAME = "assets.pack";
+    AssetPack gAssetPack;
+    GLuint grassLayer;
+    GLuint doorLayer;
+    GLuint shedLayer;
+    GLuint roofLayer;
+    GLuint firepitLayer;
+    GLuint blueLayer;
+    GLuint chairLayer;
+    GLuint redLayer;
+    GLuint barkLayer;
+    GLuint pineLayer;
+    GLuint knobLayer;
+    // Material texture images and the layers they're loaded to
+    struct MaterialTextureFile { const char* filename; GLuint* layer; };
+    const MaterialTextureFile materialTextureFiles[] = {
+        { "images/grass.jpg", &grassLayer },
+        { "images/shed.jpg", &shedLayer },
+        { "images/door.jpg", &doorLayer },
+        { "images/roof.jpg", &roofLayer },
+        { "images/firepit.jpg", &firepitLayer },
+        { "images/blue.jpg", &blueLayer },
+        { "images/chair.jpg", &chairLayer },
+        { "images/red.jpg", &redLayer },
+        { "images/bark.jpg", &barkLayer },
+        { "images/pine.jpg", &pineLayer },
+        { "images/knob.jpg", &knobLayer },
+    };
 
     GLint gTexWrapMode = GL_REPEAT;
 
-    // Shader programs       
-    GLuint objectShaderId;
-    GLuint lightShaderId;
+    // Shader programs with their reflected uniform locations
+    ShaderProgram objectShader;
+    ShaderProgram arenaShader;
+    ShaderProgram lightShader;
+
+    // Static scene geometry, created once at startup
+    SceneResources gSceneResources;
+
+    // Draws of the frame, sorted to minimize state changes
+    RenderQueue gRenderQueue;
+    // Opaque objects drawn from the geometry arena, built once at startup
+    IndirectDrawList gSceneDrawList;
+    bool gUseMultiDraw = true; // Draw opaque objects with multi-draw indirect (or one by one through the render queue)
+
+    // Levels of detail of objects drawn through the render queue, kept between frames for hysteresis
+    // (multi-draw list keeps levels of its objects itself)
+    struct LodLevels
+    {
+        int blueChairPosts = -1;
+        int redChairPosts = -1;
+        int chairLegs = -1;
+        int trunks = -1;
+        int firepit = -1;
+        int firepitRim = -1;
+        int knob = -1;
+        int moon = -1;
+    };
+    LodLevels gLodLevels;
 
     // Camera
     Camera gCamera(glm::vec3(0.0f, 3.0f, 15.0f));  // Camera position
@@ -66,9 +142,70 @@ namespace
     float gDeltaTime = 0.0f; // Time between current frame and last frame
     float gLastFrame = 0.0f;
 
+    // Frame statistics, reported every STATS_INTERVAL seconds
+    const float STATS_INTERVAL = 5.0f;
+    float gStatsElapsed = 0.0f;
+    int gStatsFrames = 0;
+
     // Lighting   
     glm::vec3 firePos(0.0f, 0.5f, 2.5f);
     glm::vec3 moonPos(-3.0f, 12.0f, 9.0f);
+
+    // Uniform / storage block binding points, must match layout(binding = ...) in the shaders
+    const GLuint CAMERA_BLOCK_BINDING = 0;
+    const GLuint POINT_LIGHTS_BINDING = 0;
+    const GLuint OBJECTS_BINDING = 1;
+
+    // Material shininess of scene surfaces
+    const float GRASS_SHININESS = 24.0f;
+    const float DOOR_SHININESS = 28.0f;
+    const float CHAIR_SHININESS = 15.0f;
+    const float WOOD_SHININESS = 35.0f;
+    const float SHED_SHININESS = 20.0f;
+    const float PINE_SHININESS = 27.0f;
+    const float ROOF_SHININESS = 18.0f;
+
+    // Grass texture is tiled over the ground
+    const glm::vec2 GRASS_UV_SCALE = glm::vec2(3.0f, 3.0f);
+
+    // Model transformations (translates, rotates, scales objects), their normal matrices are computed only once
+    const ObjectTransform groundTransform(glm::translate(glm::vec3(0.0f, 0.0f, 2.0f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(1.0f, 0.0f, 0.0f))) * glm::scale(glm::vec3(10.0f, 12.0f, 0.0f)));
+    const ObjectTransform doorTransform(glm::translate(glm::vec3(0.0f, 1.5f, -0.29f)) * glm::scale(glm::vec3(0.75f, 1.5f, 0.0f)));
+    const ObjectTransform blueBackTransform(glm::translate(glm::vec3(3.0f, 1.625f, 2.5f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(0.75f, 0.75f, 0.0f)));
+    const ObjectTransform blueSeatTransform(glm::translate(glm::vec3(2.5f, 0.875f, 2.5f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(1.0f, 0.0f, 0.0f))) * glm::scale(glm::vec3(0.5f, 0.75f, 0.0f)));
+    const ObjectTransform redBackTransform(glm::translate(glm::vec3(-3.0f, 1.625f, 2.5f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(0.75f, 0.75f, 0.0f)));
+    const ObjectTransform redSeatTransform(glm::translate(glm::vec3(-2.5f, 0.875f, 2.5f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(1.0f, 0.0f, 0.0f))) * glm::scale(glm::vec3(0.5f, 0.75f, 0.0f)));
+    const ObjectTransform firepitTransform(glm::translate(glm::vec3(0.0f, 0.0625f, 2.5f)) * glm::scale(glm::vec3(1.0f)));
+    const ObjectTransform firepitRimTransform(glm::translate(glm::vec3(0.0f, 0.125f, 2.5f)) * glm::scale(glm::vec3(1.0f)));
+    const ObjectTransform knobTransform(glm::translate(glm::vec3(-0.5f, 1.525f, -0.25f)) * glm::scale(glm::vec3(1.0f)));
+    const ObjectTransform shedTransform(glm::translate(glm::vec3(0.0f, 3.0f, -3.0f)) * glm::scale(glm::vec3(3.0f)));
+    const ObjectTransform roofTransform(glm::translate(glm::vec3(0.0f, 3.0f, -3.0f)) * glm::scale(glm::vec3(3.0f)));
+    // Each tree is made of two pyramids rotated by 45 degrees
+    const ObjectTransform leavesTransforms[] = {
+        ObjectTransform(glm::translate(glm::vec3(-2.25f, 4.0f, 10.0f)) * glm::rotate(glm::radians(45.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(1.0f, 3.0f, 1.0f))),
+        ObjectTransform(glm::translate(glm::vec3(2.25f, 4.0f, 10.0f)) * glm::rotate(glm::radians(45.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(1.0f, 3.0f, 1.0f))),
+        ObjectTransform(glm::translate(glm::vec3(-2.25f, 4.0f, 10.0f)) * glm::scale(glm::vec3(1.0f, 3.0f, 1.0f))),
+        ObjectTransform(glm::translate(glm::vec3(2.25f, 4.0f, 10.0f)) * glm::scale(glm::vec3(1.0f, 3.0f, 1.0f))),
+    };
+    const ObjectTransform moonTransform(glm::translate(moonPos) * glm::scale(glm::vec3(1.0f)));
+    const ObjectTransform fireTransforms[] = {
+        ObjectTransform(glm::translate(firePos) * glm::scale(glm::vec3(0.5f))),
+        ObjectTransform(glm::translate(firePos) * glm::rotate(glm::radians(45.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(0.5f))),
+    };
+
+    // Camera uniform block, std140 layout
+    struct CameraBlock
+    {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 viewPos;
+    };
+
+    // Camera data written once per frame, read by both shader programs, streamed through frame regions,
+    // so that writing it never waits for the GPU to finish the previous frame
+    VertexBufferObject gCameraBuffer;
+    // All point lights of the scene, shaded in a single pass
+    PointLightBuffer gPointLights;
 }
 
 //User-defined Function prototypes to initialize the program, set the window size, process mouse/keyboard 
@@ -79,11 +216,19 @@ void UResizeWindow(GLFWwindow* window, int width, int height);
 void UProcessInput(GLFWwindow* window);
 void UMousePositionCallback(GLFWwindow* window, double xpos, double ypos);
 void UMouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
-bool UCreateTexture(const char* filename, GLuint& textureId);
-void UDestroyTexture(GLuint textureId);
 void URender();
-bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, GLuint& programId);
+bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, ShaderProgram& program);
 void UDestroyShaderProgram(GLuint programId);
+void UCreateUniformBuffers();
+void UDestroyUniformBuffers();
+bool UBuildSceneDrawList();
+bool UBakeAssetPack(const vector<string>& materialTextureFilenames);
+bool UBenchmarkDecode(vector<string> filenames);
+bool UBenchmarkVertexBuilder(size_t numVertices);
+bool UBenchmarkVertexLayouts(int numSlices);
+bool UBenchmarkNormalMatrices(int numCylinders);
+void UReportLiveGLObjects();
+bool UParseCountArgument(int argc, char* argv[], unsigned long long defaultValue, unsigned long long maxValue, unsigned long long& value);
 
 // Shaders                    
 // Object vertex shader source code
@@ -91,20 +236,87 @@ const GLchar* objectVertexShader = GLSL(440,
     layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoords;
+layout(location = 3) in mat4 aInstanceModel; // Per-instance model matrix (locations 3 - 6)
+layout(location = 7) in uint aInstanceMaterial; // Per-instance material index (texture layer, MATERIAL_LAYER keeps the layer of the material)
+layout(location = 8) in mat3 aInstanceNormalMatrix; // Per-instance normal matrix (locations 8 - 10)
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
+flat out float Shininess;
+flat out uint TextureLayer;
+
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix; // Inverse transpose of model matrix (up to scale)
+uniform bool instanced; // Take model matrix from instance attributes instead of the uniform
+uniform float shininess;
+uniform uint textureLayer; // Layer of material texture array
+uniform vec2 uvScale; // Scale of texture coordinates (tiling)
+
+const uint MATERIAL_LAYER = 0xFFFFFFFFu; // Must match InstancedMesh::MATERIAL_LAYER
+
+void main()
+{
+    mat4 objectModel = instanced ? aInstanceModel : model;
+
+    FragPos = vec3(objectModel * vec4(aPos, 1.0));
+    Normal = (instanced ? aInstanceNormalMatrix : normalMatrix) * aNormal; // Normal matrices are computed on CPU
+    TexCoords = aTexCoords * uvScale;
+    Shininess = shininess;
+    TextureLayer = (instanced && aInstanceMaterial != MATERIAL_LAYER) ? aInstanceMaterial : textureLayer;
+
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
+);
+
+// Vertex shader of objects drawn from geometry arena by multi-draw, source code
+const GLchar* arenaVertexShader = GLSL(440,
+    layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoords;
+layout(location = 11) in uint aDrawIndex; // Object index, fetched at baseInstance + gl_InstanceID
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+flat out float Shininess;
+flat out uint TextureLayer;
+
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+};
+
+// Must match ObjectData structure in indirectDrawList.h
+struct ObjectData {
+    mat4 model;
+    mat3 normalMatrix;
+    float shininess;
+    uint textureLayer;
+    vec2 uvScale;
+};
+
+layout(std430, binding = 1) readonly buffer Objects
+{
+    ObjectData objects[];
+};
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
-    TexCoords = aTexCoords;
+    FragPos = vec3(objects[aDrawIndex].model * vec4(aPos, 1.0));
+    Normal = objects[aDrawIndex].normalMatrix * aNormal;
+    TexCoords = aTexCoords * objects[aDrawIndex].uvScale;
+    Shininess = objects[aDrawIndex].shininess;
+    TextureLayer = objects[aDrawIndex].textureLayer;
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
@@ -115,58 +327,79 @@ const GLchar* objectFragmentShader = GLSL(440,
     out vec4 FragColor;
 
 struct Material {
-    sampler2D diffuse;
-    sampler2D specular;
-    float shininess;
+    sampler2DArray diffuse;
+    sampler2DArray specular;
 };
 
-struct Light {
+// Must match PointLight structure in pointLightBuffer.h
+struct PointLight {
     vec3 position;
-
+    float radius;
     vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-
     float constant;
+    vec3 diffuse;
     float linear;
+    vec3 specular;
     float quadratic;
 };
 
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
+flat in float Shininess;
+flat in uint TextureLayer;
+
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+};
+
+layout(std430, binding = 0) readonly buffer PointLights
+{
+    uint numLights;
+    PointLight lights[];
+};
 
-uniform vec3 viewPos;
 uniform Material material;
-uniform Light light;
-uniform Light light2;
 
 void main()
 {
-    // ambient
-    vec3 ambient = light.ambient * texture(material.diffuse, TexCoords).rgb;
-
-    // diffuse 
+    vec3 texCoords = vec3(TexCoords, float(TextureLayer));
+    vec3 diffuseColor = texture(material.diffuse, texCoords).rgb;
+    vec3 specularColor = texture(material.specular, texCoords).rgb;
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(light.position - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = light.diffuse * diff * texture(material.diffuse, TexCoords).rgb;
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
+
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < numLights; i++)
+    {
+        // Skip lights, which are too far away to contribute visibly
+        vec3 toLight = lights[i].position - FragPos;
+        float distance = length(toLight);
+        if (distance > lights[i].radius) {
+            continue;
+        }
 
-    // specular
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    vec3 specular = light.specular * spec * texture(material.specular, TexCoords).rgb;
+        // ambient
+        vec3 ambient = lights[i].ambient * diffuseColor;
 
-    // attenuation
-    float distance = length(light.position - FragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+        // diffuse
+        vec3 lightDir = toLight / distance;
+        float diff = max(dot(norm, lightDir), 0.0);
+        vec3 diffuse = lights[i].diffuse * diff * diffuseColor;
 
-    ambient *= attenuation;
-    diffuse *= attenuation;
-    specular *= attenuation;
+        // specular
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), Shininess);
+        vec3 specular = lights[i].specular * spec * specularColor;
 
-    vec3 result = ambient + diffuse + specular;
+        // attenuation
+        float attenuation = 1.0 / (lights[i].constant + lights[i].linear * distance + lights[i].quadratic * (distance * distance));
+
+        result += (ambient + diffuse + specular) * attenuation;
+    }
 
     FragColor = vec4(result, 1.0f);
 }
@@ -176,9 +409,14 @@ void main()
 const GLchar* lightVertexShader = GLSL(440,
     layout(location = 0) in vec3 aPos;
 
+layout(std140, binding = 0) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
@@ -201,128 +439,184 @@ void main()
 }
 );
 
-// Images are loaded with Y axis going down, but OpenGL's Y axis goes up, so let's flip it
-void flipImageVertically(unsigned char* image, int width, int height, int channels)
+// Vertex layout benchmark shaders, every attribute contributes to the position, so that none of them is skipped
+const GLchar* fetchVertexShader = GLSL(440,
+    layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec2 aTexCoords;
+layout(location = 2) in vec3 aNormal;
+
+void main()
 {
-    for (int j = 0; j < height / 2; ++j)
-    {
-        int index1 = j * width * channels;
-        int index2 = (height - 1 - j) * width * channels;
+    gl_Position = vec4(aPos + aNormal * (aTexCoords.x + aTexCoords.y), 1.0);
+}
+);
 
-        for (int i = width * channels; i > 0; --i)
-        {
-            unsigned char tmp = image[index1];
-            image[index1] = image[index2];
-            image[index2] = tmp;
-            ++index1;
-            ++index2;
-        }
-    }
+const GLchar* fetchFragmentShader = GLSL(440,
+    out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(1.0);
+}
+);
+
+// Normal matrix benchmark shaders, transformed normal contributes to the position, so that it is not skipped
+// Normal matrix inverted per vertex, as the object shader did before normal matrices were computed on CPU
+const GLchar* normalInverseVertexShader = GLSL(440,
+    layout(location = 0) in vec3 aPos;
+layout(location = 2) in vec3 aNormal;
+layout(location = 3) in mat4 aInstanceModel;
+
+uniform mat4 viewProjection;
+
+void main()
+{
+    vec3 normal = mat3(transpose(inverse(aInstanceModel))) * aNormal;
+    gl_Position = viewProjection * (aInstanceModel * vec4(aPos, 1.0)) + vec4(normal * 1e-3, 0.0);
 }
+);
+
+// Normal matrix read from per-instance attribute, computed on CPU
+const GLchar* normalAttributeVertexShader = GLSL(440,
+    layout(location = 0) in vec3 aPos;
+layout(location = 2) in vec3 aNormal;
+layout(location = 3) in mat4 aInstanceModel;
+layout(location = 8) in mat3 aInstanceNormalMatrix;
+
+uniform mat4 viewProjection;
+
+void main()
+{
+    vec3 normal = aInstanceNormalMatrix * aNormal;
+    gl_Position = viewProjection * (aInstanceModel * vec4(aPos, 1.0)) + vec4(normal * 1e-3, 0.0);
+}
+);
 
 int main(int argc, char* argv[])
 {
-    if (!UInitialize(argc, argv, &gWindow))
-        return EXIT_FAILURE;
+    // The decoding benchmark measures the image decoder alone, it needs no window
+    if (argc > 1 && string(argv[1]) == "--benchmark-decode")
+        return UBenchmarkDecode(vector<string>(argv + 2, argv + argc)) ? EXIT_SUCCESS : EXIT_FAILURE;
 
-    // Create the shader programs        
-    if (!UCreateShaderProgram(objectVertexShader, objectFragmentShader, objectShaderId))
-        return EXIT_FAILURE;
-    if (!UCreateShaderProgram(lightVertexShader, lightFragmentShader, lightShaderId))
+    // So does the benchmark of building vertex data on CPU, before anything gets uploaded
+    if (argc > 1 && string(argv[1]) == "--benchmark-vbo")
+    {
+        unsigned long long numVertices = 0;
+        // Builder writes 32 bytes per vertex, the buffer size must fit size_t
+        if (!UParseCountArgument(argc, argv, 1000000, SIZE_MAX / 32, numVertices))
+            return EXIT_FAILURE;
+        return UBenchmarkVertexBuilder(size_t(numVertices)) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    const auto startupStart = chrono::steady_clock::now();
+    if (!UInitialize(argc, argv, &gWindow))
         return EXIT_FAILURE;
 
-    // Load textures              
-    const char* texFilename0 = "images/grass.jpg";
-    if (!UCreateTexture(texFilename0, grassTexture))
+    // Vertex layout benchmark draws on the GPU, it needs the window, but none of the scene
+    if (argc > 1 && string(argv[1]) == "--benchmark-layouts")
     {
-        cout << "Failed to load texture " << texFilename0 << endl;
-        return EXIT_FAILURE;
+        // Zero slices would divide by zero while generating the meshes
+        unsigned long long numSlices = 0;
+        if (!UParseCountArgument(argc, argv, 65536, 1 << 24, numSlices))
+            return EXIT_FAILURE;
+        return UBenchmarkVertexLayouts(int(numSlices)) ? EXIT_SUCCESS : EXIT_FAILURE;
     }
-    // tell opengl for each sampler to which texture unit it belongs to (only has to be done once)
-    glUseProgram(objectShaderId);
-    // We set the texture as texture unit 0
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename1 = "images/shed.jpg";
-    if (!UCreateTexture(texFilename1, shedTexture))
+
+    // So does the benchmark of normal matrices, inverted per vertex on the GPU or once per instance on the CPU
+    if (argc > 1 && string(argv[1]) == "--benchmark-normals")
     {
-        cout << "Failed to load texture " << texFilename1 << endl;
-        return EXIT_FAILURE;
+        unsigned long long numCylinders = 0;
+        if (!UParseCountArgument(argc, argv, 10000, 1 << 24, numCylinders))
+            return EXIT_FAILURE;
+        return UBenchmarkNormalMatrices(int(numCylinders)) ? EXIT_SUCCESS : EXIT_FAILURE;
     }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename2 = "images/door.jpg";
-    if (!UCreateTexture(texFilename2, doorTexture))
-    {
-        cout << "Failed to load texture " << texFilename2 << endl;
+
+    // Baking builds the asset pack from loose images and generated meshes instead of rendering
+    const bool bakeAssets = argc > 1 && string(argv[1]) == "--bake";
+    if (!bakeAssets && !gAssetPack.open(ASSET_PACK_FILENAME))
+        cout << "No asset pack " << ASSET_PACK_FILENAME << ", loading assets from their source files" << endl;
+
+    // Create the shader programs        
+    if (!UCreateShaderProgram(objectVertexShader, objectFragmentShader, objectShader))
         return EXIT_FAILURE;
-    }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename3 = "images/roof.jpg";
-    if (!UCreateTexture(texFilename3, roofTexture))
-    {
-        cout << "Failed to load texture " << texFilename3 << endl;
+    if (!UCreateShaderProgram(arenaVertexShader, objectFragmentShader, arenaShader))
         return EXIT_FAILURE;
-    }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename4 = "images/firepit.jpg";
-    if (!UCreateTexture(texFilename4, firepitTexture))
-    {
-        cout << "Failed to load texture " << texFilename4 << endl;
+    if (!UCreateShaderProgram(lightVertexShader, lightFragmentShader, lightShader))
         return EXIT_FAILURE;
-    }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename5 = "images/blue.jpg";
-    if (!UCreateTexture(texFilename5, blueTexture))
-    {
-        cout << "Failed to load texture " << texFilename5 << endl;
+
+    // Create uniform buffers shared by both shader programs
+    UCreateUniformBuffers();
+
+    // Load material textures into layers of one texture array, draws then select them without rebinding
+    const auto texturesStart = chrono::steady_clock::now();
+    vector<string> materialTextureFilenames;
+    for (const auto& textureFile : materialTextureFiles)
+        materialTextureFilenames.push_back(textureFile.filename);
+    if (!gMaterialTextures.create(MATERIAL_TEXTURE_SIZE, MATERIAL_TEXTURE_SIZE, GLsizei(materialTextureFilenames.size()), TextureFormat::BC7))
         return EXIT_FAILURE;
-    }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename6 = "images/chair.jpg";
-    if (!UCreateTexture(texFilename6, chairTexture))
+
+    // Layers baked into the asset pack are uploaded right from its mapped pages, without opening the images
+    vector<string> streamedTextureFilenames;
+    vector<GLuint*> streamedTextureLayers;
+    for (const auto& textureFile : materialTextureFiles)
     {
-        cout << "Failed to load texture " << texFilename6 << endl;
-        return EXIT_FAILURE;
+        const AssetPack::Entry bakedLayer = gAssetPack.getEntry(TextureCache::getCacheFilename(textureFile.filename, gMaterialTextures.getFormat()));
+        if (bakedLayer.size == gMaterialTextures.getLayerDataSize())
+        {
+            *textureFile.layer = gMaterialTextures.reserveLayers(1);
+            gMaterialTextures.uploadLayer(*textureFile.layer, bakedLayer.data);
+        }
+        else if (!bakeAssets)
+        {
+            streamedTextureFilenames.push_back(textureFile.filename);
+            streamedTextureLayers.push_back(textureFile.layer);
+        }
     }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename7 = "images/red.jpg";
-    if (!UCreateTexture(texFilename7, redTexture))
-    {
-        cout << "Failed to load texture " << texFilename7 << endl;
+
+    // Other images are decoded (or read precompressed from the cache) on worker threads and streamed to the GPU
+    // during the first frames, rendering starts right away
+    if (!gTextureStreamer.create(gMaterialTextures.getLayerDataSize(), TEXTURE_STREAMING_BUFFERS))
         return EXIT_FAILURE;
-    }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename8 = "images/bark.jpg";
-    if (!UCreateTexture(texFilename8, barkTexture))
-    {
-        cout << "Failed to load texture " << texFilename8 << endl;
+    vector<int> materialTextureLayers;
+    if (!streamedTextureFilenames.empty() && !gTextureLoader.loadLayersAsync(gMaterialTextures, streamedTextureFilenames, materialTextureLayers, gTextureStreamer))
         return EXIT_FAILURE;
-    }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename9 = "images/pine.jpg";
-    if (!UCreateTexture(texFilename9, pineTexture))
-    {
-        cout << "Failed to load texture " << texFilename9 << endl;
+    for (size_t i = 0; i < materialTextureLayers.size(); i++)
+        *streamedTextureLayers[i] = materialTextureLayers[i];
+    const auto texturesEnd = chrono::steady_clock::now();
+
+    // Build the static scene geometry once, the render loop only binds it
+    // Without sharing, the reported frame time and live OpenGL objects show what sharing of identical meshes saves
+    const bool shareMeshes = !(argc > 1 && string(argv[1]) == "--no-mesh-sharing");
+    if (!shareMeshes)
+        cout << "Sharing of identical meshes is disabled" << endl;
+    if (!gSceneResources.create(gAssetPack.isOpen() ? &gAssetPack : nullptr, shareMeshes))
         return EXIT_FAILURE;
-    }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
-    const char* texFilename10 = "images/knob.jpg";
-    if (!UCreateTexture(texFilename10, knobTexture))
-    {
-        cout << "Failed to load texture " << texFilename10 << endl;
+    if (!UBuildSceneDrawList())
         return EXIT_FAILURE;
+
+    // OpenGL has copied everything used from the pack by now
+    gAssetPack.close();
+
+    // Baking skips the render loop, but releases everything the same way
+    int exitCode = EXIT_SUCCESS;
+    if (bakeAssets)
+    {
+        if (!UBakeAssetPack(materialTextureFilenames))
+            exitCode = EXIT_FAILURE;
+        glfwSetWindowShouldClose(gWindow, GLFW_TRUE);
     }
-    glUniform1i(glGetUniformLocation(objectShaderId, "uTexture"), 0);
-    
+
+    // Startup time breakdown, until the first frame can be rendered (textures keep arriving in the background)
+    const auto startupEnd = chrono::steady_clock::now();
+    const auto milliseconds = [](chrono::steady_clock::time_point start, chrono::steady_clock::time_point end)
+    {
+        return chrono::duration<double, milli>(end - start).count();
+    };
+    cout << "Startup took " << milliseconds(startupStart, startupEnd) << " ms: window and shaders " << milliseconds(startupStart, texturesStart)
+        << " ms, starting texture loads " << milliseconds(texturesStart, texturesEnd)
+        << " ms, geometry " << milliseconds(texturesEnd, startupEnd) << " ms" << endl;
+    UReportLiveGLObjects();
+
     // Sets the background color of the window to black-ish (it will be implicitely used by glClear)
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
@@ -335,6 +629,25 @@ int main(int argc, char* argv[])
         gDeltaTime = currentFrame - gLastFrame;
         gLastFrame = currentFrame;
 
+        // Report average frame time and owned GPU objects, so steady state can be verified over long runs
+        gStatsElapsed += gDeltaTime;
+        ++gStatsFrames;
+        if (gStatsElapsed >= STATS_INTERVAL)
+        {
+            const static_meshes_3D::MeshRegistry& meshRegistry = gSceneResources.getMeshRegistry();
+            cout << "Frame time: " << (gStatsElapsed * 1000.0f / gStatsFrames) << " ms, static scene GPU objects: " << gSceneResources.getGpuObjectCount()
+                << ", meshes: " << meshRegistry.getNumLiveMeshes() << " (hits " << meshRegistry.getHits() << ", misses " << meshRegistry.getMisses() << ")" << endl;
+            const RenderQueue::Statistics& queueStats = gRenderQueue.getLastFrameStatistics();
+            cout << "Last frame: " << queueStats.numDraws << " draws, state changes (saved): program " << queueStats.programChanges << " (" << queueStats.programChangesSaved
+                << "), VAO " << queueStats.vaoChanges << " (" << queueStats.vaoChangesSaved << "), texture " << queueStats.textureChanges << " (" << queueStats.textureChangesSaved
+                << "), uniform " << queueStats.uniformChanges << " (" << queueStats.uniformChangesSaved << ")" << endl;
+            if (gUseMultiDraw)
+                cout << "Multi-draw: " << gSceneDrawList.getNumDrawnIndices() << " indices at current levels of detail" << endl;
+            UReportLiveGLObjects();
+            gStatsElapsed = 0.0f;
+            gStatsFrames = 0;
+        }
+
         // input
         // -----
         UProcessInput(gWindow);
@@ -345,24 +658,26 @@ int main(int argc, char* argv[])
         glfwPollEvents();
     }
 
-    // Release texture     
-    UDestroyTexture(grassTexture);
-    UDestroyTexture(shedTexture);
-    UDestroyTexture(doorTexture);
-    UDestroyTexture(roofTexture);
-    UDestroyTexture(firepitTexture);
-    UDestroyTexture(blueTexture);
-    UDestroyTexture(chairTexture);
-    UDestroyTexture(redTexture);
-    UDestroyTexture(knobTexture);
-    UDestroyTexture(barkTexture);
-    UDestroyTexture(pineTexture);
+    // Stop loading textures first, its jobs write to the streamer and read the texture array
+    gTextureLoader.cancel();
+
+    // Release scene geometry
+    gSceneDrawList.destroy();
+    gSceneResources.destroy();
+
+    // Release textures
+    gTextureStreamer.destroy();
+    gMaterialTextures.destroy();
+
+    // Release uniform buffers
+    UDestroyUniformBuffers();
 
     // Release shader program        
-    UDestroyShaderProgram(objectShaderId);
-    UDestroyShaderProgram(lightShaderId);
+    UDestroyShaderProgram(objectShader.getProgramID());
+    UDestroyShaderProgram(arenaShader.getProgramID());
+    UDestroyShaderProgram(lightShader.getProgramID());
 
-    exit(EXIT_SUCCESS); // Terminates the program successfully
+    exit(exitCode); // Terminates the program
 }
 
 // Initialize GLFW, GLEW, and create a window
@@ -427,6 +742,16 @@ void UProcessInput(GLFWwindow* window)
     // Switch to orthographic/perspective
     if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS)
         orthographic = !orthographic;
+
+    // Switch between multi-draw indirect and render queue, once per key press
+    static bool multiDrawKeyWasPressed = false;
+    const bool multiDrawKeyPressed = glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS;
+    if (multiDrawKeyPressed && !multiDrawKeyWasPressed)
+    {
+        gUseMultiDraw = !gUseMultiDraw;
+        cout << "Drawing opaque objects " << (gUseMultiDraw ? "with multi-draw indirect" : "through render queue") << endl;
+    }
+    multiDrawKeyWasPressed = multiDrawKeyPressed;
 }
 
 // Whenever the window size changed (by OS or user resize) this callback function executes
@@ -469,6 +794,25 @@ void UMouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
 // Functioned called to render a frame
 void URender()
 {
+    // Upload a few decoded textures, never waiting for the GPU
+    gTextureStreamer.update(TEXTURE_UPLOADS_PER_FRAME);
+    static int framesUntilTexturesResident = 0;
+    if (framesUntilTexturesResident >= 0)
+    {
+        framesUntilTexturesResident++;
+        if (!gTextureLoader.isLoading() && gTextureStreamer.getNumPendingLayers() == 0)
+        {
+            const TextureLoader::Timings loadTimings = gTextureLoader.getLastTimings();
+            const TextureStreamer::Statistics streamStatistics = gTextureStreamer.getStatistics();
+            cout << "All " << gMaterialTextures.getNumLayers() << " textures resident (" << streamStatistics.numResidentLayers << " streamed) after "
+                << framesUntilTexturesResident << " frames: decode " << loadTimings.decodeMilliseconds << " ms, resample " << loadTimings.resampleMilliseconds
+                << " ms, compress " << loadTimings.compressMilliseconds << " ms summed over " << loadTimings.numThreads << " threads (" << loadTimings.numCacheHits
+                << " from cache), streaming " << streamStatistics.updateMilliseconds << " ms on render thread (" << streamStatistics.numStagingWaits
+                << " waits for a free staging buffer)" << endl;
+            framesUntilTexturesResident = -1;
+        }
+    }
+
     // Enable z-depth
     glEnable(GL_DEPTH_TEST);
 
@@ -476,239 +820,6 @@ void URender()
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Declare VAOs and VBOs     
-    unsigned int planeVao, planeVbo;
-    unsigned int shedVao, shedVbo;
-    unsigned int roofVao, roofVbo;
-    unsigned int cylinderVao, cylinderVbo;
-    unsigned int pyramidVao, pyramidVbo;
-
-    // Vertex data (vertex positions, normals, texture coordinates)
-    // Roof vertices - 54 vertices
-    GLfloat roofVerts[] = {
-         -1.0f, 0.7f, 1.0f,  -1.0f, 0.0f, 0.0f,  2.0f, 0.0f, // Left front low
-         -1.0f, 0.75f, 1.0f,  -1.0f, 0.0f, 0.0f,  2.0f, 2.0f, // Left front high
-         -1.0f, 0.7f, -1.0f,  -1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Left back low
-
-         -1.0f, 0.75f, 1.0f,  -1.0f, 0.0f, 0.0f,  2.0f, 2.0f, // Left front high
-         -1.0f, 0.7f, -1.0f,  -1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Left back low
-         -1.0f, 0.75f, -1.0f,  -1.0f, 0.0f, 0.0f,  0.f, 2.0f, // Left back high
-
-         -1.0f, 0.7f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Left front low
-         -1.0f, 0.75f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 2.0f, // Left front high
-         0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 2.0f, // Mid front high
-
-         -1.0f, 0.7f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Left front low
-         0.0f, 0.95f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 0.0f, // Mid front low
-         0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 2.0f, // Mid front high
-
-         -1.0f, 0.7f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Left back low
-         -1.0f, 0.75f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 2.0f, // Left back high
-         0.0f, 1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 2.0, // Mid back high
-
-         -1.0f, 0.7f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Left back low
-         0.0f, 0.95f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 0.0f, // Mid back low
-         0.0f, 1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 2.0f, // Mid back high
-
-         0.0f, 0.95f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 0.0f, // Mid front low
-         0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 2.0f, // Mid front high
-         1.0f, 0.7f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Right front low
-
-         0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 0.0f, // Mid front high
-         1.0f, 0.7f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Right front low
-         1.0f, 0.75f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 2.0f, // Right front high
-
-         0.0f, 0.95f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 0.0f, // Mid back low
-         0.0f, 1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 0.0f, // Mid back high
-         1.0f, 0.7f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Right back low
-
-         0.0f, 1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 2.0f, // Mid back high
-         1.0f, 0.7f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Right back low
-         1.0f, 0.75f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 4.0f, // Right back high
-
-         -1.0f, 0.75f, 1.0f,  -0.242536f, 0.97014f, 0.0f,  4.0f, 0.0f, // Left front high
-         -1.0f, 0.75f, -1.0f,  -0.242536f, 0.97014f, 0.0f,  0.0f, 0.0f, // Left back high
-         0.0f, 1.0f, -1.0f,  -0.242536f, 0.97014f, 0.0f,  0.0f, 4.0f, // Mid back high
-
-         -1.0f, 0.75f, 1.0f,  -0.242536f, 0.97014f, 0.0f,  4.0f, 0.0f, // Left front high
-         0.0f, 1.0f, 1.0f,  -0.242536f, 0.97014f, 0.0f,  4.0f, 4.0f, // Mid front high
-         0.0f, 1.0f, -1.0f,  -0.242536f, 0.97014f, 0.0f,  0.0f, 4.0f, // Mid back high
-
-         -1.0f, 0.7f, 1.0f,  0.242536f, -0.97014f, 0.0f,  0.0f, 0.0f, // Left front low
-         -1.0f, 0.7f, -1.0f,  0.242536f, -0.97014f, 0.0f,  4.0f, 0.0f, // Left back low
-         0.0f, 0.95f, -1.0f,  0.242536f, -0.97014f, 0.0f,  4.0f, 4.0f, // Mid back low
-
-         -1.0f, 0.7f, 1.0f,  0.242536f, -0.97014f, 0.0f,  0.0f, 0.0f, // Left front low
-         0.0f, 0.95f, 1.0f,  0.242536f, -0.97014f, 0.0f,  0.0f, 4.0f, // Mid front low
-         0.0f, 0.95f, -1.0f,  0.242536f, -0.97014f, 0.0f,  4.0f, 4.0f, // Mid back low
-
-         0.0f, 1.0f, 1.0f,  0.242536f, 0.97014f, 0.0f,  0.0f, 4.0f, // Mid front high
-         1.0f, 0.75f, 1.0f,  0.242536f, 0.97014f, 0.0f,  0.0f, 0.0f, // Right front high
-         1.0f, 0.75f, -1.0f,  0.242536f, 0.97014f, 0.0f,  4.0f, 0.0f, // Right back high
-
-         0.0f, 1.0f, 1.0f,  0.242536f, 0.97014f, 0.0f,  0.0f, 4.0f, // Mid front high
-         0.0f, 1.0f, -1.0f,  0.242536f, 0.97014f, 0.0f,  4.0f, 4.0f, // Mid back high
-         1.0f, 0.75f, -1.0f,  0.242536f, 0.97014f, 0.0f,  4.0f, 0.0f, // Right back high
-
-         0.0f, 0.95f, 1.0f,  -0.242536f, -0.97014f, 0.0f,  0.0f, 4.0f, // Mid front low
-         1.0f, 0.7f, 1.0f,  -0.242536f, -0.97014f, 0.0f,  0.0f, 0.0f, // Right front low
-         1.0f, 0.7f, -1.0f,  -0.242536f, -0.97014f, 0.0f,  4.0f, 0.0f, // Right back low
-
-         0.0f, 0.95f, 1.0f,  -0.242536f, -0.97014f, 0.0f,  0.0f, 4.0f, // Mid front low
-         0.0f, 0.95f, -1.0f,  -0.242536f, -0.97014f, 0.0f,  4.0f, 4.0f, // Mid back low
-         1.0f, 0.7f, -1.0f,  -0.242536f, -0.97014f, 0.0f,  4.0f, 0.0f, // Right back low
-    };
-
-    // Shed vertices - 30 vertices
-    GLfloat shedVerts[] = {
-        // Left
-         -0.9f, -1.0f, 0.9f,  -1.0f, 0.0f, 0.0f,  0.5f, 0.0f, // Front left bottom
-         -0.9f, -1.0f, -0.9f,  -1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Back left bottom
-         -0.9f, 0.75f, -0.9f,  -1.0f, 0.0f, 0.0f, 0.5f, 1.0f, // Back left top
-
-         -0.9f, -1.0f, 0.9f,  -1.0f, 0.0f, 0.0f,  0.5f, 0.0f, // Front left bottom
-         -0.9f, 0.75f, 0.9f,  -1.0f, 0.0f, 0.0f,  0.5f, 1.0f, // Front left top
-         -0.9f, 0.75f, -0.9f,  -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, // Back left top
-         // Front
-         -0.9f, -1.0f, 0.9f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Front left bottom
-         -0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.0f, 1.0f, // Front left top
-         0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.5f, 1.0f, // Front right top
-
-         -0.9f, -1.0f, 0.9f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Front left bottom
-         0.9f, -1.0f, 0.9f,  0.0f, 0.0f, 1.0f,  0.5f, 0.0f, // Front right bottom
-         0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.5f, 1.0f, // Front right top
-         // Front top
-         -0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Front left top
-         0.0f, 0.95f, 0.9f,  0.0f, 0.0f, 1.0f,  0.25f, 0.12f, // Front middle
-         0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.5f, 0.0f, // Front right top
-         // Right
-         0.9f, -1.0f, 0.9f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Front right bottom
-         0.9f, 0.75f, 0.9f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f, // Front right top
-         0.9f, 0.75f, -0.9f,  1.0f, 0.0f, 0.0f,  0.5f, 1.0f, // Back right top
-
-         0.9f, -1.0f, 0.9f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Front right bottom
-         0.9f, -1.0f, -0.9f,  1.0f, 0.0f, 0.0f,  0.5f, 0.0f, // Back right bottom
-         0.9f, 0.75f, -0.9f,  1.0f, 0.0f, 0.0f,  0.5f, 1.0f, // Back right top
-         // Back
-         0.9f, -1.0f, -0.9f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Back right bottom
-         0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.0f, 1.0f, // Back right top
-         -0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.5f, 1.0f, // Back left top
-
-         0.9f, -1.0f, -0.9f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Back right bottom
-         -0.9f, -1.0f, -0.9f,  0.0f, 0.0f, -1.0f,  0.5f, 0.0f, // Back left bottom
-         -0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.5f, 1.0f, // Back left top
-         // Back top
-         0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Back right top
-         0.0f, 0.95f, -0.9f,  0.0f, 0.0f, -1.0f,  0.25f, 0.12f, // Back middle
-         -0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.5f, 0.0f, // Back left top
-    };
-
-    //Plane vertices (grass, door, chairs) - 6 vertices
-    GLfloat planeVerts[] = {
-        -1.0f, -1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f,
-        -1.0f, 1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 5.0f,
-        1.0f, 1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  5.0f, 5.0f,
-
-        -1.0f, -1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f,
-        1.0f, 1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  5.0f, 5.0f,
-        1.0f, -1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  5.0f, 0.0f,
-    };
-
-    // Pyramid vertices (trees) - 18 vertices
-    GLfloat pyramidVerts[] = {
-        //Positions          // Normal vectors   //Texture Coordinates
-        // Base 1
-         -1.0f, -1.0f,  1.0f,  0.0f, -1.0f, 0.0f,  0.0f, 0.0f, // Front left 
-         -1.0f, -1.0f, -1.0f,  0.0f, -1.0f, 0.0f,  0.0f, 1.0f, // Back left 
-         1.0f, -1.0f, -1.0f,  0.0f, -1.0f, 0.0f,  1.0f, 1.0f, // Back right
-         // Base 2
-         -1.0f, -1.0f,  1.0f,  0.0f, -1.0f, 0.0f,  0.0f, 0.0f, // Front left  
-         1.0f, -1.0f, -1.0f,  0.0f, -1.0f, 0.0f,  1.0f, 1.0f, // Back right 
-         1.0f, -1.0f,  1.0f,  0.0f, -1.0f, 0.0f,  1.0f, 0.0f, // Front right
-         // Left
-         -1.0f, -1.0f, -1.0f,  0.89443f, -0.44721f, 0.0f,  0.0f, 0.0f, // Back left 
-         -1.0f, -1.0f,  1.0f,  0.89443f, -0.44721f, 0.0f,  5.0f, 0.0f, // Front left 
-         0.0f,  1.0f,  0.0f,  0.89443f, -0.44721f, 0.0f,  2.5f, 5.0f, // Top center 
-         // Back
-         1.0f, -1.0f, -1.0f,  0.0f, 0.44721f, -0.89443f,  0.0f, 0.0f, // Back right 
-         -1.0f, -1.0f, -1.0f,  0.0f, 0.44721f, -0.89443f,  5.0f, 0.0f, // Back left 
-         0.0f,  1.0f,  0.0f,  0.0f, 0.44721f, -0.89443f,  2.5f, 5.0f, // Top center 
-         //Right
-         1.0f, -1.0f,  1.0f,  0.89443f, 0.44721f, 0.0f,  0.0f, 0.0f, // Front right
-         1.0f, -1.0f, -1.0f,  0.89443f, 0.44721f, 0.0f,  5.0f, 0.0f, // Back right 
-         0.0f,  1.0f,  0.0f,  0.89443f, 0.44721f, 0.0f,  2.5f, 5.0f, // Top center
-         // Front
-         -1.0f, -1.0f,  1.0f,  0.0f, 0.44721f, 0.89443f,  0.0f, 0.0f, // Front left 
-         1.0f, -1.0f,  1.0f,  0.0f, 0.44721f, 0.89443f,  5.0f, 0.0f, // Front right 
-         0.0f,  1.0f,  0.0f,  0.0f, 0.44721f, 0.89443f,  2.5f, 5.0f, // Top center 
-    };
-    
-    const GLuint floatsPerVertex = 3;
-    const GLuint floatsPerNormal = 3;
-    const GLuint floatsPerUV = 2;
-    // Strides between vertex coordinates
-    GLint stride = sizeof(float) * (floatsPerVertex + floatsPerNormal + floatsPerUV);
-
-    // Set up object VAOs and VBOs   
-    // Plane
-    glGenVertexArrays(1, &planeVao); // Generate VAO
-    glBindVertexArray(planeVao);
-    glGenBuffers(1, &planeVbo); // Generate VBO
-    glBindBuffer(GL_ARRAY_BUFFER, planeVbo); // Activates the buffer
-    glBufferData(GL_ARRAY_BUFFER, sizeof(planeVerts), planeVerts, GL_STATIC_DRAW); // Sends vertex or coordinate data to the GPU
-    // Create Vertex Attribute Pointers
-    glVertexAttribPointer(0, floatsPerVertex, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, floatsPerNormal, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, floatsPerUV, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    // Cylinders
-    glGenVertexArrays(1, &cylinderVao);
-    glGenBuffers(1, &cylinderVbo);
-    glBindVertexArray(cylinderVao);
-    glBindBuffer(GL_ARRAY_BUFFER, cylinderVbo);
-
-    // Shed
-    glGenVertexArrays(1, &shedVao);
-    glBindVertexArray(shedVao);
-    glGenBuffers(1, &shedVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, shedVbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(shedVerts), shedVerts, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, floatsPerVertex, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, floatsPerNormal, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, floatsPerUV, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    // Roof
-    glGenVertexArrays(1, &roofVao);
-    glBindVertexArray(roofVao);
-    glGenBuffers(1, &roofVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, roofVbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(roofVerts), roofVerts, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, floatsPerVertex, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, floatsPerNormal, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, floatsPerUV, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    // Pyramid
-    glGenVertexArrays(1, &pyramidVao);
-    glBindVertexArray(pyramidVao);
-    glGenBuffers(1, &pyramidVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, pyramidVbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(pyramidVerts), pyramidVerts, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, floatsPerVertex, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, floatsPerNormal, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, floatsPerUV, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
     // Place and draw objects     
     // Ground
     // Camera/view transformation
@@ -726,306 +837,147 @@ void URender()
         projection = glm::perspective(glm::radians(gCamera.Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
     }
 
-    // Creates model transformation (translates, rotates, scales object)
-    glm::mat4 model = glm::mat4(1.0f); // Initialize with identity matrix before applying transformations
-    model = glm::translate(glm::vec3(0.0f, 0.0f, 2.0f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(1.0f, 0.0f, 0.0f))) * glm::scale(glm::vec3(10.0f, 12.0f, 0.0f));
-
-    // Set the shader to be used
-    glUseProgram(objectShaderId);
-
-    // Retrieves and passes transform matrices to the Shader program
-    GLint modelLoc = glGetUniformLocation(objectShaderId, "model");
-    GLint viewLoc = glGetUniformLocation(objectShaderId, "view");
-    GLint projLoc = glGetUniformLocation(objectShaderId, "projection");
-    GLint UVScaleLoc = glGetUniformLocation(objectShaderId, "uvScale");
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniform2fv(UVScaleLoc, 1, glm::value_ptr(glm::vec2(3.0f, 3.0f))); // Scale texture
-
-    // Set up shader properties
-    glUniform3f(glGetUniformLocation(objectShaderId, "light.position"), firePos.x, firePos.y, firePos.z);
-    glUniform3f(glGetUniformLocation(objectShaderId, "viewPos"), gCamera.Position.x, gCamera.Position.y, gCamera.Position.z);
-    // light properties for material
-    glUniform3f(glGetUniformLocation(objectShaderId, "light.ambient"), 1.0f, 0.6f, 0.2f);
-    glUniform3f(glGetUniformLocation(objectShaderId, "light.diffuse"), 1.0f, 0.6f, 0.2f);
-    glUniform3f(glGetUniformLocation(objectShaderId, "light.specular"), 1.0f, 0.6f, 0.3f);
-    glUniform1f(glGetUniformLocation(objectShaderId, "light.constant"), 1.0f);
-    glUniform1f(glGetUniformLocation(objectShaderId, "light.linear"), 0.09f);
-    glUniform1f(glGetUniformLocation(objectShaderId, "light.quadratic"), 0.032f);
-    glUniform1f(glGetUniformLocation(objectShaderId, "material.shininess"), 24.0f);
-
-    // Activate VBO
-    glBindVertexArray(planeVao);
-    // Bind textures
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, grassTexture);
-    // Draw the shape
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    // Modify properties and draw the rest of the objects
-    // Door
-    glUniform2fv(UVScaleLoc, 1, glm::value_ptr(glm::vec2(1.0f, 1.0f)));
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(0.0f, 1.5f, -0.29f)) * glm::scale(glm::vec3(0.75f, 1.5f, 0.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniform1f(glGetUniformLocation(objectShaderId, "material.shininess"), 28.0f);
-    glBindTexture(GL_TEXTURE_2D, doorTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    // Chairs
-    // Blue back
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(3.0f, 1.625f, 2.5f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(0.75f, 0.75f, 0.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniform1f(glGetUniformLocation(objectShaderId, "material.shininess"), 15.0f);
-    glBindTexture(GL_TEXTURE_2D, blueTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    // Blue seat
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(2.5f, 0.875f, 2.5f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(1.0f, 0.0f, 0.0f))) * glm::scale(glm::vec3(0.5f, 0.75f, 0.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    // Red Back
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-3.0f, 1.625f, 2.5f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(0.75f, 0.75f, 0.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glBindTexture(GL_TEXTURE_2D, redTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    // Red seat
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-2.5f, 0.875f, 2.5f)) * glm::rotate(glm::radians(90.0f), (glm::vec3(1.0f, 0.0f, 0.0f))) * glm::scale(glm::vec3(0.5f, 0.75f, 0.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-
-    // Chair legs
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(3.0f, 1.625f, 1.75f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glBindVertexArray(cylinderVao);
-    glBindTexture(GL_TEXTURE_2D, blueTexture);
-    static_meshes_3D::Cylinder blue(0.03, 10, 1.5, true, true, true);
-    blue.render();
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(3.0f, 1.625f, 3.25f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    blue.render();
-    glBindTexture(GL_TEXTURE_2D, redTexture);
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-3.0f, 1.625f, 1.75f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    static_meshes_3D::Cylinder red(0.03, 10, 1.5, true, true, true);
-    red.render();
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-3.0f, 1.625f, 3.25f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    red.render();
-    glBindTexture(GL_TEXTURE_2D, chairTexture);
-    glUniform1f(glGetUniformLocation(objectShaderId, "material.shininess"), 35.0f);
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(3.0f, 0.5f, 3.25f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    static_meshes_3D::Cylinder leg(0.03, 10, 0.75, true, true, true);
-    leg.render();
-    model = glm::translate(glm::vec3(3.0f, 0.5f, 1.75f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    leg.render();
-    model = glm::translate(glm::vec3(2.1f, 0.5f, 3.15f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    leg.render();
-    model = glm::translate(glm::vec3(2.1f, 0.5f, 1.85f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    leg.render();
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-3.0f, 0.5f, 3.25f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    leg.render();
-    model = glm::translate(glm::vec3(-3.0f, 0.5f, 1.75f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    leg.render();
-    model = glm::translate(glm::vec3(-2.1f, 0.5f, 3.15f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    leg.render();
-    model = glm::translate(glm::vec3(-2.1f, 0.5f, 1.85f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    leg.render();
-
-    // Fire pit
-    glBindTexture(GL_TEXTURE_2D, firepitTexture);
-    //Cylinder
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(0.0f, 0.0625f, 2.5f)) * glm::scale(glm::vec3(1.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    static_meshes_3D::Cylinder firepit(1, 10, 0.125, true, true, true);
-    firepit.render();
-    // Tube
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(0.0f, 0.125f, 2.5f)) * glm::scale(glm::vec3(1.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    static_meshes_3D::Tube T(1, 10, 0.25, true, true, true);
-    T.render();
-
-    // Doorknob
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-0.5f, 1.525f, -0.25f)) * glm::scale(glm::vec3(1.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glBindTexture(GL_TEXTURE_2D, knobTexture);
-    Sphere knob(0.1f, 10, 10);
-    knob.Draw();
-
-    //Tree trunks
-    glBindTexture(GL_TEXTURE_2D, barkTexture);
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-2.25f, 0.5f, 10.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    static_meshes_3D::Cylinder trunk(0.25, 10, 1.0, true, true, true);
-    trunk.render();
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(2.25f, 0.5f, 10.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    trunk.render();
-
-    // Shed
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(0.0f, 3.0f, -3.0f)) * glm::scale(glm::vec3(3.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniform1f(glGetUniformLocation(objectShaderId, "material.shininess"), 20.0f);
-    glBindVertexArray(shedVao);
-    glBindTexture(GL_TEXTURE_2D, shedTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 30);
-
-    // Tree leaves
-    glUniform1f(glGetUniformLocation(objectShaderId, "material.shininess"), 27.0f);
-    glBindVertexArray(pyramidVao);
-    glBindTexture(GL_TEXTURE_2D, pineTexture);
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-2.25f, 4.0f, 10.0f)) * glm::rotate(glm::radians(45.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(1.0f, 3.0f, 1.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 18);
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(2.25f, 4.0f, 10.0f)) * glm::rotate(glm::radians(45.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(1.0f, 3.0f, 1.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 18);
-    glUniform3f(glGetUniformLocation(objectShaderId, "light.position"), moonPos.x, moonPos.y, moonPos.z);
-    glUniform3f(glGetUniformLocation(objectShaderId, "light.ambient"), 1.0f, 1.0f, 1.0f);
-    glUniform3f(glGetUniformLocation(objectShaderId, "light.diffuse"), 1.0f, 1.0f, 1.0f);
-    glUniform3f(glGetUniformLocation(objectShaderId, "light.specular"), 1.0f, 1.0f, 1.0f);
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(-2.25f, 4.0f, 10.0f)) * glm::scale(glm::vec3(1.0f, 3.0f, 1.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 18);
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(2.25f, 4.0f, 10.0f)) * glm::scale(glm::vec3(1.0f, 3.0f, 1.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 18);
-
-    // Roof
-    model = glm::mat4(1.0f);
-    model = glm::translate(glm::vec3(0.0f, 3.0f, -3.0f)) * glm::scale(glm::vec3(3.0f));
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-    glUniform1f(glGetUniformLocation(objectShaderId, "material.shininess"), 18.0f);
-    glBindVertexArray(roofVao);
-    glBindTexture(GL_TEXTURE_2D, roofTexture);
-    //glActiveTexture(GL_TEXTURE0);
-    //glBindTexture(GL_TEXTURE_2D, roofSpecular);
-    glDrawArrays(GL_TRIANGLES, 0, 54);
-
-    // Switch to light shader
-    glUseProgram(lightShaderId);
-
-    // Set up and render first light
-    glUniform3f(glGetUniformLocation(lightShaderId, "light.color"), 1.0f, 1.0f, 1.0f);
-    model = glm::mat4(1.0f);
-    model = glm::translate(moonPos) * glm::scale(glm::vec3(1.0f));
-
-    // Modifies, retrieves and passes transform matrices to the Shader program
-    GLint modelLoc2 = glGetUniformLocation(lightShaderId, "model");
-    GLint viewLoc2 = glGetUniformLocation(lightShaderId, "view");
-    GLint projLoc2 = glGetUniformLocation(lightShaderId, "projection");
-    glUniformMatrix4fv(modelLoc2, 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(viewLoc2, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc2, 1, GL_FALSE, glm::value_ptr(projection));
-    // Draw the light
-    glBindVertexArray(cylinderVao);
-    Sphere moon(0.5, 10, 10);
-    moon.Draw();
-
-    // Set up and render second light
-    glUniform3f(glGetUniformLocation(lightShaderId, "light.color"), 1.0f, 0.5f, 0.0f);
-    model = glm::mat4(1.0f);
-    model = glm::translate(firePos) * glm::scale(glm::vec3(0.5f));
-    glUniformMatrix4fv(modelLoc2, 1, GL_FALSE, glm::value_ptr(model));
-    glBindVertexArray(pyramidVao);
-    glDrawArrays(GL_TRIANGLES, 0, 18);
-    model = glm::mat4(1.0f);
-    model = glm::translate(firePos) * glm::rotate(glm::radians(45.0f), (glm::vec3(0.0f, 1.0f, 0.0f))) * glm::scale(glm::vec3(0.5f));
-    glUniformMatrix4fv(modelLoc2, 1, GL_FALSE, glm::value_ptr(model));
-    glDrawArrays(GL_TRIANGLES, 0, 18);
-
-    // Deactivate the Vertex Array Object
-    glBindVertexArray(0);
+    // Camera data is written once per frame and shared by both shader programs
+    CameraBlock camera;
+    camera.view = view;
+    camera.projection = projection;
+    camera.viewPos = glm::vec4(gCamera.Position, 1.0f);
+    if (const auto cameraRegion = gCameraBuffer.beginFrameRegion())
+    {
+        memcpy(cameraRegion, &camera, sizeof(CameraBlock));
+        gCameraBuffer.bindFrameRegion(CAMERA_BLOCK_BINDING);
+    }
 
-    // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-    glfwSwapBuffers(gWindow);    // Flips the the back buffer with the front buffer every frame.
-}
+    // Upload lights, if they have changed
+    gPointLights.uploadToGPU(POINT_LIGHTS_BINDING);
 
-// Generate and load the texture
-bool UCreateTexture(const char* filename, GLuint& textureId)
-{
-    int width, height, channels;
-    unsigned char* image = stbi_load(filename, &width, &height, &channels, 0);
-    if (image)
+    // Materials (shininess, texture scale, light color, texture layer), registered once
+    const auto layerMaterial = [](float shininess, GLuint textureLayer, glm::vec2 uvScale = glm::vec2(1.0f, 1.0f))
     {
-        flipImageVertically(image, width, height, channels);
-
-        glGenTextures(1, &textureId);
-        glBindTexture(GL_TEXTURE_2D, textureId);
-
-        // set the texture wrapping parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        // set texture filtering parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        if (channels == 3)
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-        else if (channels == 4)
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-        else
+        RenderMaterial material;
+        material.shininess = shininess;
+        material.uvScale = uvScale;
+        material.textureLayer = textureLayer;
+        return gRenderQueue.addMaterial(material);
+    };
+    static const int grassMaterial = layerMaterial(GRASS_SHININESS, grassLayer, GRASS_UV_SCALE);
+    static const int doorMaterial = layerMaterial(DOOR_SHININESS, doorLayer);
+    static const int blueChairMaterial = layerMaterial(CHAIR_SHININESS, blueLayer);
+    static const int redChairMaterial = layerMaterial(CHAIR_SHININESS, redLayer);
+    static const int chairLegMaterial = layerMaterial(WOOD_SHININESS, chairLayer);
+    static const int barkMaterial = layerMaterial(WOOD_SHININESS, barkLayer);
+    static const int firepitMaterial = layerMaterial(WOOD_SHININESS, firepitLayer);
+    static const int knobMaterial = layerMaterial(WOOD_SHININESS, knobLayer);
+    static const int shedMaterial = layerMaterial(SHED_SHININESS, shedLayer);
+    static const int pineMaterial = layerMaterial(PINE_SHININESS, pineLayer);
+    static const int roofMaterial = layerMaterial(ROOF_SHININESS, roofLayer);
+    static const int moonMaterial = gRenderQueue.addMaterial({ 32.0f, glm::vec2(1.0f, 1.0f), glm::vec3(1.0f, 1.0f, 1.0f) });
+    static const int fireMaterial = gRenderQueue.addMaterial({ 32.0f, glm::vec2(1.0f, 1.0f), glm::vec3(1.0f, 0.5f, 0.0f) });
+
+    // Submit draws in any order, the queue sorts them to minimize state changes
+    gRenderQueue.setViewPosition(gCamera.Position, 100.0f);
+
+    // Pyramid is shared by tree leaves and fire
+    const SceneResources::MeshHandle& pyramid = gSceneResources.getPyramid();
+    const auto drawPyramid = [&pyramid]() { glDrawArrays(GL_TRIANGLES, 0, pyramid.numVertices); };
+
+    // Opaque objects, all at once from the geometry arena, or one by one through the queue
+    // Levels of detail of parametric meshes follow their size on screen
+    const glm::vec3& viewPosition = gCamera.Position;
+    const float viewportHeight = (float)WINDOW_HEIGHT;
+    const GLuint materialTextures = gMaterialTextures.getTextureID();
+    if (gUseMultiDraw)
+    {
+        gSceneDrawList.updateLevels(viewPosition, projection, viewportHeight);
+        glUseProgram(arenaShader.getProgramID());
+        gMaterialTextures.bind(GL_TEXTURE0);
+        gSceneDrawList.render(OBJECTS_BINDING);
+    }
+    else
+    {
+        // Ground, door and chair planes
+        const SceneResources::MeshHandle& plane = gSceneResources.getPlane();
+        const auto drawPlane = [&plane]() { glDrawArrays(GL_TRIANGLES, 0, plane.numVertices); };
+        gRenderQueue.submit(objectShader, plane.vao, materialTextures, grassMaterial, &groundTransform, drawPlane);
+        gRenderQueue.submit(objectShader, plane.vao, materialTextures, doorMaterial, &doorTransform, drawPlane);
+        gRenderQueue.submit(objectShader, plane.vao, materialTextures, blueChairMaterial, &blueBackTransform, drawPlane);
+        gRenderQueue.submit(objectShader, plane.vao, materialTextures, blueChairMaterial, &blueSeatTransform, drawPlane);
+        gRenderQueue.submit(objectShader, plane.vao, materialTextures, redChairMaterial, &redBackTransform, drawPlane);
+        gRenderQueue.submit(objectShader, plane.vao, materialTextures, redChairMaterial, &redSeatTransform, drawPlane);
+
+        // Chair posts, legs and tree trunks, one instanced draw per group of identical props (its level follows the largest prop)
+        const auto submitInstanced = [materialTextures, &viewPosition, &projection, viewportHeight](const SceneResources::InstancedLod& props, int& level, int material)
         {
-            cout << "Not implemented to handle image with " << channels << " channels" << endl;
-            return false;
+            level = props.lod.selectLevel(props.getModelMatrices(), viewPosition, projection, viewportHeight, level);
+            const static_meshes_3D::InstancedMesh& instances = props.getLevel(level);
+            gRenderQueue.submit(objectShader, instances.getVAO(), materialTextures, material, nullptr,
+                [&instances]() { instances.getMesh().renderInstanced(instances.getNumInstances()); });
+        };
+        submitInstanced(gSceneResources.getBlueChairPosts(), gLodLevels.blueChairPosts, blueChairMaterial);
+        submitInstanced(gSceneResources.getRedChairPosts(), gLodLevels.redChairPosts, redChairMaterial);
+        submitInstanced(gSceneResources.getChairLegs(), gLodLevels.chairLegs, chairLegMaterial);
+        submitInstanced(gSceneResources.getTrunks(), gLodLevels.trunks, barkMaterial);
+
+        // Fire pit cylinder and tube
+        const auto& firepitLod = gSceneResources.getFirepit();
+        gLodLevels.firepit = firepitLod.selectLevel(firepitTransform.getModel(), viewPosition, projection, viewportHeight, gLodLevels.firepit);
+        const static_meshes_3D::CylinderIndexed& firepit = firepitLod.getLevel(gLodLevels.firepit);
+        gRenderQueue.submit(objectShader, firepit.getVAO(), materialTextures, firepitMaterial, &firepitTransform, [&firepit]() { firepit.renderInstanced(1); },
+            firepit.getVertexFormat().getPositionDequantization());
+        const auto& firepitRimLod = gSceneResources.getFirepitRim();
+        gLodLevels.firepitRim = firepitRimLod.selectLevel(firepitRimTransform.getModel(), viewPosition, projection, viewportHeight, gLodLevels.firepitRim);
+        const static_meshes_3D::TubeIndexed& firepitRim = firepitRimLod.getLevel(gLodLevels.firepitRim);
+        gRenderQueue.submit(objectShader, firepitRim.getVAO(), materialTextures, firepitMaterial, &firepitRimTransform, [&firepitRim]() { firepitRim.renderInstanced(1); },
+            firepitRim.getVertexFormat().getPositionDequantization());
+
+        // Doorknob
+        const auto& knobLod = gSceneResources.getKnob();
+        gLodLevels.knob = knobLod.selectLevel(knobTransform.getModel(), viewPosition, projection, viewportHeight, gLodLevels.knob);
+        const Sphere& knob = knobLod.getLevel(gLodLevels.knob);
+        gRenderQueue.submit(objectShader, knob.GetVAO(), materialTextures, knobMaterial, &knobTransform, [&knob]() { knob.DrawElements(); },
+            knob.GetPositionDequantization());
+
+        // Shed and roof
+        const SceneResources::MeshHandle& shed = gSceneResources.getShed();
+        gRenderQueue.submit(objectShader, shed.vao, materialTextures, shedMaterial, &shedTransform, [&shed]() { glDrawArrays(GL_TRIANGLES, 0, shed.numVertices); });
+        const SceneResources::MeshHandle& roof = gSceneResources.getRoof();
+        gRenderQueue.submit(objectShader, roof.vao, materialTextures, roofMaterial, &roofTransform, [&roof]() { glDrawArrays(GL_TRIANGLES, 0, roof.numVertices); });
+
+        // Tree leaves
+        for (const auto& leavesTransform : leavesTransforms) {
+            gRenderQueue.submit(objectShader, pyramid.vao, materialTextures, pineMaterial, &leavesTransform, drawPyramid);
         }
+    }
 
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        stbi_image_free(image);
-        glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-        return true;
+    // Moon and fire are drawn with the light shader
+    const auto& moonLod = gSceneResources.getMoon();
+    gLodLevels.moon = moonLod.selectLevel(moonTransform.getModel(), viewPosition, projection, viewportHeight, gLodLevels.moon);
+    const Sphere& moon = moonLod.getLevel(gLodLevels.moon);
+    gRenderQueue.submit(lightShader, moon.GetVAO(), 0, moonMaterial, &moonTransform, [&moon]() { moon.DrawElements(); },
+        moon.GetPositionDequantization());
+    for (const auto& fireTransform : fireTransforms) {
+        gRenderQueue.submit(lightShader, pyramid.vao, 0, fireMaterial, &fireTransform, drawPyramid);
     }
 
-    // Error loading the image
-    return false;
-}
+    gRenderQueue.execute();
 
-void UDestroyTexture(GLuint textureId)
-{
-    glGenTextures(1, &textureId);
-}
+    // All draws reading the camera region have been issued
+    gCameraBuffer.endFrameRegion();
 
+    // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+    glfwSwapBuffers(gWindow);    // Flips the the back buffer with the front buffer every frame.
+}
 
 // Implements the UCreateShaders function
 
-bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, GLuint& programId)
+bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSource, ShaderProgram& program)
 {
     // Compilation and linkage error reporting
     int success = 0;
     char infoLog[512];
 
     // Create a Shader program object.
-    programId = glCreateProgram();
+    GLuint programId = glCreateProgram();
 
     // Create the vertex and fragment shader objects
     GLuint vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
@@ -1073,6 +1025,9 @@ bool UCreateShaderProgram(const char* vtxShaderSource, const char* fragShaderSou
         return false;
     }
 
+    // Look up all active uniforms once, the render loop then uses the cached locations
+    program.reflectProgram(programId);
+
     glUseProgram(programId);    // Uses the shader program
 
     return true;
@@ -1083,3 +1038,571 @@ void UDestroyShaderProgram(GLuint programId)
 {
     glDeleteProgram(programId);
 }
+
+// Reports buffers, vertex arrays and textures alive in the whole context (shared meshes, instances, arena, textures...),
+// counted by their owners as they are created and deleted, so a leak keeps rising however many names it takes
+void UReportLiveGLObjects()
+{
+    cout << "Live OpenGL objects: " << GpuObjectCounter::getNumBuffers() << " buffers, "
+        << GpuObjectCounter::getNumVertexArrays() << " vertex arrays, " << GpuObjectCounter::getNumTextures() << " textures" << endl;
+}
+
+// Creates camera uniform buffer and scene lights and binds them to their binding points
+void UCreateUniformBuffers()
+{
+    gCameraBuffer.createStreamingVBO(sizeof(CameraBlock), 3, GL_UNIFORM_BUFFER);
+
+    // Fire and moon, more lights can be added without adding draw calls
+    gPointLights.addLight(firePos, glm::vec3(1.0f, 0.6f, 0.2f), glm::vec3(1.0f, 0.6f, 0.2f), glm::vec3(1.0f, 0.6f, 0.3f), 1.0f, 0.09f, 0.032f);
+    gPointLights.addLight(moonPos, glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(1.0f, 1.0f, 1.0f), 1.0f, 0.09f, 0.032f);
+    gPointLights.uploadToGPU(POINT_LIGHTS_BINDING);
+}
+
+// Adds all opaque objects to the multi-draw list, grouped per mesh, and uploads it
+bool UBuildSceneDrawList()
+{
+    using ArenaMesh = SceneResources::ArenaMesh;
+    const auto mesh = [](ArenaMesh arenaMesh) { return gSceneResources.getArenaMesh(arenaMesh); };
+    const auto lod = [](ArenaMesh arenaMesh) { return gSceneResources.getArenaLod(arenaMesh); };
+
+    gSceneDrawList.addDraw(mesh(ArenaMesh::Plane), grassLayer, groundTransform, GRASS_SHININESS, GRASS_UV_SCALE);
+    gSceneDrawList.addDraw(mesh(ArenaMesh::Plane), doorLayer, doorTransform, DOOR_SHININESS);
+    gSceneDrawList.addDraw(mesh(ArenaMesh::Plane), blueLayer, blueBackTransform, CHAIR_SHININESS);
+    gSceneDrawList.addDraw(mesh(ArenaMesh::Plane), blueLayer, blueSeatTransform, CHAIR_SHININESS);
+    gSceneDrawList.addDraw(mesh(ArenaMesh::Plane), redLayer, redBackTransform, CHAIR_SHININESS);
+    gSceneDrawList.addDraw(mesh(ArenaMesh::Plane), redLayer, redSeatTransform, CHAIR_SHININESS);
+
+    // Parametric meshes switch levels of detail per object, every prop of a group has its own command
+    gSceneDrawList.addLodInstancedDraw(lod(ArenaMesh::ChairPost), blueLayer, gSceneResources.getBlueChairPosts().getModelMatrices(), CHAIR_SHININESS);
+    gSceneDrawList.addLodInstancedDraw(lod(ArenaMesh::ChairPost), redLayer, gSceneResources.getRedChairPosts().getModelMatrices(), CHAIR_SHININESS);
+    gSceneDrawList.addLodInstancedDraw(lod(ArenaMesh::ChairLeg), chairLayer, gSceneResources.getChairLegs().getModelMatrices(), WOOD_SHININESS);
+    gSceneDrawList.addLodInstancedDraw(lod(ArenaMesh::Trunk), barkLayer, gSceneResources.getTrunks().getModelMatrices(), WOOD_SHININESS);
+
+    gSceneDrawList.addLodDraw(lod(ArenaMesh::Firepit), firepitLayer, firepitTransform, WOOD_SHININESS);
+    gSceneDrawList.addLodDraw(lod(ArenaMesh::FirepitRim), firepitLayer, firepitRimTransform, WOOD_SHININESS);
+    gSceneDrawList.addLodDraw(lod(ArenaMesh::Knob), knobLayer, knobTransform, WOOD_SHININESS);
+    gSceneDrawList.addDraw(mesh(ArenaMesh::Shed), shedLayer, shedTransform, SHED_SHININESS);
+    gSceneDrawList.addDraw(mesh(ArenaMesh::Roof), roofLayer, roofTransform, ROOF_SHININESS);
+    for (const auto& leavesTransform : leavesTransforms) {
+        gSceneDrawList.addDraw(mesh(ArenaMesh::Pyramid), pineLayer, leavesTransform, PINE_SHININESS);
+    }
+
+    return gSceneDrawList.build(gSceneResources.getArena());
+}
+
+void UDestroyUniformBuffers()
+{
+    gCameraBuffer.deleteVBO();
+    gPointLights.deleteLights();
+}
+
+// Bakes scene geometry arena and compressed material textures into the asset pack
+bool UBakeAssetPack(const vector<string>& materialTextureFilenames)
+{
+    vector<AssetPack::EntryData> entries;
+    gSceneResources.bake(entries);
+
+    // Layers are compressed on the loader's threads, reusing (and filling) the texture cache
+    vector<vector<unsigned char>> layerData;
+    if (!gTextureLoader.encodeLayers(gMaterialTextures, materialTextureFilenames, layerData))
+        cerr << "Some textures are missing from the asset pack, they will be loaded from their image files" << endl;
+    for (size_t i = 0; i < materialTextureFilenames.size(); i++)
+    {
+        if (layerData[i].empty())
+            continue;
+        AssetPack::EntryData entry;
+        entry.name = TextureCache::getCacheFilename(materialTextureFilenames[i], gMaterialTextures.getFormat());
+        entry.data = move(layerData[i]);
+        entries.push_back(move(entry));
+    }
+
+    return AssetPack::write(ASSET_PACK_FILENAME, entries);
+}
+
+// Measures decoding throughput of given images (material textures by default), reporting the best of a few runs,
+// both on one thread and split across a thread pool; PNGs are also decoded with the fast inflate and unfiltering off, to compare
+bool UBenchmarkDecode(vector<string> filenames)
+{
+    if (filenames.empty())
+        for (const auto& textureFile : materialTextureFiles)
+            filenames.push_back(textureFile.filename);
+
+    ThreadPool threadPool;
+    const auto parallelFor = [](void* pool, void (*job)(void* jobData, int index), void* jobData, int count)
+    {
+        static_cast<ThreadPool*>(pool)->parallelFor(size_t(count), [job, jobData](size_t index) { job(jobData, int(index)); });
+    };
+
+    const int RUNS = 5;
+    const unsigned char PNG_SIGNATURE[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    int numDecoded = 0, numPngDecoded = 0;
+    double totalBytes = 0.0, totalPixels = 0.0, totalSeconds = 0.0, totalParallelSeconds = 0.0;
+    double totalPngSeconds = 0.0, totalPngReferenceSeconds = 0.0;
+    for (const auto& filename : filenames)
+    {
+        // Images are read to memory first, so that only decoding is measured
+        ifstream file(filename, ios::binary);
+        const vector<unsigned char> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        int width, height, channels;
+        if (data.empty() || !stbi_info_from_memory(data.data(), int(data.size()), &width, &height, &channels))
+        {
+            cerr << "Failed to read image " << filename << ", skipping it" << endl;
+            continue;
+        }
+
+        // Every run decodes into the same memory, like into the staging buffers, so page faults of fresh allocations aren't measured
+        vector<unsigned char> pixels(size_t(width) * height * 4);
+        const bool isPng = data.size() >= sizeof(PNG_SIGNATURE) && equal(begin(PNG_SIGNATURE), end(PNG_SIGNATURE), data.begin());
+        double bestSeconds = 0.0, bestParallelSeconds = 0.0, bestReferenceSeconds = 0.0;
+        bool isDecoded = true;
+        for (int run = 0; run < RUNS && isDecoded; run++)
+        {
+            auto start = chrono::steady_clock::now();
+            isDecoded = stbi_load_into_from_memory(data.data(), int(data.size()), pixels.data(), width, height, width * 4, 4, 0) != 0;
+            const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            bestSeconds = run == 0 ? seconds : min(bestSeconds, seconds);
+
+            start = chrono::steady_clock::now();
+            isDecoded = isDecoded && stbi_load_into_from_memory_parallel(data.data(), int(data.size()), pixels.data(), width, height, width * 4, 4, 0, parallelFor, &threadPool) != 0;
+            const double parallelSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            bestParallelSeconds = run == 0 ? parallelSeconds : min(bestParallelSeconds, parallelSeconds);
+
+            if (isPng)
+            {
+                stbi_set_png_fast_paths(0);
+                start = chrono::steady_clock::now();
+                isDecoded = isDecoded && stbi_load_into_from_memory(data.data(), int(data.size()), pixels.data(), width, height, width * 4, 4, 0) != 0;
+                const double referenceSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                bestReferenceSeconds = run == 0 ? referenceSeconds : min(bestReferenceSeconds, referenceSeconds);
+                stbi_set_png_fast_paths(1);
+            }
+        }
+        if (!isDecoded)
+        {
+            cerr << "Failed to decode image " << filename << ": " << stbi_failure_reason() << ", skipping it" << endl;
+            continue;
+        }
+
+        const double megapixels = double(width) * height / 1e6;
+        const double megabytes = double(data.size()) / 1e6;
+        cout << filename << " (" << width << "x" << height << ", " << megabytes << " MB): " << bestSeconds * 1000.0 << " ms, "
+            << megabytes / bestSeconds << " MB/s, " << megapixels / bestSeconds << " MPix/s, " << bestParallelSeconds * 1000.0 << " ms on "
+            << threadPool.getNumThreads() << " threads (" << bestSeconds / bestParallelSeconds << "x)";
+        if (isPng)
+        {
+            cout << ", " << bestReferenceSeconds * 1000.0 << " ms with byte-wise inflate and scalar filters (" << bestReferenceSeconds / bestSeconds << "x)";
+            totalPngSeconds += bestSeconds;
+            totalPngReferenceSeconds += bestReferenceSeconds;
+            numPngDecoded++;
+        }
+        cout << endl;
+        totalBytes += megabytes;
+        totalPixels += megapixels;
+        totalSeconds += bestSeconds;
+        totalParallelSeconds += bestParallelSeconds;
+        numDecoded++;
+    }
+
+    if (numDecoded == 0)
+        return false;
+    cout << "Decoded " << numDecoded << " images in " << totalSeconds * 1000.0 << " ms: " << totalBytes / totalSeconds << " MB/s, "
+        << totalPixels / totalSeconds << " MPix/s, " << totalParallelSeconds * 1000.0 << " ms on " << threadPool.getNumThreads() << " threads ("
+        << totalSeconds / totalParallelSeconds << "x)" << endl;
+    if (numPngDecoded > 0)
+        cout << "Decoded " << numPngDecoded << " PNG images in " << totalPngSeconds * 1000.0 << " ms, " << totalPngReferenceSeconds * 1000.0
+            << " ms with byte-wise inflate and scalar filters (" << totalPngReferenceSeconds / totalPngSeconds << "x)" << endl;
+    return true;
+}
+
+// Parses the optional count following a benchmark option (argv[2]), which must be a whole number from 1 to maxValue,
+// prints usage and returns false on bad input
+bool UParseCountArgument(int argc, char* argv[], unsigned long long defaultValue, unsigned long long maxValue, unsigned long long& value)
+{
+    value = defaultValue;
+    if (argc <= 2)
+        return true;
+
+    const char* argument = argv[2];
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = strtoull(argument, &end, 10);
+    // strtoull accepts a sign and negates "-1" to a huge number, only plain digits are taken
+    if (argument[0] < '0' || argument[0] > '9' || *end != '\0' || errno == ERANGE || parsed == 0 || parsed > maxValue)
+    {
+        cerr << "Invalid count '" << argument << "'!" << endl
+            << "Usage: " << argv[0] << " " << argv[1] << " [count], count is a whole number from 1 to " << maxValue << " (default " << defaultValue << ")" << endl;
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+// Measures building vertex data of a mesh (positions, texture coordinates and normals, one block after another, like the
+// cylinders have) in the in-memory buffer of a VBO, with each way of adding data, reporting the best of a few runs
+bool UBenchmarkVertexBuilder(size_t numVertices)
+{
+    const int RUNS = 5;
+    vector<glm::vec3> positions(numVertices), normals(numVertices);
+    vector<glm::vec2> texCoords(numVertices);
+    for (size_t i = 0; i < numVertices; i++)
+    {
+        const float angle = float(i) * 0.001f;
+        positions[i] = glm::vec3(cos(angle), float(i % 1000) * 0.001f, sin(angle));
+        texCoords[i] = glm::vec2(float(i % 1000) * 0.001f, angle);
+        normals[i] = glm::vec3(cos(angle), 0.0f, sin(angle));
+    }
+    const size_t meshBytes = numVertices * (sizeof(glm::vec3) * 2 + sizeof(glm::vec2));
+
+    // Every case fills a fresh VBO without GL buffer (nothing is uploaded), checking that all the data made it in
+    bool isCorrect = true;
+    const auto measure = [&](const char* name, size_t bytes, const function<void(VertexBufferObject&)>& build)
+    {
+        double bestSeconds = 0.0;
+        for (int run = 0; run < RUNS; run++)
+        {
+            VertexBufferObject vbo;
+            const auto start = chrono::steady_clock::now();
+            build(vbo);
+            const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            bestSeconds = run == 0 ? seconds : min(bestSeconds, seconds);
+            isCorrect = isCorrect && vbo.getBufferSize() == bytes;
+        }
+        cout << name << ": " << bestSeconds * 1000.0 << " ms, " << double(bytes) / 1e9 / bestSeconds << " GB/s" << endl;
+    };
+
+    cout << "Building mesh of " << numVertices << " vertices (" << meshBytes << " bytes)" << endl;
+    measure("addData per vertex", meshBytes, [&](VertexBufferObject& vbo)
+    {
+        for (const auto& position : positions)
+            vbo.addData(position);
+        for (const auto& texCoord : texCoords)
+            vbo.addData(texCoord);
+        for (const auto& normal : normals)
+            vbo.addData(normal);
+    });
+    measure("addDataArray per attribute", meshBytes, [&](VertexBufferObject& vbo)
+    {
+        vbo.addDataArray(positions.data(), positions.size());
+        vbo.addDataArray(texCoords.data(), texCoords.size());
+        vbo.addDataArray(normals.data(), normals.size());
+    });
+    measure("addDataRange per attribute", meshBytes, [&](VertexBufferObject& vbo)
+    {
+        vbo.addDataRange(positions.begin(), positions.end());
+        vbo.addDataRange(texCoords.begin(), texCoords.end());
+        vbo.addDataRange(normals.begin(), normals.end());
+    });
+    measure("addDataArray per attribute, reserved", meshBytes, [&](VertexBufferObject& vbo)
+    {
+        vbo.reserveRawData(meshBytes);
+        vbo.addDataArray(positions.data(), positions.size());
+        vbo.addDataArray(texCoords.data(), texCoords.size());
+        vbo.addDataArray(normals.data(), normals.size());
+    });
+    measure("Same normal with addData per vertex", sizeof(glm::vec3) * numVertices, [&](VertexBufferObject& vbo)
+    {
+        for (size_t i = 0; i < numVertices; i++)
+            vbo.addData(glm::vec3(0.0f, 1.0f, 0.0f));
+    });
+    measure("Same normal with repeated addData", sizeof(glm::vec3) * numVertices, [&](VertexBufferObject& vbo)
+    {
+        vbo.addData(glm::vec3(0.0f, 1.0f, 0.0f), numVertices);
+    });
+
+    // Adopted vectors are copied before the clock starts, only taking them over is measured
+    vector<vector<glm::vec3>> adoptedPositions(RUNS, positions);
+    int adoptRun = 0;
+    measure("adoptData of positions", sizeof(glm::vec3) * numVertices, [&](VertexBufferObject& vbo)
+    {
+        vbo.adoptData(move(adoptedPositions[adoptRun++]));
+    });
+
+    if (!isCorrect)
+        cerr << "Some of the built buffers have wrong size!" << endl;
+    return isCorrect;
+}
+
+// Compares vertex throughput of planar, interleaved and compact interleaved vertex formats on high-slice meshes,
+// then non-indexed cylinder and tube with their indexed versions and sphere indices in stack order with vertex cache order,
+// with rasterization discarded
+bool UBenchmarkVertexLayouts(int numSlices)
+{
+    using namespace static_meshes_3D;
+    const int RUNS = 5;
+    const double VERTICES_PER_RUN = 50e6; // Meshes are instanced, until one draw processes about this many vertices
+
+    ShaderProgram fetchShader;
+    if (numSlices < 4 || !UCreateShaderProgram(fetchVertexShader, fetchFragmentShader, fetchShader))
+        return false;
+    glEnable(GL_RASTERIZER_DISCARD);
+    GLuint timerQuery;
+    glGenQueries(1, &timerQuery);
+
+    // Best GPU time of several runs in milliseconds, the first draw is not timed (driver does lazy work on it)
+    const auto measure = [&](const function<void()>& draw)
+    {
+        draw();
+        double bestMilliseconds = 0.0;
+        for (int run = 0; run < RUNS; run++)
+        {
+            glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+            draw();
+            glEndQuery(GL_TIME_ELAPSED);
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &nanoseconds);
+            bestMilliseconds = run == 0 ? double(nanoseconds) / 1e6 : min(bestMilliseconds, double(nanoseconds) / 1e6);
+        }
+        return bestMilliseconds;
+    };
+
+    struct Format
+    {
+        const char* name;
+        VertexLayout layout;
+        VertexEncoding encoding;
+    };
+    const Format formats[] = {
+        { "planar", VertexLayout::Planar, VertexEncoding() },
+        { "interleaved", VertexLayout::Interleaved, VertexEncoding() },
+        { "interleaved compact", VertexLayout::Interleaved, VertexEncoding::compact() },
+    };
+    const int NUM_FORMATS = int(sizeof(formats) / sizeof(formats[0]));
+    const auto report = [&](const char* mesh, size_t numVertices, GLsizei numInstances, const GLsizei vertexSizes[], const double milliseconds[])
+    {
+        const double vertices = double(numVertices) * numInstances;
+        cout << mesh << ", " << numVertices << " vertices x " << numInstances << " instances:" << endl;
+        for (int i = 0; i < NUM_FORMATS; i++)
+        {
+            cout << "  " << formats[i].name << " (" << vertexSizes[i] << " bytes per vertex): " << milliseconds[i] << " ms, "
+                << vertices / milliseconds[i] / 1e6 << " G vertices/s (" << milliseconds[0] / milliseconds[i] << "x)" << endl;
+        }
+    };
+    GLsizei vertexSizes[NUM_FORMATS];
+    double milliseconds[NUM_FORMATS];
+
+    // Cylinders are drawn as strips and fans right from their VBO
+    size_t numCylinderVertices = 0;
+    GLsizei numCylinderInstances = 0;
+    for (int i = 0; i < NUM_FORMATS; i++)
+    {
+        const Cylinder cylinder(1.0f, numSlices, 2.0f, true, true, true, formats[i].layout, formats[i].encoding);
+        numCylinderVertices = 0;
+        for (const auto& range : cylinder.getDrawRanges())
+            numCylinderVertices += range.count;
+        numCylinderInstances = GLsizei(max(1.0, VERTICES_PER_RUN / double(numCylinderVertices)));
+        vertexSizes[i] = cylinder.getVertexByteSize();
+        milliseconds[i] = measure([&]()
+        {
+            glBindVertexArray(cylinder.getVAO());
+            cylinder.renderInstanced(numCylinderInstances);
+        });
+    }
+    report("Cylinder", numCylinderVertices, numCylinderInstances, vertexSizes, milliseconds);
+
+    // Sphere of about the same vertex count, its positions and texture coordinates are repacked to every format
+    const int numSectors = int(sqrt(8.0 * numSlices));
+    const Sphere sphere(1.0f, numSectors, numSectors / 2);
+    const vector<float>& sphereVertices = sphere.GetVertices();
+    const size_t numSphereVertices = sphereVertices.size() / 5;
+    vector<glm::vec3> positions(numSphereVertices);
+    vector<glm::vec2> texCoords(numSphereVertices);
+    for (size_t i = 0; i < numSphereVertices; i++)
+    {
+        const float* vertex = &sphereVertices[i * 5];
+        positions[i] = glm::vec3(vertex[0], vertex[1], vertex[2]);
+        texCoords[i] = glm::vec2(vertex[3], vertex[4]);
+    }
+
+    const vector<GLuint>& sphereIndices = sphere.GetIndices();
+    const GLsizei numSphereIndices = GLsizei(sphereIndices.size());
+    const GLsizei numSphereInstances = GLsizei(max(1.0, VERTICES_PER_RUN / double(numSphereVertices)));
+    GLuint vaos[NUM_FORMATS], vbos[NUM_FORMATS], ebo;
+    GpuObjectCounter::genVertexArrays(NUM_FORMATS, vaos);
+    GpuObjectCounter::genBuffers(NUM_FORMATS, vbos);
+    GpuObjectCounter::genBuffers(1, &ebo);
+    for (int i = 0; i < NUM_FORMATS; i++)
+    {
+        VertexFormat format(true, true, false, formats[i].layout, formats[i].encoding);
+        const vector<unsigned char> data = format.packVertices(numSphereVertices, positions.data(), texCoords.data(), nullptr);
+        glBindVertexArray(vaos[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, vbos[i]);
+        glBufferData(GL_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
+        format.setupAttributePointers(numSphereVertices);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        if (i == 0)
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * sphereIndices.size(), sphereIndices.data(), GL_STATIC_DRAW);
+
+        vertexSizes[i] = format.getVertexByteSize();
+        milliseconds[i] = measure([&]()
+        {
+            glBindVertexArray(vaos[i]);
+            glDrawElementsInstanced(GL_TRIANGLES, numSphereIndices, GL_UNSIGNED_INT, nullptr, numSphereInstances);
+        });
+    }
+    report("Sphere", numSphereVertices, numSphereInstances, vertexSizes, milliseconds);
+
+    // Indexed meshes store shared vertices once and render all their strips with one draw call
+    const auto compareIndexed = [&](const char* mesh, const StaticMesh3D& arraysMesh, const StaticMeshIndexed3D& indexedMesh)
+    {
+        const vector<StaticMesh3D::DrawRange> drawRanges = arraysMesh.getDrawRanges();
+        size_t numVertices = 0;
+        for (const auto& range : drawRanges)
+            numVertices += range.count;
+        const GLsizei numInstances = GLsizei(max(1.0, VERTICES_PER_RUN / double(numVertices)));
+        const double arraysMilliseconds = measure([&]()
+        {
+            glBindVertexArray(arraysMesh.getVAO());
+            arraysMesh.renderInstanced(numInstances);
+        });
+        const double indexedMilliseconds = measure([&]()
+        {
+            glBindVertexArray(indexedMesh.getVAO());
+            indexedMesh.renderInstanced(numInstances);
+        });
+        cout << mesh << " x " << numInstances << " instances:" << endl
+            << "  arrays: " << numVertices << " vertices, " << drawRanges.size() << " draw calls, " << arraysMilliseconds << " ms" << endl
+            << "  indexed: " << indexedMesh.getNumVertices() << " vertices (" << indexedMesh.getNumIndices() << " indices), 1 draw call, "
+            << indexedMilliseconds << " ms (" << arraysMilliseconds / indexedMilliseconds << "x)" << endl;
+    };
+    compareIndexed("Cylinder", Cylinder(1.0f, numSlices, 2.0f), CylinderIndexed(1.0f, numSlices, 2.0f));
+    compareIndexed("Tube", Tube(1.0f, numSlices, 2.0f), TubeIndexed(1.0f, numSlices, 2.0f));
+
+    // Optimizer passes on indexed meshes, vertex cache only and with overdraw reordering
+    const auto compareOptimized = [&](const char* mesh, const function<unique_ptr<StaticMeshIndexed3D>()>& createMesh)
+    {
+        cout << mesh << " optimized:" << endl;
+        for (const bool reduceOverdraw : { false, true })
+        {
+            const unique_ptr<StaticMeshIndexed3D> indexedMesh = createMesh();
+            MeshOptimizer::VertexCacheStatistics before, after;
+            const bool isApplied = indexedMesh->optimize(reduceOverdraw, &before, &after);
+            const GLsizei numInstances = GLsizei(max(1.0, VERTICES_PER_RUN / double(indexedMesh->getNumIndices())));
+            const double optimizedMilliseconds = measure([&]()
+            {
+                glBindVertexArray(indexedMesh->getVAO());
+                indexedMesh->renderInstanced(numInstances);
+            });
+            cout << "  " << (reduceOverdraw ? "vertex cache and overdraw" : "vertex cache") << ": ACMR " << before.acmr << " -> " << after.acmr
+                << ", ATVR " << before.atvr << " -> " << after.atvr << ", " << (isApplied ? "triangle list" : "strips kept") << ", "
+                << numInstances << " instances in " << optimizedMilliseconds << " ms" << endl;
+        }
+    };
+    compareOptimized("Cylinder", [&]() { return unique_ptr<StaticMeshIndexed3D>(new CylinderIndexed(1.0f, numSlices, 2.0f)); });
+    compareOptimized("Tube", [&]() { return unique_ptr<StaticMeshIndexed3D>(new TubeIndexed(1.0f, numSlices, 2.0f)); });
+
+    // Same sphere with triangles in stack order, the optimized one has them reordered for the post-transform cache
+    const Sphere stackOrderSphere(1.0f, numSectors, numSectors / 2, false);
+    const auto compareSphereOrder = [&](const char* name, const Sphere& drawnSphere, double baselineMilliseconds)
+    {
+        const vector<GLuint>& indices = drawnSphere.GetIndices();
+        const double orderMilliseconds = measure([&]()
+        {
+            glBindVertexArray(drawnSphere.GetVAO());
+            glDrawElementsInstanced(GL_TRIANGLES, GLsizei(indices.size()), GL_UNSIGNED_INT, nullptr, numSphereInstances);
+        });
+        const auto statistics = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), numSphereVertices);
+        cout << "  " << name << ": ACMR " << statistics.acmr << ", ATVR " << statistics.atvr << ", " << orderMilliseconds << " ms ("
+            << (baselineMilliseconds > 0.0 ? baselineMilliseconds / orderMilliseconds : 1.0) << "x)" << endl;
+        return orderMilliseconds;
+    };
+    cout << "Sphere triangle order, " << numSphereVertices << " vertices x " << numSphereInstances << " instances:" << endl;
+    const double stackOrderMilliseconds = compareSphereOrder("stack order", stackOrderSphere, 0.0);
+    compareSphereOrder("vertex cache order", sphere, stackOrderMilliseconds);
+
+    glBindVertexArray(0);
+    GpuObjectCounter::deleteVertexArrays(NUM_FORMATS, vaos);
+    GpuObjectCounter::deleteBuffers(NUM_FORMATS, vbos);
+    GpuObjectCounter::deleteBuffers(1, &ebo);
+    glDeleteQueries(1, &timerQuery);
+    glDisable(GL_RASTERIZER_DISCARD);
+    UDestroyShaderProgram(fetchShader.getProgramID());
+    return true;
+}
+
+// Draws field of 512-slice cylinders with normal matrices inverted per vertex and read from instance attributes
+bool UBenchmarkNormalMatrices(int numCylinders)
+{
+    using namespace static_meshes_3D;
+    const int RUNS = 5;
+    const int NUM_SLICES = 512;
+
+    ShaderProgram inverseShader, attributeShader;
+    if (numCylinders < 1 || !UCreateShaderProgram(normalInverseVertexShader, fetchFragmentShader, inverseShader)
+        || !UCreateShaderProgram(normalAttributeVertexShader, fetchFragmentShader, attributeShader))
+        return false;
+
+    // Square field of rotated and non-uniformly scaled cylinders, whose normal matrices differ from their model matrices
+    const int fieldSize = int(ceil(sqrt(double(numCylinders))));
+    vector<glm::mat4> modelMatrices;
+    for (int i = 0; i < numCylinders; i++)
+    {
+        const glm::vec3 position(float(i % fieldSize) * 3.0f - fieldSize * 1.5f, 0.0f, -float(i / fieldSize) * 3.0f);
+        modelMatrices.push_back(glm::translate(position) * glm::rotate(glm::radians(float(i % 360)), glm::vec3(0.0f, 1.0f, 0.0f))
+            * glm::scale(glm::vec3(1.0f, 1.0f + float(i % 7) * 0.25f, 0.5f)));
+    }
+
+    // CPU side of the attribute path: normal matrices of all cylinders, computed once when instances are set
+    vector<glm::mat3> normalMatrices(modelMatrices.size());
+    double batchMilliseconds = 0.0, scalarMilliseconds = 0.0;
+    for (int run = 0; run < RUNS; run++)
+    {
+        const auto batchStart = chrono::steady_clock::now();
+        ObjectTransform::computeNormalMatrices(modelMatrices.data(), normalMatrices.data(), modelMatrices.size());
+        const auto scalarStart = chrono::steady_clock::now();
+        for (size_t i = 0; i < modelMatrices.size(); i++)
+            normalMatrices[i] = ObjectTransform::computeNormalMatrix(modelMatrices[i]);
+        const auto scalarEnd = chrono::steady_clock::now();
+        const double batch = chrono::duration<double, milli>(scalarStart - batchStart).count();
+        const double scalar = chrono::duration<double, milli>(scalarEnd - scalarStart).count();
+        batchMilliseconds = run == 0 ? batch : min(batchMilliseconds, batch);
+        scalarMilliseconds = run == 0 ? scalar : min(scalarMilliseconds, scalar);
+    }
+
+    InstancedMesh cylinders(make_shared<Cylinder>(1.0f, NUM_SLICES, 2.0f));
+    cylinders.setInstances(modelMatrices);
+    size_t numVertices = 0;
+    for (const auto& range : cylinders.getMesh().getDrawRanges())
+        numVertices += range.count;
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    GLuint timerQuery;
+    glGenQueries(1, &timerQuery);
+    const glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 1000.0f)
+        * glm::lookAt(glm::vec3(0.0f, 20.0f, 20.0f), glm::vec3(0.0f, 0.0f, -fieldSize * 1.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Best GPU time of several runs in milliseconds, the first draw is not timed (driver does lazy work on it)
+    const auto measure = [&](const ShaderProgram& shader)
+    {
+        glUseProgram(shader.getProgramID());
+        glUniformMatrix4fv(shader.getUniformLocation("viewProjection"), 1, GL_FALSE, glm::value_ptr(viewProjection));
+        cylinders.render();
+        double bestMilliseconds = 0.0;
+        for (int run = 0; run < RUNS; run++)
+        {
+            glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+            cylinders.render();
+            glEndQuery(GL_TIME_ELAPSED);
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &nanoseconds);
+            bestMilliseconds = run == 0 ? double(nanoseconds) / 1e6 : min(bestMilliseconds, double(nanoseconds) / 1e6);
+        }
+        return bestMilliseconds;
+    };
+    const double inverseMilliseconds = measure(inverseShader);
+    const double attributeMilliseconds = measure(attributeShader);
+
+    const double vertices = double(numVertices) * numCylinders;
+    cout << "Normal matrices, " << numCylinders << " cylinders of " << NUM_SLICES << " slices (" << numVertices << " vertices each):" << endl
+        << "  inverse per vertex: " << inverseMilliseconds << " ms, " << vertices / inverseMilliseconds / 1e6 << " G vertices/s" << endl
+        << "  instance attribute: " << attributeMilliseconds << " ms, " << vertices / attributeMilliseconds / 1e6 << " G vertices/s ("
+        << inverseMilliseconds / attributeMilliseconds << "x)" << endl
+        << "  computed on CPU once: " << batchMilliseconds << " ms in batch, " << scalarMilliseconds << " ms one by one" << endl;
+
+    glBindVertexArray(0);
+    glDeleteQueries(1, &timerQuery);
+    glDisable(GL_RASTERIZER_DISCARD);
+    UDestroyShaderProgram(inverseShader.getProgramID());
+    UDestroyShaderProgram(attributeShader.getProgramID());
+    return true;
+}
@@ -7,13 +7,18 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+#include "common/meshOptimizer.h"
+#include "common/vertexFormat.h"
+#include "common/gpuObjectCounter.h"
+
 class Sphere
 {
 private:
 	std::vector<float> sphere_vertices;
 	std::vector<float> sphere_texcoord;
-	std::vector<int> sphere_indices;
+	std::vector<GLuint> sphere_indices;
 	GLuint VBO, VAO, EBO;
+	static_meshes_3D::VertexFormat vertexFormat; // Encoding of the vertex buffer, interleaved position and tex coord
 	float radius = 1.0f;
 	int sectorCount = 36;
 	int stackCount = 18;
@@ -22,11 +27,16 @@ public:
 
 	~Sphere()
 	{
-		glDeleteVertexArrays(1, &VAO);
-		glDeleteBuffers(1, &VBO);
-		glDeleteBuffers(1, &EBO);
+		GpuObjectCounter::deleteVertexArrays(1, &VAO);
+		GpuObjectCounter::deleteBuffers(1, &VBO);
+		GpuObjectCounter::deleteBuffers(1, &EBO);
 	}
-	Sphere(float r, int sectors, int stacks)
+	// Indices are reordered for the vertex cache and vertices for fetch, unless optimizeMesh is false
+	// Quantized encodings must be drawn with model matrix multiplied by GetPositionDequantization()
+	// Vertex cache statistics before and after optimization are stored to before and after, if given
+	Sphere(float r, int sectors, int stacks, bool optimizeMesh = true, const static_meshes_3D::VertexEncoding& encoding = static_meshes_3D::VertexEncoding(),
+		MeshOptimizer::VertexCacheStatistics* before = nullptr, MeshOptimizer::VertexCacheStatistics* after = nullptr)
+		: vertexFormat(true, true, false, static_meshes_3D::VertexLayout::Interleaved, encoding)
 	{
 		radius = r;
 		sectorCount = sectors;
@@ -103,39 +113,91 @@ public:
 		/* GENERATE INDEX ARRAY */
 
 
+		/* OPTIMIZE INDEX AND VERTEX ORDER */
+		// Stack by stack order reuses vertices of the previous stack only while a whole stack fits in the vertex cache
+		if (optimizeMesh)
+		{
+			const size_t numVertices = sphere_vertices.size() / 5;
+			if (before != nullptr) {
+				*before = MeshOptimizer::analyzeVertexCache(sphere_indices.data(), sphere_indices.size(), numVertices);
+			}
+			MeshOptimizer::optimizeVertexCache(sphere_indices.data(), sphere_indices.size(), numVertices);
+			if (after != nullptr) {
+				*after = MeshOptimizer::analyzeVertexCache(sphere_indices.data(), sphere_indices.size(), numVertices);
+			}
+			MeshOptimizer::remapVertices(sphere_vertices, MeshOptimizer::optimizeVertexFetch(sphere_indices.data(), sphere_indices.size(), numVertices), 5);
+		}
+		/* OPTIMIZE INDEX AND VERTEX ORDER */
+
+
 		/* GENERATE VAO-EBO */
 		//GLuint VBO, VAO, EBO;
-		glGenVertexArrays(1, &VAO);
-		glGenBuffers(1, &VBO);
-		glGenBuffers(1, &EBO);
+		GpuObjectCounter::genVertexArrays(1, &VAO);
+		GpuObjectCounter::genBuffers(1, &VBO);
+		GpuObjectCounter::genBuffers(1, &EBO);
 		// Bind the Vertex Array Object first, then bind and set vertex buffer(s) and attribute pointer(s).
 		glBindVertexArray(VAO);
 
+		// Vertices are packed in the encoding of the sphere (float encoding gives the same 5 floats per vertex)
+		const size_t numVertices = sphere_vertices.size() / 5;
+		std::vector<glm::vec3> positions(numVertices);
+		std::vector<glm::vec2> texCoords(numVertices);
+		for (size_t i = 0; i < numVertices; i++)
+		{
+			positions[i] = glm::vec3(sphere_vertices[i * 5], sphere_vertices[i * 5 + 1], sphere_vertices[i * 5 + 2]);
+			texCoords[i] = glm::vec2(sphere_vertices[i * 5 + 3], sphere_vertices[i * 5 + 4]);
+		}
+		const auto packedVertices = vertexFormat.packVertices(numVertices, positions.data(), texCoords.data(), nullptr);
+
 		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferData(GL_ARRAY_BUFFER, (unsigned int)sphere_vertices.size() * sizeof(float), sphere_vertices.data(), GL_DYNAMIC_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, (unsigned int)packedVertices.size(), packedVertices.data(), GL_DYNAMIC_DRAW);
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (unsigned int)sphere_indices.size() * sizeof(unsigned int), sphere_indices.data(), GL_DYNAMIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (unsigned int)sphere_indices.size() * sizeof(GLuint), sphere_indices.data(), GL_DYNAMIC_DRAW);
 
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid*)0);
-		glEnableVertexAttribArray(0);
-
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
-		glEnableVertexAttribArray(1);
+		vertexFormat.setupAttributePointers(numVertices);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glBindVertexArray(0);
 		/* GENERATE VAO-EBO */
 
 
 	}
-	void Draw()
+	void Draw() const
 	{
 		glBindVertexArray(VAO);
+		DrawElements();
+		glBindVertexArray(0);
+	}
+	// Draws the sphere with its VAO already bound
+	void DrawElements() const
+	{
 		glDrawElements(GL_TRIANGLES,
 			(unsigned int)sphere_indices.size(),
 			GL_UNSIGNED_INT,
 			(void*)0);
-		glBindVertexArray(0);
+	}
+	GLuint GetVAO() const
+	{
+		return VAO;
+	}
+	// Transform of fetched positions back to sphere space (identity for float positions)
+	glm::mat4 GetPositionDequantization() const
+	{
+		return vertexFormat.getPositionDequantization();
+	}
+	// Byte size of one vertex in the vertex buffer
+	GLsizei GetVertexByteSize() const
+	{
+		return vertexFormat.getVertexByteSize();
+	}
+	// Interleaved vertex data, position (x, y, z) and tex coord (s, t) per vertex
+	const std::vector<float>& GetVertices() const
+	{
+		return sphere_vertices;
+	}
+	const std::vector<GLuint>& GetIndices() const
+	{
+		return sphere_indices;
 	}
 };
 
@@ -0,0 +1,243 @@
+// STL
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Platform file mapping
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Project
+#include "common/assetPack.h"
+
+namespace {
+
+const char PACK_MAGIC[4] = { 'A', 'P', 'A', 'K' };
+const uint32_t PACK_VERSION = 2; //! Raised whenever baked content changes (2: reordered meshes with levels of detail)
+const uint64_t DATA_ALIGNMENT = 4096; //! Entry data start at page boundaries
+const size_t MAX_NAME_LENGTH = 56; //! Including terminating zero
+
+// Header at the beginning of the pack, followed by the table of entries
+struct PackHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t numEntries;
+	uint32_t reserved;
+};
+
+// Record of the table of entries
+struct PackEntry
+{
+	char name[MAX_NAME_LENGTH];
+	uint64_t offset; //! From the beginning of the pack
+	uint64_t size;
+};
+
+uint64_t alignUp(uint64_t offset)
+{
+	return (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+}
+
+const PackEntry* getEntries(const unsigned char* mapped)
+{
+	return reinterpret_cast<const PackEntry*>(mapped + sizeof(PackHeader));
+}
+
+} // namespace
+
+AssetPack::~AssetPack()
+{
+	close();
+}
+
+bool AssetPack::open(const std::string& filename)
+{
+	if (isOpen())
+	{
+		std::cerr << "This asset pack is already open! You need to close it before opening another one!" << std::endl;
+		return false;
+	}
+
+#ifdef _WIN32
+	const auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	const auto mapping = GetFileSizeEx(file, &fileSize) ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+	CloseHandle(file); // The mapping keeps the file open
+	if (mapping == nullptr) {
+		return false;
+	}
+
+	const auto mapped = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (mapped == nullptr)
+	{
+		CloseHandle(mapping);
+		return false;
+	}
+	_fileHandle = mapping;
+	_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const auto file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+
+	struct stat fileStatus;
+	auto mapped = fstat(file, &fileStatus) == 0 && fileStatus.st_size > 0
+		? mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+	::close(file); // The mapping keeps the file open
+	if (mapped == MAP_FAILED) {
+		return false;
+	}
+
+	// All of the pack is uploaded during startup, so reading ahead saves page faults
+	madvise(mapped, static_cast<size_t>(fileStatus.st_size), MADV_WILLNEED);
+	_mappedSize = static_cast<size_t>(fileStatus.st_size);
+#endif
+	_mapped = static_cast<const unsigned char*>(mapped);
+
+	// Corrupted or truncated pack is rejected as a whole, rather than handing out pointers past its end
+	const auto header = reinterpret_cast<const PackHeader*>(_mapped);
+	auto isValid = _mappedSize >= sizeof(PackHeader) && std::memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) == 0
+		&& header->version == PACK_VERSION && sizeof(PackHeader) + sizeof(PackEntry) * static_cast<uint64_t>(header->numEntries) <= _mappedSize;
+	for (uint32_t i = 0; isValid && i < header->numEntries; i++)
+	{
+		const auto& entry = getEntries(_mapped)[i];
+		isValid = entry.name[MAX_NAME_LENGTH - 1] == '\0' && entry.offset <= _mappedSize && entry.size <= _mappedSize - entry.offset;
+	}
+
+	if (!isValid)
+	{
+		std::cerr << "Asset pack " << filename << " is corrupted or of another version, bake it again!" << std::endl;
+		close();
+		return false;
+	}
+
+	std::cout << "Mapped asset pack " << filename << " with " << header->numEntries << " entries (" << _mappedSize << " bytes)" << std::endl;
+	return true;
+}
+
+AssetPack::Entry AssetPack::getEntry(const std::string& name) const
+{
+	Entry result;
+	if (!isOpen()) {
+		return result;
+	}
+
+	// Packs have a few dozens of entries, linear search beats building an index
+	const auto numEntries = reinterpret_cast<const PackHeader*>(_mapped)->numEntries;
+	for (uint32_t i = 0; i < numEntries; i++)
+	{
+		const auto& entry = getEntries(_mapped)[i];
+		if (name == entry.name)
+		{
+			result.data = _mapped + entry.offset;
+			result.size = static_cast<size_t>(entry.size);
+			break;
+		}
+	}
+	return result;
+}
+
+bool AssetPack::isOpen() const
+{
+	return _mapped != nullptr;
+}
+
+void AssetPack::close()
+{
+	if (!isOpen()) {
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(_mapped);
+	CloseHandle(_fileHandle);
+#else
+	munmap(const_cast<unsigned char*>(_mapped), _mappedSize);
+#endif
+	_mapped = nullptr;
+	_mappedSize = 0;
+	_fileHandle = nullptr;
+}
+
+bool AssetPack::write(const std::string& filename, const std::vector<EntryData>& entries)
+{
+	PackHeader header = {};
+	std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+	header.version = PACK_VERSION;
+	header.numEntries = static_cast<uint32_t>(entries.size());
+
+	std::vector<PackEntry> table(entries.size());
+	auto offset = alignUp(sizeof(PackHeader) + sizeof(PackEntry) * table.size());
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (entries[i].name.size() >= MAX_NAME_LENGTH)
+		{
+			std::cerr << "Asset pack entry name " << entries[i].name << " is too long!" << std::endl;
+			return false;
+		}
+
+		std::memset(&table[i], 0, sizeof(PackEntry));
+		std::memcpy(table[i].name, entries[i].name.c_str(), entries[i].name.size());
+		table[i].offset = offset;
+		table[i].size = entries[i].data.size();
+		offset = alignUp(offset + table[i].size);
+	}
+
+	// Written under a temporary name and renamed, so that a running application never maps half of the pack
+	const auto temporaryFilename = filename + ".tmp";
+	{
+		std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(table.data()), sizeof(PackEntry) * table.size());
+		for (size_t i = 0; i < entries.size() && file; i++)
+		{
+			// Zero padding up to the entry's page
+			const std::vector<char> padding(static_cast<size_t>(table[i].offset - static_cast<uint64_t>(file.tellp())), 0);
+			file.write(padding.data(), padding.size());
+			file.write(reinterpret_cast<const char*>(entries[i].data.data()), entries[i].data.size());
+		}
+
+		// The file ends at a page boundary too, so even an empty last entry lies within it
+		if (file)
+		{
+			const std::vector<char> padding(static_cast<size_t>(offset - static_cast<uint64_t>(file.tellp())), 0);
+			file.write(padding.data(), padding.size());
+		}
+
+		if (!file)
+		{
+			std::cerr << "Failed to write asset pack " << temporaryFilename << "!" << std::endl;
+			file.close();
+			std::remove(temporaryFilename.c_str());
+			return false;
+		}
+	}
+
+	// Windows can't rename over an existing file
+	std::remove(filename.c_str());
+	if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0)
+	{
+		std::cerr << "Failed to replace asset pack " << filename << "!" << std::endl;
+		std::remove(temporaryFilename.c_str());
+		return false;
+	}
+
+	std::cout << "Baked asset pack " << filename << " with " << entries.size() << " entries (" << offset << " bytes)" << std::endl;
+	return true;
+}
@@ -0,0 +1,434 @@
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Project
+#include "common/blockCompressor.h"
+
+namespace {
+
+const int NUM_CHANNELS = 4;
+const int BLOCK_PIXELS = 16;
+
+// Interpolation weights of BC7 4-bit indices, out of 64
+const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// 4x4 pixels of one block, channels as floats for fitting the endpoints
+struct Block
+{
+	float pixels[BLOCK_PIXELS][NUM_CHANNELS];
+};
+
+// Copies block at block coordinates, clamping pixels outside the image to its edge
+void loadBlock(const unsigned char* pixels, int width, int height, int blockX, int blockY, Block& block)
+{
+	for (auto y = 0; y < 4; y++)
+	{
+		const auto row = std::min(blockY * 4 + y, height - 1);
+		for (auto x = 0; x < 4; x++)
+		{
+			const auto column = std::min(blockX * 4 + x, width - 1);
+			const auto pixel = pixels + (static_cast<size_t>(row) * width + column) * NUM_CHANNELS;
+			for (auto c = 0; c < NUM_CHANNELS; c++) {
+				block.pixels[y * 4 + x][c] = pixel[c];
+			}
+		}
+	}
+}
+
+// Fits a line through block's colors (using the first numChannels channels) and returns its ends,
+// i.e. the colors projected furthest along the principal axis in both directions
+void fitEndpoints(const Block& block, int numChannels, float start[NUM_CHANNELS], float end[NUM_CHANNELS])
+{
+	float mean[NUM_CHANNELS] = {};
+	for (const auto& pixel : block.pixels)
+	{
+		for (auto c = 0; c < numChannels; c++) {
+			mean[c] += pixel[c] / BLOCK_PIXELS;
+		}
+	}
+
+	float covariance[NUM_CHANNELS][NUM_CHANNELS] = {};
+	for (const auto& pixel : block.pixels)
+	{
+		for (auto i = 0; i < numChannels; i++)
+		{
+			for (auto j = 0; j < numChannels; j++) {
+				covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+			}
+		}
+	}
+
+	// Power iteration converges to the eigenvector of the largest eigenvalue within a few steps
+	float axis[NUM_CHANNELS] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	for (auto iteration = 0; iteration < 8; iteration++)
+	{
+		float next[NUM_CHANNELS] = {};
+		auto length = 0.0f;
+		for (auto i = 0; i < numChannels; i++)
+		{
+			for (auto j = 0; j < numChannels; j++) {
+				next[i] += covariance[i][j] * axis[j];
+			}
+			length = std::max(length, std::abs(next[i]));
+		}
+
+		// Uniform block has no axis, both ends are the mean then
+		if (length == 0.0f) {
+			break;
+		}
+		for (auto i = 0; i < numChannels; i++) {
+			axis[i] = next[i] / length;
+		}
+	}
+
+	auto axisLengthSquared = 0.0f;
+	for (auto c = 0; c < numChannels; c++) {
+		axisLengthSquared += axis[c] * axis[c];
+	}
+
+	auto minProjection = 0.0f;
+	auto maxProjection = 0.0f;
+	for (const auto& pixel : block.pixels)
+	{
+		auto projection = 0.0f;
+		for (auto c = 0; c < numChannels; c++) {
+			projection += (pixel[c] - mean[c]) * axis[c];
+		}
+		minProjection = std::min(minProjection, projection);
+		maxProjection = std::max(maxProjection, projection);
+	}
+
+	for (auto c = 0; c < numChannels; c++)
+	{
+		start[c] = mean[c] + axis[c] * minProjection / axisLengthSquared;
+		end[c] = mean[c] + axis[c] * maxProjection / axisLengthSquared;
+	}
+}
+
+// Refits endpoints by least squares, given the interpolation weight (0 = start, 1 = end) chosen for every pixel
+bool refineEndpoints(const Block& block, int numChannels, const float weights[BLOCK_PIXELS], float start[NUM_CHANNELS], float end[NUM_CHANNELS])
+{
+	// Normal equations of minimizing sum |(1 - w) * start + w * end - pixel|^2
+	auto aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[NUM_CHANNELS] = {};
+	float bx[NUM_CHANNELS] = {};
+	for (auto i = 0; i < BLOCK_PIXELS; i++)
+	{
+		const auto b = weights[i];
+		const auto a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (auto c = 0; c < numChannels; c++)
+		{
+			ax[c] += a * block.pixels[i][c];
+			bx[c] += b * block.pixels[i][c];
+		}
+	}
+
+	const auto determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f) {
+		return false;
+	}
+
+	for (auto c = 0; c < numChannels; c++)
+	{
+		start[c] = std::min(std::max((ax[c] * bb - bx[c] * ab) / determinant, 0.0f), 255.0f);
+		end[c] = std::min(std::max((bx[c] * aa - ax[c] * ab) / determinant, 0.0f), 255.0f);
+	}
+	return true;
+}
+
+int squaredDistance(const int a[NUM_CHANNELS], const float b[NUM_CHANNELS], int numChannels)
+{
+	auto distance = 0;
+	for (auto c = 0; c < numChannels; c++)
+	{
+		const auto difference = a[c] - static_cast<int>(b[c]);
+		distance += difference * difference;
+	}
+	return distance;
+}
+
+// Assigns every pixel the nearest palette color, returns total squared error
+int chooseIndices(const Block& block, int numChannels, const int palette[][NUM_CHANNELS], int paletteSize, int indices[BLOCK_PIXELS])
+{
+	auto totalError = 0;
+	for (auto i = 0; i < BLOCK_PIXELS; i++)
+	{
+		auto bestError = squaredDistance(palette[0], block.pixels[i], numChannels);
+		indices[i] = 0;
+		for (auto p = 1; p < paletteSize; p++)
+		{
+			const auto error = squaredDistance(palette[p], block.pixels[i], numChannels);
+			if (error < bestError)
+			{
+				bestError = error;
+				indices[i] = p;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+int quantize(float value, int maxValue)
+{
+	return std::min(std::max(static_cast<int>(value * maxValue / 255.0f + 0.5f), 0), maxValue);
+}
+
+uint16_t packRGB565(const float color[NUM_CHANNELS])
+{
+	return static_cast<uint16_t>((quantize(color[0], 31) << 11) | (quantize(color[1], 63) << 5) | quantize(color[2], 31));
+}
+
+void unpackRGB565(uint16_t packed, int color[NUM_CHANNELS])
+{
+	const auto r = (packed >> 11) & 31;
+	const auto g = (packed >> 5) & 63;
+	const auto b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+	color[3] = 255;
+}
+
+// BC1 block with endpoints quantized to 565, returns its squared error
+int encodeBC1Block(const Block& block, const float start[NUM_CHANNELS], const float end[NUM_CHANNELS], uint16_t& color0, uint16_t& color1, int indices[BLOCK_PIXELS])
+{
+	// Four color mode needs color0 > color1, the third and fourth color lie at 1/3 and 2/3 from color0
+	color0 = packRGB565(end);
+	color1 = packRGB565(start);
+	if (color0 < color1) {
+		std::swap(color0, color1);
+	}
+
+	int palette[4][NUM_CHANNELS];
+	unpackRGB565(color0, palette[0]);
+	unpackRGB565(color1, palette[1]);
+	for (auto c = 0; c < NUM_CHANNELS; c++)
+	{
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+
+	// Equal endpoints would switch the block to three color mode, where index 3 means black
+	const auto paletteSize = color0 == color1 ? 1 : 4;
+	return chooseIndices(block, 3, palette, paletteSize, indices);
+}
+
+void compressBC1Block(const Block& block, unsigned char* output)
+{
+	float start[NUM_CHANNELS], end[NUM_CHANNELS];
+	fitEndpoints(block, 3, start, end);
+
+	uint16_t color0, color1;
+	int indices[BLOCK_PIXELS];
+	auto error = encodeBC1Block(block, start, end, color0, color1, indices);
+
+	// Palette index to position between color1 (0) and color0 (1), to refit the endpoints to the chosen colors
+	const float indexWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+	float weights[BLOCK_PIXELS];
+	for (auto i = 0; i < BLOCK_PIXELS; i++) {
+		weights[i] = indexWeights[indices[i]];
+	}
+	if (error > 0 && refineEndpoints(block, 3, weights, start, end))
+	{
+		uint16_t refinedColor0, refinedColor1;
+		int refinedIndices[BLOCK_PIXELS];
+		const auto refinedError = encodeBC1Block(block, start, end, refinedColor0, refinedColor1, refinedIndices);
+		if (refinedError < error)
+		{
+			color0 = refinedColor0;
+			color1 = refinedColor1;
+			std::copy(refinedIndices, refinedIndices + BLOCK_PIXELS, indices);
+		}
+	}
+
+	uint32_t packedIndices = 0;
+	for (auto i = 0; i < BLOCK_PIXELS; i++) {
+		packedIndices |= static_cast<uint32_t>(indices[i]) << (2 * i);
+	}
+
+	output[0] = static_cast<unsigned char>(color0 & 0xFF);
+	output[1] = static_cast<unsigned char>(color0 >> 8);
+	output[2] = static_cast<unsigned char>(color1 & 0xFF);
+	output[3] = static_cast<unsigned char>(color1 >> 8);
+	for (auto i = 0; i < 4; i++) {
+		output[4 + i] = static_cast<unsigned char>(packedIndices >> (8 * i));
+	}
+}
+
+// BC7 mode 6 endpoint: 7 bits per channel plus one shared lowest bit
+struct BC7Endpoint
+{
+	int channels[NUM_CHANNELS];
+	int pBit;
+};
+
+BC7Endpoint quantizeBC7Endpoint(const float color[NUM_CHANNELS])
+{
+	BC7Endpoint best = {};
+	auto bestError = -1.0f;
+	for (auto pBit = 0; pBit < 2; pBit++)
+	{
+		BC7Endpoint endpoint = {};
+		endpoint.pBit = pBit;
+		auto error = 0.0f;
+		for (auto c = 0; c < NUM_CHANNELS; c++)
+		{
+			endpoint.channels[c] = std::min(std::max(static_cast<int>((color[c] - pBit) / 2.0f + 0.5f), 0), 127);
+			const auto difference = (endpoint.channels[c] * 2 + pBit) - color[c];
+			error += difference * difference;
+		}
+		if (bestError < 0.0f || error < bestError)
+		{
+			best = endpoint;
+			bestError = error;
+		}
+	}
+	return best;
+}
+
+int encodeBC7Block(const Block& block, const float start[NUM_CHANNELS], const float end[NUM_CHANNELS], BC7Endpoint& endpoint0, BC7Endpoint& endpoint1, int indices[BLOCK_PIXELS])
+{
+	endpoint0 = quantizeBC7Endpoint(start);
+	endpoint1 = quantizeBC7Endpoint(end);
+
+	int palette[16][NUM_CHANNELS];
+	for (auto p = 0; p < 16; p++)
+	{
+		for (auto c = 0; c < NUM_CHANNELS; c++)
+		{
+			const auto value0 = endpoint0.channels[c] * 2 + endpoint0.pBit;
+			const auto value1 = endpoint1.channels[c] * 2 + endpoint1.pBit;
+			palette[p][c] = ((64 - BC7_WEIGHTS[p]) * value0 + BC7_WEIGHTS[p] * value1 + 32) >> 6;
+		}
+	}
+	return chooseIndices(block, NUM_CHANNELS, palette, 16, indices);
+}
+
+// Writes bits into 128-bit block, starting from the lowest bit of the first byte
+class BitWriter
+{
+public:
+	explicit BitWriter(unsigned char* output)
+		: _output(output)
+	{
+		std::fill(_output, _output + BlockCompressor::BC7_BLOCK_SIZE, static_cast<unsigned char>(0));
+	}
+
+	void write(int value, int numBits)
+	{
+		for (auto i = 0; i < numBits; i++, _position++) {
+			_output[_position / 8] |= static_cast<unsigned char>(((value >> i) & 1) << (_position % 8));
+		}
+	}
+
+private:
+	unsigned char* _output;
+	int _position = 0;
+};
+
+void compressBC7Block(const Block& block, unsigned char* output)
+{
+	float start[NUM_CHANNELS], end[NUM_CHANNELS];
+	fitEndpoints(block, NUM_CHANNELS, start, end);
+
+	BC7Endpoint endpoint0, endpoint1;
+	int indices[BLOCK_PIXELS];
+	auto error = encodeBC7Block(block, start, end, endpoint0, endpoint1, indices);
+
+	float weights[BLOCK_PIXELS];
+	for (auto i = 0; i < BLOCK_PIXELS; i++) {
+		weights[i] = BC7_WEIGHTS[indices[i]] / 64.0f;
+	}
+	if (error > 0 && refineEndpoints(block, NUM_CHANNELS, weights, start, end))
+	{
+		BC7Endpoint refinedEndpoint0, refinedEndpoint1;
+		int refinedIndices[BLOCK_PIXELS];
+		const auto refinedError = encodeBC7Block(block, start, end, refinedEndpoint0, refinedEndpoint1, refinedIndices);
+		if (refinedError < error)
+		{
+			endpoint0 = refinedEndpoint0;
+			endpoint1 = refinedEndpoint1;
+			std::copy(refinedIndices, refinedIndices + BLOCK_PIXELS, indices);
+		}
+	}
+
+	// Index of the first pixel is stored without its highest bit, so it has to be below 8
+	if (indices[0] >= 8)
+	{
+		std::swap(endpoint0, endpoint1);
+		for (auto& index : indices) {
+			index = 15 - index;
+		}
+	}
+
+	BitWriter writer(output);
+	writer.write(1 << 6, 7); // Mode 6
+	for (auto c = 0; c < NUM_CHANNELS; c++)
+	{
+		writer.write(endpoint0.channels[c], 7);
+		writer.write(endpoint1.channels[c], 7);
+	}
+	writer.write(endpoint0.pBit, 1);
+	writer.write(endpoint1.pBit, 1);
+	writer.write(indices[0], 3);
+	for (auto i = 1; i < BLOCK_PIXELS; i++) {
+		writer.write(indices[i], 4);
+	}
+}
+
+template <typename CompressBlock>
+void compressBlocks(const unsigned char* pixels, int width, int height, unsigned char* blocks, size_t blockSize, CompressBlock compressBlock)
+{
+	const auto numBlocksX = (width + 3) / 4;
+	const auto numBlocksY = (height + 3) / 4;
+	Block block;
+	for (auto blockY = 0; blockY < numBlocksY; blockY++)
+	{
+		for (auto blockX = 0; blockX < numBlocksX; blockX++)
+		{
+			loadBlock(pixels, width, height, blockX, blockY, block);
+			compressBlock(block, blocks);
+			blocks += blockSize;
+		}
+	}
+}
+
+} // namespace
+
+void BlockCompressor::compressBC1(const unsigned char* pixels, int width, int height, unsigned char* blocks)
+{
+	compressBlocks(pixels, width, height, blocks, BC1_BLOCK_SIZE, compressBC1Block);
+}
+
+void BlockCompressor::compressBC7(const unsigned char* pixels, int width, int height, unsigned char* blocks)
+{
+	compressBlocks(pixels, width, height, blocks, BC7_BLOCK_SIZE, compressBC7Block);
+}
+
+void BlockCompressor::downsample(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight)
+{
+	for (auto y = 0; y < dstHeight; y++)
+	{
+		const auto row0 = std::min(y * 2, srcHeight - 1);
+		const auto row1 = std::min(y * 2 + 1, srcHeight - 1);
+		for (auto x = 0; x < dstWidth; x++)
+		{
+			const auto column0 = std::min(x * 2, srcWidth - 1);
+			const auto column1 = std::min(x * 2 + 1, srcWidth - 1);
+			const auto pixel00 = src + (static_cast<size_t>(row0) * srcWidth + column0) * NUM_CHANNELS;
+			const auto pixel01 = src + (static_cast<size_t>(row0) * srcWidth + column1) * NUM_CHANNELS;
+			const auto pixel10 = src + (static_cast<size_t>(row1) * srcWidth + column0) * NUM_CHANNELS;
+			const auto pixel11 = src + (static_cast<size_t>(row1) * srcWidth + column1) * NUM_CHANNELS;
+			auto output = dst + (static_cast<size_t>(y) * dstWidth + x) * NUM_CHANNELS;
+			for (auto c = 0; c < NUM_CHANNELS; c++) {
+				output[c] = static_cast<unsigned char>((pixel00[c] + pixel01[c] + pixel10[c] + pixel11[c] + 2) / 4);
+			}
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+  Read-only pack of baked assets (mesh buffers, compressed texture layers), memory-mapped as one file.
+  The pack starts with a table of named entries; every entry's data begins at a page-aligned offset, so
+  runtime code passes pointers into the mapped pages straight to OpenGL, without parsing or opening other files.
+  Packs are produced offline by write() and are not checked against their sources, bake them again after edits.
+*/
+class AssetPack
+{
+public:
+	/** Data of one entry, pointing into the mapped file. */
+	struct Entry
+	{
+		const unsigned char* data = nullptr; //! First byte of the entry, nullptr if there's no such entry
+		size_t size = 0; //! Size of the entry, in bytes
+	};
+
+	/** Named entry to be written to a new pack. */
+	struct EntryData
+	{
+		std::string name;
+		std::vector<unsigned char> data;
+	};
+
+	~AssetPack();
+
+	/** \brief Memory-maps pack file and reads its table of entries.
+	*   \param filename Path to the pack
+	*   \return True if successful or false otherwise (e.g. there's no pack).
+	*/
+	bool open(const std::string& filename);
+
+	/** \brief Finds entry by its name.
+	*   \param name Entry name
+	*   \return Entry data, valid until the pack is closed, or empty entry if there's no such entry.
+	*/
+	Entry getEntry(const std::string& name) const;
+
+	/** \brief Checks, if the pack is open. */
+	bool isOpen() const;
+
+	/** \brief Unmaps the pack, entry data must not be used afterwards. */
+	void close();
+
+	/** \brief Writes new pack file, replacing the previous one.
+	*   \param filename Path to the pack
+	*   \param entries  Entries to write, names must be unique and shorter than 56 characters
+	*   \return True if successful or false otherwise.
+	*/
+	static bool write(const std::string& filename, const std::vector<EntryData>& entries);
+
+private:
+	const unsigned char* _mapped = nullptr; //! Whole mapped file
+	size_t _mappedSize = 0; //! Size of the mapped file, in bytes
+	void* _fileHandle = nullptr; //! Platform handle of the file mapping (Windows only)
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+// STL
+#include <cstddef>
+
+/**
+  CPU encoders of the block-compressed texture formats, which GPUs sample without decompressing them.
+  Both formats store every 4x4 pixel block as two endpoint colors and a per-pixel index of a color
+  interpolated between them; the endpoints are placed along the principal axis of the block's colors.
+  Images are RGBA8, 4 bytes per pixel; partial blocks at the right and bottom edges repeat the edge pixels.
+  The encoders keep no state, so any number of threads can compress different images at once.
+*/
+class BlockCompressor
+{
+public:
+	static const size_t BC1_BLOCK_SIZE = 8; //! Bytes per 4x4 block of BC1
+	static const size_t BC7_BLOCK_SIZE = 16; //! Bytes per 4x4 block of BC7
+
+	/** \brief Compresses image to BC1 (opaque, 565 endpoints, 4 colors per block), alpha is ignored.
+	*   \param pixels Image data, 4 bytes (RGBA) per pixel
+	*   \param width  Image width, in pixels
+	*   \param height Image height, in pixels
+	*   \param blocks Receives ceil(width / 4) * ceil(height / 4) * BC1_BLOCK_SIZE bytes, blocks in rows
+	*/
+	static void compressBC1(const unsigned char* pixels, int width, int height, unsigned char* blocks);
+
+	/** \brief Compresses image to BC7 using mode 6 (single subset RGBA, 7-bit endpoints with shared bit, 16 colors per block).
+	*   \param pixels Image data, 4 bytes (RGBA) per pixel
+	*   \param width  Image width, in pixels
+	*   \param height Image height, in pixels
+	*   \param blocks Receives ceil(width / 4) * ceil(height / 4) * BC7_BLOCK_SIZE bytes, blocks in rows
+	*/
+	static void compressBC7(const unsigned char* pixels, int width, int height, unsigned char* blocks);
+
+	/** \brief Halves image with 2x2 box filter, as the next mipmap level (odd edges repeat the last pixel).
+	*   \param src       Source image data, 4 bytes (RGBA) per pixel
+	*   \param srcWidth  Source image width, in pixels
+	*   \param srcHeight Source image height, in pixels
+	*   \param dst       Destination image data, 4 bytes (RGBA) per pixel
+	*   \param dstWidth  Destination image width, max(srcWidth / 2, 1)
+	*   \param dstHeight Destination image height, max(srcHeight / 2, 1)
+	*/
+	static void downsample(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int dstWidth, int dstHeight);
+};
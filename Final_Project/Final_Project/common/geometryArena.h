@@ -0,0 +1,115 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "staticMeshIndexed3D.h"
+#include "vertexBufferObject.h"
+
+/**
+  Packs many static meshes into one vertex buffer and one index buffer with a shared vertex format,
+  so that all of them can be drawn without switching VAOs (e.g. by one multi-draw call).
+  Meshes are gathered in memory first, then uploaded at once; afterwards each mesh is addressed by its MeshRange.
+*/
+class GeometryArena
+{
+public:
+	static const int POSITION_ATTRIBUTE_INDEX; //! Vertex attribute index of vertex position (0)
+	static const int NORMAL_ATTRIBUTE_INDEX; //! Vertex attribute index of vertex normal (1)
+	static const int TEXTURE_COORDINATE_ATTRIBUTE_INDEX; //! Vertex attribute index of texture coordinate (2)
+
+	/** Shared vertex format of all meshes in the arena. */
+	struct Vertex
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 texCoord;
+	};
+
+	/** Location of one mesh in the arena, as used by glDrawElementsBaseVertex and indirect draw commands. */
+	struct MeshRange
+	{
+		GLuint firstIndex = 0; //! First index in index buffer
+		GLuint indexCount = 0; //! Number of indices (triangle list)
+		GLint baseVertex = 0; //! Added to every index of the mesh
+	};
+
+	/** \brief Adds indexed triangle list.
+	*   \param vertices Mesh vertices
+	*   \param indices  Triangle indices, relative to first vertex of the mesh
+	*   \return Range of the added mesh.
+	*/
+	MeshRange addMesh(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices);
+
+	/** \brief Adds non-indexed triangle list with interleaved position, normal and texture coordinate (8 floats per vertex).
+	*   \param vertices    Interleaved vertex data
+	*   \param numVertices Number of vertices
+	*   \return Range of the added mesh.
+	*/
+	MeshRange addTriangles(const GLfloat* vertices, size_t numVertices);
+
+	/** \brief Adds static mesh, its strips and fans are converted to triangle list, reordered for vertex cache and overdraw.
+	*   \param mesh Static mesh, already initialized on the GPU
+	*   \return Range of the added mesh.
+	*/
+	MeshRange addMesh(const static_meshes_3D::StaticMesh3D& mesh);
+
+	/** \brief Adds indexed static mesh, its strips are converted to triangle list, reordered for vertex cache and overdraw.
+	*   \param mesh Indexed static mesh, already initialized on the GPU
+	*   \return Range of the added mesh.
+	*/
+	MeshRange addMesh(const static_meshes_3D::StaticMeshIndexed3D& mesh);
+
+	/** \brief Uploads all gathered meshes to the GPU and frees memory copies.
+	*   \return True if successful or false otherwise.
+	*/
+	bool upload();
+
+	/** \brief Uploads prebuilt arena content (e.g. baked into a memory-mapped asset pack) instead of gathered meshes.
+	*   \param vertices    Vertices of all meshes
+	*   \param numVertices Number of vertices
+	*   \param indices     Indices of all meshes
+	*   \param numIndices  Number of indices
+	*   \return True if successful or false otherwise.
+	*/
+	bool upload(const Vertex* vertices, size_t numVertices, const GLuint* indices, size_t numIndices);
+
+	/** \brief Gets vertices gathered so far (empty after upload). */
+	const std::vector<Vertex>& getVertices() const;
+
+	/** \brief Gets indices gathered so far (empty after upload). */
+	const std::vector<GLuint>& getIndices() const;
+
+	/** \brief Binds arena vertex and index buffers and sets vertex attribute pointers in currently bound VAO. */
+	void setupVertexAttributes() const;
+
+	/** \brief Gets number of vertices in the arena. */
+	int getNumVertices() const;
+
+	/** \brief Gets number of indices in the arena. */
+	int getNumIndices() const;
+
+	/** \brief Deletes arena buffers. */
+	void destroy();
+
+private:
+	/** \brief Reads vertices of static mesh back from the GPU in arena vertex format. */
+	static std::vector<Vertex> readVertices(const static_meshes_3D::StaticMesh3D& mesh);
+
+	/** \brief Reorders triangles converted from strips and fans for the post-transform cache, then to draw outer ones first. */
+	static void optimizeTriangles(const std::vector<Vertex>& vertices, std::vector<GLuint>& indices);
+
+	std::vector<Vertex> _vertices; //! Vertices gathered before upload
+	std::vector<GLuint> _indices; //! Indices gathered before upload
+	int _numVertices = 0; //! Total number of vertices
+	int _numIndices = 0; //! Total number of indices
+
+	VertexBufferObject _vbo; //! Vertices of all meshes
+	VertexBufferObject _ibo; //! Indices of all meshes
+
+	bool _isUploaded = false;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+// STL
+#include <atomic>
+
+#include <glad\glad.h>
+
+/**
+  Generates and deletes OpenGL buffers, vertex arrays and textures, counting those alive in the context.
+  Every class owning such objects creates and deletes them here, so a leak shows up as a steadily rising count,
+  without probing object names on the render thread.
+*/
+class GpuObjectCounter
+{
+public:
+	/** \brief Generates buffers and counts them. */
+	static void genBuffers(GLsizei count, GLuint* buffers);
+
+	/** \brief Deletes buffers, not counting zero names (ignored by OpenGL). */
+	static void deleteBuffers(GLsizei count, const GLuint* buffers);
+
+	/** \brief Generates vertex arrays and counts them. */
+	static void genVertexArrays(GLsizei count, GLuint* arrays);
+
+	/** \brief Deletes vertex arrays, not counting zero names (ignored by OpenGL). */
+	static void deleteVertexArrays(GLsizei count, const GLuint* arrays);
+
+	/** \brief Generates textures and counts them. */
+	static void genTextures(GLsizei count, GLuint* textures);
+
+	/** \brief Deletes textures, not counting zero names (ignored by OpenGL). */
+	static void deleteTextures(GLsizei count, const GLuint* textures);
+
+	/** \brief Gets number of buffers alive. */
+	static int getNumBuffers();
+
+	/** \brief Gets number of vertex arrays alive. */
+	static int getNumVertexArrays();
+
+	/** \brief Gets number of textures alive. */
+	static int getNumTextures();
+
+private:
+	static std::atomic<int> _numBuffers; //! Buffers generated and not deleted yet
+	static std::atomic<int> _numVertexArrays; //! Vertex arrays generated and not deleted yet
+	static std::atomic<int> _numTextures; //! Textures generated and not deleted yet
+
+	/** \brief Counts non-zero names. */
+	static int countNames(GLsizei count, const GLuint* names);
+};
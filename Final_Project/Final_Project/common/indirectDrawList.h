@@ -0,0 +1,161 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "geometryArena.h"
+#include "lodSelector.h"
+#include "objectTransform.h"
+#include "shaderStorageBufferObject.h"
+#include "vertexBufferObject.h"
+
+/**
+  Static list of draws of geometry arena meshes, rendered with glMultiDrawElementsIndirect.
+  Transforms and materials of all drawn objects are stored in a shader storage buffer. Each draw command
+  points to its first object with baseInstance; vertex shader gets object index from a per-instance
+  attribute holding 0, 1, 2..., which OpenGL fetches at baseInstance + gl_InstanceID.
+  Textures are layers of one texture array, selected per object, so all draws go out in a single call.
+  Objects of meshes with levels of detail have a command each, rewritten to their current level by updateLevels.
+
+  Shader interface (std430):
+
+  layout(location = 11) in uint aDrawIndex;
+  struct ObjectData { mat4 model; mat3 normalMatrix; float shininess; uint textureLayer; vec2 uvScale; };
+  layout(std430, binding = ...) readonly buffer Objects { ObjectData objects[]; };
+*/
+class IndirectDrawList
+{
+public:
+	static const int DRAW_INDEX_ATTRIBUTE_INDEX; //! Vertex attribute index of object index (11)
+
+	/** Command layout consumed by glMultiDrawElementsIndirect. */
+	struct DrawElementsIndirectCommand
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	/** Levels of detail of an arena mesh, selected per object from its screen size. */
+	struct LodMesh
+	{
+		std::vector<GeometryArena::MeshRange> levels; //! Arena ranges of the levels, from the finest
+		LodSelector selector; //! Selects level from screen size
+		float boundingRadius = 0.0f; //! Radius of bounding sphere of the mesh, centered at its origin
+	};
+
+	/** \brief Adds draw of single object.
+	*   \param mesh         Arena mesh to draw
+	*   \param textureLayer Texture array layer of the object
+	*   \param transform    Object transform
+	*   \param shininess    Material shininess
+	*   \param uvScale      Scale of texture coordinates (tiling of the texture)
+	*/
+	void addDraw(const GeometryArena::MeshRange& mesh, GLuint textureLayer, const ObjectTransform& transform, float shininess, const glm::vec2& uvScale = glm::vec2(1.0f, 1.0f));
+
+	/** \brief Adds draw of many copies of the same mesh (one command with instanceCount copies).
+	*   \param mesh          Arena mesh to draw
+	*   \param textureLayer  Texture array layer of the objects
+	*   \param modelMatrices Model matrix of every copy
+	*   \param shininess     Material shininess
+	*/
+	void addInstancedDraw(const GeometryArena::MeshRange& mesh, GLuint textureLayer, const std::vector<glm::mat4>& modelMatrices, float shininess);
+
+	/** \brief Adds draw of single object with level of detail selected every frame.
+	*   \param mesh         Levels of detail of arena mesh
+	*   \param textureLayer Texture array layer of the object
+	*   \param transform    Object transform
+	*   \param shininess    Material shininess
+	*/
+	void addLodDraw(const LodMesh& mesh, GLuint textureLayer, const ObjectTransform& transform, float shininess);
+
+	/** \brief Adds draws of many copies of the same mesh, each with its own level of detail (and its own command,
+	*   so distant copies of a large field drop to coarse levels while near ones stay fine, still in one multi-draw call).
+	*   \param mesh          Levels of detail of arena mesh
+	*   \param textureLayer  Texture array layer of the objects
+	*   \param modelMatrices Model matrix of every copy
+	*   \param shininess     Material shininess
+	*/
+	void addLodInstancedDraw(const LodMesh& mesh, GLuint textureLayer, const std::vector<glm::mat4>& modelMatrices, float shininess);
+
+	/** \brief Builds commands, uploads them with object data and creates VAO over arena buffers.
+	*   \param arena Uploaded geometry arena, that the draws refer to
+	*   \return True if successful or false otherwise.
+	*/
+	bool build(const GeometryArena& arena);
+
+	/** \brief Renders all draws by one glMultiDrawElementsIndirect, texture array must be bound by the caller.
+	*   \param objectsBindingPoint Shader storage binding point of object data
+	*/
+	void render(GLuint objectsBindingPoint) const;
+
+	/** \brief Selects level of detail of every object added with LOD mesh and rewrites commands of those changing level.
+	*   \param viewPosition   Camera position
+	*   \param projection     Projection matrix
+	*   \param viewportHeight Viewport height, in pixels
+	*   \return Number of objects that changed level.
+	*/
+	int updateLevels(const glm::vec3& viewPosition, const glm::mat4& projection, float viewportHeight);
+
+	/** \brief Gets number of indices drawn by all commands (instances included), at current levels of detail. */
+	size_t getNumDrawnIndices() const;
+
+	/** \brief Gets number of indirect draw commands. */
+	int getNumCommands() const;
+
+	/** \brief Gets number of drawn objects (instances included). */
+	int getNumObjects() const;
+
+	/** \brief Deletes GPU buffers and all draws. */
+	void destroy();
+
+private:
+	/** Per-object data in the shader storage buffer, std430 layout (mat3 columns are padded to vec4). */
+	struct ObjectData
+	{
+		glm::mat4 model;
+		glm::vec4 normalMatrix[3];
+		float shininess;
+		GLuint textureLayer;
+		glm::vec2 uvScale;
+	};
+
+	/** Draw added before build. */
+	struct PendingDraw
+	{
+		GeometryArena::MeshRange mesh;
+		GLuint firstObject;
+		GLuint numObjects;
+	};
+
+	/** Object drawn with levels of detail, by a command of its own. */
+	struct LodObject
+	{
+		size_t lodMesh; //! Index of its levels of detail in _lodMeshes
+		GLuint object; //! Index of its object data
+		GLuint command; //! Index of its command
+		int level; //! Current level (-1 before the first update)
+	};
+
+	/** \brief Appends object data of given model and normal matrix. */
+	void addObject(const glm::mat4& model, const glm::mat3& normalMatrix, float shininess, GLuint textureLayer, const glm::vec2& uvScale = glm::vec2(1.0f, 1.0f));
+
+	std::vector<PendingDraw> _draws; //! Draws added so far
+	std::vector<ObjectData> _objects; //! Object data of all draws
+	std::vector<LodMesh> _lodMeshes; //! Levels of detail of LOD draws
+	std::vector<LodObject> _lodObjects; //! Objects drawn with levels of detail
+	std::vector<DrawElementsIndirectCommand> _commands; //! Commands, kept after build to rewrite levels of detail
+	int _numCommands = 0; //! Number of commands, valid after build
+
+	GLuint _vao = 0; //! VAO over arena buffers with object index attribute
+	VertexBufferObject _commandsBuffer; //! Indirect draw commands
+	VertexBufferObject _drawIndexBuffer; //! Object indices 0, 1, 2... fetched per instance
+	ShaderStorageBufferObject _objectsBuffer; //! Object data
+
+	bool _isBuilt = false;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+// STL
+#include <memory>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "staticMesh3D.h"
+
+namespace static_meshes_3D {
+
+/**
+	Renders many copies of one static mesh using hardware instancing.
+	Per-instance model and normal matrices and optional material indices are stored in a separate VBO,
+	so that all copies are rendered with the instanced draw call(s) of the mesh.
+	Material index of an instance is a texture array layer, overriding the layer of the material it is drawn with.
+*/
+class InstancedMesh
+{
+public:
+	static const int INSTANCE_MODEL_ATTRIBUTE_INDEX; //!< First vertex attribute index of instance model matrix (3, occupies 3 - 6)
+	static const int INSTANCE_MATERIAL_ATTRIBUTE_INDEX; //!< Vertex attribute index of instance material index (7)
+	static const int INSTANCE_NORMAL_MATRIX_ATTRIBUTE_INDEX; //!< First vertex attribute index of instance normal matrix (8, occupies 8 - 10)
+	static const GLuint MATERIAL_LAYER; //!< Material index of instances keeping the texture layer of the material (0xFFFFFFFF)
+
+	explicit InstancedMesh(std::shared_ptr<const StaticMesh3D> mesh);
+	~InstancedMesh();
+
+	/** \brief  Replaces all instances and uploads their data to the GPU.
+	*   Normal matrices of all instances are computed here in one batch, so they're not recomputed per frame.
+	*   \param modelMatrices   Model matrix of every instance
+	*   \param materialIndices Optional texture array layer of every instance (MATERIAL_LAYER is used, if empty)
+	*/
+	void setInstances(const std::vector<glm::mat4>& modelMatrices, const std::vector<GLuint>& materialIndices = std::vector<GLuint>());
+
+	/** \brief  Renders all instances of the mesh. */
+	void render() const;
+
+	/** \brief  Gets number of instances.
+	*   \return Number of instances rendered by render().
+	*/
+	int getNumInstances() const;
+
+	/** \brief  Gets model matrices of all instances. */
+	const std::vector<glm::mat4>& getModelMatrices() const;
+
+	/** \brief  Gets the mesh being instanced. */
+	const StaticMesh3D& getMesh() const;
+
+	/** \brief  Gets VAO combining mesh vertex data with instance data. */
+	GLuint getVAO() const;
+
+	/** \brief  Deletes instance data. */
+	void deleteInstances();
+
+private:
+	/** Data stored per instance in the instance VBO. */
+	struct InstanceData
+	{
+		glm::mat4 model;
+		glm::mat3 normalMatrix;
+		GLuint materialIndex;
+	};
+
+	std::shared_ptr<const StaticMesh3D> _mesh; //!< Mesh to be instanced
+	GLuint _vao = 0; //!< VAO combining mesh vertex data with instance data
+	VertexBufferObject _instancesVBO; //!< VBO holding instance data
+	int _numInstances = 0; //!< Number of instances to render
+	std::vector<glm::mat4> _modelMatrices; //!< Model matrices of instances, kept for other renderers of the same props
+
+	bool _isInitialized = false; //!< Is VAO and instance VBO initialized flag
+};
+
+}; // namespace static_meshes_3D
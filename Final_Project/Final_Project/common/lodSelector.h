@@ -0,0 +1,62 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+/**
+  Selects level of detail of an object from its projected size on screen (diameter of its bounding sphere, in pixels).
+  Level 0 is the finest, every next level is used below a smaller screen size. Switching happens only once the size
+  leaves a band around the switch size (hysteresis), so objects moving near it don't pop back and forth every frame.
+*/
+class LodSelector
+{
+public:
+	static const float DEFAULT_HYSTERESIS; //! Relative half-width of the band around switch sizes (0.15)
+	static const float DEFAULT_MAX_EDGE_PIXELS; //! Longest screen-space edge of a silhouette tolerated by fromSliceCounts (16)
+
+	/** \brief Creates selector with a single level. */
+	LodSelector() = default;
+
+	/** \brief Creates selector with given switch sizes.
+	*   \param minScreenSizes Smallest screen size of every level but the last, descending (level i is used down to minScreenSizes[i])
+	*   \param hysteresis     Relative half-width of the band around switch sizes
+	*/
+	LodSelector(std::vector<float> minScreenSizes, float hysteresis = DEFAULT_HYSTERESIS);
+
+	/** \brief Creates selector for round meshes tessellated with given slice counts, switching to coarser level
+	*   once edges of its silhouette, screen size * pi / slices, stay within maxEdgePixels.
+	*   \param sliceCounts   Slice counts of the levels, descending
+	*   \param maxEdgePixels Longest tolerated edge, in pixels
+	*   \param hysteresis    Relative half-width of the band around switch sizes
+	*   \return Selector with as many levels as slice counts.
+	*/
+	static LodSelector fromSliceCounts(const std::vector<int>& sliceCounts, float maxEdgePixels = DEFAULT_MAX_EDGE_PIXELS,
+		float hysteresis = DEFAULT_HYSTERESIS);
+
+	/** \brief Calculates screen size of bounding sphere centered at the origin of model space.
+	*   \param model          Model matrix of the object (its largest scale scales the radius)
+	*   \param radius         Radius of bounding sphere, in model space
+	*   \param viewPosition   Camera position
+	*   \param projection     Projection matrix (perspective from camera zoom, or orthographic)
+	*   \param viewportHeight Viewport height, in pixels
+	*   \return Projected diameter in pixels.
+	*/
+	static float getScreenSize(const glm::mat4& model, float radius, const glm::vec3& viewPosition, const glm::mat4& projection, float viewportHeight);
+
+	/** \brief Gets number of levels. */
+	int getNumLevels() const;
+
+	/** \brief Selects level for given screen size, keeping current level while the size stays within its hysteresis band.
+	*   \param screenSize   Projected diameter in pixels
+	*   \param currentLevel Level selected in previous frame (-1 if none yet)
+	*   \return Selected level.
+	*/
+	int selectLevel(float screenSize, int currentLevel) const;
+
+private:
+	std::vector<float> _minScreenSizes; //! Smallest screen size of every level but the last
+	float _hysteresis = DEFAULT_HYSTERESIS; //! Relative half-width of the band around switch sizes
+};
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+// STL
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "lodSelector.h"
+
+namespace static_meshes_3D {
+
+/**
+	Chain of levels of detail of one mesh, from the finest, with selector of the level for drawn objects.
+	Objects keep their current level between frames themselves, so that one chain serves any number of them.
+*/
+template<typename MeshType>
+class MeshLod
+{
+public:
+	MeshLod() = default;
+
+	/** \brief  Creates chain of given levels.
+	*   \param levels         Meshes of the levels, from the finest
+	*   \param selector       Selector with as many levels as meshes
+	*   \param boundingRadius Radius of bounding sphere of the finest mesh, centered at the origin
+	*/
+	MeshLod(std::vector<std::shared_ptr<MeshType>> levels, LodSelector selector, float boundingRadius)
+		: _levels(std::move(levels))
+		, _selector(std::move(selector))
+		, _boundingRadius(boundingRadius) {}
+
+	/** \brief  Gets mesh of given level (clamped to the existing levels). */
+	const MeshType& getLevel(int level) const
+	{
+		return *_levels[std::min(std::max(level, 0), getNumLevels() - 1)];
+	}
+
+	/** \brief  Gets shared mesh of given level (clamped to the existing levels), for other owners of the levels. */
+	const std::shared_ptr<MeshType>& getSharedLevel(int level) const
+	{
+		return _levels[std::min(std::max(level, 0), getNumLevels() - 1)];
+	}
+
+	/** \brief  Gets number of levels. */
+	int getNumLevels() const
+	{
+		return static_cast<int>(_levels.size());
+	}
+
+	/** \brief  Gets selector of the levels. */
+	const LodSelector& getSelector() const
+	{
+		return _selector;
+	}
+
+	/** \brief  Gets radius of bounding sphere of the mesh, centered at the origin. */
+	float getBoundingRadius() const
+	{
+		return _boundingRadius;
+	}
+
+	/** \brief  Selects level of an object from its projected size.
+	*   \param model          Model matrix of the object
+	*   \param viewPosition   Camera position
+	*   \param projection     Projection matrix
+	*   \param viewportHeight Viewport height, in pixels
+	*   \param currentLevel   Level of the object in previous frame (-1 if none yet)
+	*   \return Selected level.
+	*/
+	int selectLevel(const glm::mat4& model, const glm::vec3& viewPosition, const glm::mat4& projection, float viewportHeight, int currentLevel) const
+	{
+		const auto screenSize = LodSelector::getScreenSize(model, _boundingRadius, viewPosition, projection, viewportHeight);
+		return std::min(_selector.selectLevel(screenSize, currentLevel), getNumLevels() - 1);
+	}
+
+	/** \brief  Selects one level for a group of objects drawn together, from the largest of them on screen.
+	*   \param models         Model matrices of the objects
+	*   \param viewPosition   Camera position
+	*   \param projection     Projection matrix
+	*   \param viewportHeight Viewport height, in pixels
+	*   \param currentLevel   Level of the group in previous frame (-1 if none yet)
+	*   \return Selected level.
+	*/
+	int selectLevel(const std::vector<glm::mat4>& models, const glm::vec3& viewPosition, const glm::mat4& projection, float viewportHeight, int currentLevel) const
+	{
+		auto screenSize = 0.0f;
+		for (const auto& model : models) {
+			screenSize = std::max(screenSize, LodSelector::getScreenSize(model, _boundingRadius, viewPosition, projection, viewportHeight));
+		}
+
+		return std::min(_selector.selectLevel(screenSize, currentLevel), getNumLevels() - 1);
+	}
+
+private:
+	std::vector<std::shared_ptr<MeshType>> _levels; //!< Meshes of the levels, from the finest
+	LodSelector _selector; //!< Selects level from screen size
+	float _boundingRadius = 0.0f; //!< Radius of bounding sphere centered at the origin
+};
+
+} // namespace static_meshes_3D
\ No newline at end of file
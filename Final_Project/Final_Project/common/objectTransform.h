@@ -0,0 +1,54 @@
+#pragma once
+
+// STL
+#include <cstddef>
+
+// GLM
+#include <glm/glm.hpp>
+
+/**
+  Model matrix of an object together with its normal matrix.
+  The normal matrix is computed on the CPU whenever the model matrix is set,
+  so shaders don't need to invert the model matrix per vertex.
+*/
+class ObjectTransform
+{
+public:
+	ObjectTransform();
+	explicit ObjectTransform(const glm::mat4& model);
+
+	/** \brief Sets model matrix, normal matrix is recomputed only if the model matrix has changed.
+	*   \param model New model matrix
+	*/
+	void setModel(const glm::mat4& model);
+
+	/** \brief Gets model matrix.
+	*   \return Model matrix.
+	*/
+	const glm::mat4& getModel() const;
+
+	/** \brief Gets normal matrix belonging to model matrix.
+	*   \return Normal matrix.
+	*/
+	const glm::mat3& getNormalMatrix() const;
+
+	/** \brief Computes normal matrix of model matrix.
+	*   The result is the cofactor matrix of upper 3x3 part, which is inverse transpose scaled by |determinant|.
+	*   Normals have to be normalized after transformation, but degenerated matrices (scale 0 on some axis,
+	*   used for flat planes) still produce correct normals.
+	*   \param model Model matrix
+	*   \return Normal matrix.
+	*/
+	static glm::mat3 computeNormalMatrix(const glm::mat4& model);
+
+	/** \brief Computes normal matrices of many model matrices at once (4 at a time with SSE, if available).
+	*   \param models         Model matrices
+	*   \param normalMatrices Output normal matrices, must have room for count matrices
+	*   \param count          Number of matrices
+	*/
+	static void computeNormalMatrices(const glm::mat4* models, glm::mat3* normalMatrices, size_t count);
+
+private:
+	glm::mat4 _model; //! Model matrix
+	glm::mat3 _normalMatrix; //! Normal matrix belonging to model matrix
+};
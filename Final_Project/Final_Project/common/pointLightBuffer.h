@@ -0,0 +1,89 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "shaderStorageBufferObject.h"
+
+/**
+  Point light as stored in the lights shader storage buffer, std430 layout
+  (every vec3 is followed by a float, so that each pair fills 16 bytes).
+*/
+struct PointLight
+{
+	glm::vec3 position;
+	float radius; //! Distance, beyond which the light doesn't contribute visibly
+	glm::vec3 ambient;
+	float constant;
+	glm::vec3 diffuse;
+	float linear;
+	glm::vec3 specular;
+	float quadratic;
+};
+
+/**
+  Holds all point lights of the scene in a shader storage buffer, so that shaders can
+  iterate over any number of lights in a single pass. Buffer content is a light count
+  followed by array of PointLight structures:
+
+  layout(std430, binding = ...) readonly buffer PointLights
+  {
+      uint numLights;
+      PointLight lights[];
+  };
+*/
+class PointLightBuffer
+{
+public:
+	/** \brief Adds a new light. Its attenuation radius is computed from attenuation factors and brightest color.
+	*   \return Index of the added light.
+	*/
+	int addLight(const glm::vec3& position, const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular,
+		float constant, float linear, float quadratic);
+
+	/** \brief Moves light to a new position (changes get uploaded with next uploadToGPU call).
+	*   \param lightIndex Index of the light returned by addLight
+	*   \param position   New light position
+	*/
+	void setLightPosition(int lightIndex, const glm::vec3& position);
+
+	/** \brief Gets light data.
+	*   \param lightIndex Index of the light returned by addLight
+	*/
+	const PointLight& getLight(int lightIndex) const;
+
+	/** \brief Gets number of lights. */
+	int getNumLights() const;
+
+	/** \brief Uploads lights to the GPU (only if they've changed since last upload) and binds the buffer.
+	*   \param bindingPoint Binding point, as declared in shaders with layout(binding = ...)
+	*/
+	void uploadToGPU(GLuint bindingPoint);
+
+	/** \brief Deletes lights and frees GPU memory. */
+	void deleteLights();
+
+	/** \brief Computes distance, at which light contribution falls below 5 / 256 (not visible in 8-bit color).
+	*   \param maxIntensity Brightest channel of light colors
+	*   \param constant     Constant attenuation factor
+	*   \param linear       Linear attenuation factor
+	*   \param quadratic    Quadratic attenuation factor
+	*   \return Attenuation radius.
+	*/
+	static float computeAttenuationRadius(float maxIntensity, float constant, float linear, float quadratic);
+
+private:
+	/** Header preceding light array in the buffer, std430 layout (array of structs starts at 16 bytes). */
+	struct LightBufferHeader
+	{
+		GLuint numLights;
+		GLuint padding[3];
+	};
+
+	std::vector<PointLight> _lights; //! Lights in CPU memory
+	ShaderStorageBufferObject _ssbo; //! GPU copy of the lights
+	bool _isDirty = true; //! Have lights changed since last upload flag
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "shaderProgram.h"
+#include "objectTransform.h"
+
+/**
+  Uniform values shared by draws of the same kind of surface. Values are applied only
+  to the uniforms, which are active in the program of the draw.
+*/
+struct RenderMaterial
+{
+	float shininess = 32.0f; //! shininess
+	glm::vec2 uvScale = glm::vec2(1.0f, 1.0f); //! uvScale
+	glm::vec3 color = glm::vec3(1.0f, 1.0f, 1.0f); //! light.color
+	GLuint textureLayer = 0; //! textureLayer
+};
+
+/**
+  Collects draws of one frame, sorts them by 64-bit key (program, VAO, texture, material, depth)
+  and submits them, so that OpenGL state is changed only when it really differs from previous draw.
+*/
+class RenderQueue
+{
+public:
+	/** Counts of state changes done during one execute() and changes saved compared to binding everything for every draw. */
+	struct Statistics
+	{
+		int numDraws = 0;
+		int programChanges = 0;
+		int programChangesSaved = 0;
+		int vaoChanges = 0;
+		int vaoChangesSaved = 0;
+		int textureChanges = 0;
+		int textureChangesSaved = 0;
+		int uniformChanges = 0;
+		int uniformChangesSaved = 0;
+	};
+
+	/** \brief Registers a material, which can be used by submitted draws.
+	*   \param material Material uniform values
+	*   \return Index of the material (at most 256 materials are supported).
+	*/
+	int addMaterial(const RenderMaterial& material);
+
+	/** \brief Sets position of the viewer, used to sort draws front to back.
+	*   \param viewPosition Camera position in world space
+	*   \param farPlane     Distance of far plane, farther draws share the same depth
+	*/
+	void setViewPosition(const glm::vec3& viewPosition, float farPlane);
+
+	/** \brief Submits a draw to the queue.
+	*   \param program       Shader program of the draw
+	*   \param vao           VAO bound before the draw
+	*   \param texture       Texture array bound to texture unit 0 before the draw (layer is selected by material)
+	*   \param materialIndex Index of the material returned by addMaterial
+	*   \param transform     Object transform, or nullptr for instanced draws (transforms are in instance attributes)
+	*   \param draw          Issues the draw call(s), program, VAO, texture and uniforms are already set
+	*   \param positionDequantization Position dequantization of the mesh, applied before the model matrix (quantized meshes only)
+	*/
+	void submit(const ShaderProgram& program, GLuint vao, GLuint texture, int materialIndex, const ObjectTransform* transform, std::function<void()> draw,
+		const glm::mat4& positionDequantization = glm::mat4(1.0f));
+
+	/** \brief Sorts all submitted draws, submits them to OpenGL and clears the queue. */
+	void execute();
+
+	/** \brief Gets number of draws waiting in the queue. */
+	int getNumItems() const;
+
+	/** \brief Gets state change statistics of the last execute() call. */
+	const Statistics& getLastFrameStatistics() const;
+
+	/** \brief Builds sort key. Bits from most to least significant are 8 bits program, 12 bits VAO,
+	*   12 bits texture, 8 bits material and 24 bits depth. OpenGL names wider than their field
+	*   only make the grouping less perfect, they never cause wrong rendering.
+	*   \param normalizedDepth Depth in range 0 (near) to 1 (far)
+	*   \return Sort key.
+	*/
+	static uint64_t makeSortKey(GLuint programId, GLuint vao, GLuint texture, int materialIndex, float normalizedDepth);
+
+	/** \brief Sorts keys in ascending order with LSD radix sort (8 bits per pass), carrying item indices along.
+	*   Passes, in which all keys have the same digit, are skipped.
+	*   \param keys         Keys to sort
+	*   \param indices      Item indices belonging to keys
+	*   \param keysTemp     Scratch buffer for keys (resized as needed)
+	*   \param indicesTemp  Scratch buffer for indices (resized as needed)
+	*/
+	static void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& indices, std::vector<uint64_t>& keysTemp, std::vector<uint32_t>& indicesTemp);
+
+private:
+	/** Submitted draw. */
+	struct Item
+	{
+		const ShaderProgram* program;
+		GLuint vao;
+		GLuint texture;
+		int materialIndex;
+		const ObjectTransform* transform;
+		std::function<void()> draw;
+		glm::mat4 positionDequantization;
+	};
+
+	/** Last uniform values set in a shader program (uniforms keep their values per program). */
+	struct ProgramState
+	{
+		int materialIndex = -1;
+		int instanced = -1;
+	};
+
+	/** \brief Applies material uniforms, which are active in the program.
+	*   \return Number of uniforms set.
+	*/
+	int applyMaterial(const ShaderProgram& program, const RenderMaterial& material) const;
+
+	std::vector<Item> _items; //! Draws submitted this frame
+	std::vector<uint64_t> _keys; //! Sort keys of the draws
+	std::vector<uint32_t> _order; //! Indices of draws, sorted by key
+	std::vector<uint64_t> _keysTemp; //! Radix sort scratch buffer
+	std::vector<uint32_t> _orderTemp; //! Radix sort scratch buffer
+	std::vector<RenderMaterial> _materials; //! Registered materials
+	std::unordered_map<GLuint, ProgramState> _programStates; //! Uniform state of programs used during execute()
+
+	glm::vec3 _viewPosition = glm::vec3(0.0f); //! Camera position used for depth sorting
+	float _farPlane = 100.0f; //! Depth normalization distance
+
+	Statistics _statistics; //! Statistics of the last execute()
+};
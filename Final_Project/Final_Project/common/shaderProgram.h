@@ -0,0 +1,75 @@
+#pragma once
+
+// STL
+#include <string>
+#include <unordered_map>
+
+#include <glad\glad.h>
+
+/**
+  Uniforms known to the renderer. Their locations are resolved once after linking,
+  so the render loop can look them up by constant index instead of by name.
+*/
+enum class ShaderUniform
+{
+	Model,
+	NormalMatrix,
+	Instanced,
+	UVScale,
+	MaterialShininess,
+	LightColor,
+	TextureLayer,
+
+	Count
+};
+
+/**
+  Wraps linked OpenGL shader program together with its uniform locations.
+*/
+class ShaderProgram
+{
+public:
+	ShaderProgram();
+
+	/** \brief Introspects all active uniforms of linked program and caches their locations.
+	*   \param programId OpenGL ID of successfully linked program
+	*/
+	void reflectProgram(GLuint programId);
+
+	/** \brief Gets OpenGL program ID.
+	*   \return Program ID.
+	*/
+	GLuint getProgramID() const;
+
+	/** \brief Gets location of known uniform (constant time, no driver call).
+	*   \param uniform Known uniform
+	*   \return Uniform location, or -1 if the program doesn't use this uniform.
+	*/
+	GLint getUniformLocation(ShaderUniform uniform) const
+	{
+		return _knownLocations[static_cast<int>(uniform)];
+	}
+
+	/** \brief Gets location of arbitrary uniform from reflected table (no driver call).
+	*   \param name Uniform name, as declared in shader
+	*   \return Uniform location, or -1 if there is no such active uniform.
+	*/
+	GLint getUniformLocation(const std::string& name) const;
+
+	/** \brief Gets number of active uniforms found by reflection.
+	*   \return Number of active uniforms.
+	*/
+	int getNumActiveUniforms() const;
+
+	/** \brief Gets name of known uniform, as declared in shaders.
+	*   \param uniform Known uniform
+	*   \return Uniform name.
+	*/
+	static const char* getUniformName(ShaderUniform uniform);
+
+private:
+	GLuint _programID = 0; //! OpenGL assigned program ID
+
+	std::unordered_map<std::string, GLint> _uniformLocations; //! Locations of all active uniforms by name
+	GLint _knownLocations[static_cast<int>(ShaderUniform::Count)]; //! Locations of known uniforms, indexed by ShaderUniform
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+// STL
+#include <cstddef>
+
+#include <glad\glad.h>
+
+/**
+  Wraps OpenGL's shader storage buffer object. Unlike uniform buffers, its size isn't limited
+  to a few kilobytes and shaders can index runtime-sized arrays in it.
+*/
+class ShaderStorageBufferObject
+{
+public:
+	/** \brief Creates a new SSBO and allocates its storage on the GPU (content is undefined until set).
+	*   \param byteSize  Size of the buffer, in bytes
+	*   \param usageHint Hint for OpenGL, how is the data intended to be used (GL_STATIC_DRAW, GL_DYNAMIC_DRAW)
+	*/
+	void createSSBO(size_t byteSize, GLenum usageHint = GL_DYNAMIC_DRAW);
+
+	/** \brief Reallocates storage of the buffer, if it's smaller than requested size (previous content is lost).
+	*   \param byteSize Minimal size of the buffer, in bytes
+	*   \return True, if the buffer has been reallocated (and needs to be re-bound), false otherwise.
+	*/
+	bool reserve(size_t byteSize);
+
+	/** \brief Uploads data to part of the buffer.
+	*   \param ptrData       Pointer to the raw data (usually std430 laid out struct)
+	*   \param dataSizeBytes Size of the data, in bytes
+	*   \param offsetBytes   Byte offset in buffer, where to write the data
+	*/
+	void setData(const void* ptrData, size_t dataSizeBytes, size_t offsetBytes = 0);
+
+	/** \brief Binds whole buffer to shader storage block binding point.
+	*   \param bindingPoint Binding point, as declared in shaders with layout(binding = ...)
+	*/
+	void bindBufferBase(GLuint bindingPoint) const;
+
+	/** \brief Gets OpenGL-assigned buffer ID.
+	*   \return Buffer ID.
+	*/
+	GLuint getBufferID() const;
+
+	/** \brief Gets buffer size, in bytes.
+	*   \return Buffer size in bytes.
+	*/
+	size_t getBufferSize() const;
+
+	//* \brief Deletes SSBO and frees its GPU memory.
+	void deleteSSBO();
+
+private:
+	GLuint _bufferID = 0; //! OpenGL assigned buffer ID
+	size_t _bufferSize = 0; //! Allocated buffer size, in bytes
+	GLenum _usageHint = GL_DYNAMIC_DRAW; //! Usage hint used when (re)allocating storage
+
+	bool _isBufferCreated = false;
+};
@@ -1,6 +1,13 @@
 #pragma once
 
+// STL
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
 #include "vertexBufferObject.h"
+#include "vertexFormat.h"
 
 
 namespace static_meshes_3D {
@@ -15,7 +22,16 @@ public:
 	static const int TEXTURE_COORDINATE_ATTRIBUTE_INDEX; //!< Vertex attribute index of texture coordinate (1)
 	static const int NORMAL_ATTRIBUTE_INDEX; //!< Vertex attribute index of vertex normal (2)
 
-	StaticMesh3D(bool withPositions, bool withTextureCoordinates, bool withNormals);
+	/** One draw call range of the mesh, as issued by render(). */
+	struct DrawRange
+	{
+		GLenum mode; //!< Primitive type (GL_TRIANGLES, GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN)
+		GLint first; //!< First vertex
+		GLsizei count; //!< Number of vertices
+	};
+
+	StaticMesh3D(bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout = VertexLayout::Planar,
+		const VertexEncoding& encoding = VertexEncoding());
 	virtual ~StaticMesh3D();
 
 	/** \brief  Renders static mesh. */
@@ -24,6 +40,28 @@ public:
 	/** \brief  Renders static mesh as points only. */
 	virtual void renderPoints() const {}
 
+	/** \brief  Renders given number of instances of static mesh, using currently bound VAO.
+	*   \param numInstances Number of instances to render
+	*/
+	virtual void renderInstanced(GLsizei numInstances) const = 0;
+
+	/** \brief  Gets draw call ranges, which render() issues (so that the mesh can be converted to other formats).
+	*   \return Draw ranges in the order of rendering.
+	*/
+	virtual std::vector<DrawRange> getDrawRanges() const { return std::vector<DrawRange>(); }
+
+	/** \brief  Reads vertex data of the mesh back from the GPU. Missing attributes are filled with zeros.
+	*   \param positions     Vertex positions
+	*   \param texCoords     Vertex texture coordinates
+	*   \param normals       Vertex normals
+	*/
+	void readVertexData(std::vector<glm::vec3>& positions, std::vector<glm::vec2>& texCoords, std::vector<glm::vec3>& normals) const;
+
+	/** \brief  Binds mesh vertex data and sets its attribute pointers in currently bound VAO.
+	*   This way other VAOs (e.g. for instanced rendering) can share vertex data of this mesh.
+	*/
+	virtual void setupVertexAttributes() const;
+
 	/** \brief  Deletes static mesh data. */
 	virtual void deleteMesh();
 
@@ -43,24 +81,46 @@ public:
 	bool hasNormals() const;
 
 	/** \brief  Calculates byte size of one vertex, depending on its attributes.
-	*   \return True if it has or false otherwise.
+	*   \return Size in bytes.
 	*/
 	int getVertexByteSize() const;
 
+	/** \brief  Gets format describing how vertex attributes are stored in the VBO.
+	*   Meshes with quantized positions must be drawn with model matrix multiplied by its position dequantization
+	*   (InstancedMesh folds it into instance matrices, RenderQueue::submit takes it along with the transform).
+	*/
+	const VertexFormat& getVertexFormat() const;
+
+	/** \brief  Gets VAO of the mesh, so that renderers can bind it only when it changes.
+	*   \return VAO ID from OpenGL.
+	*/
+	GLuint getVAO() const;
+
 protected:
 	bool _hasPositions = false; //!< Flag telling, if we have vertex positions
 	bool _hasTextureCoordinates = false; //!< Flag telling, if we have texture coordinates
 	bool _hasNormals = false; //!< Flag telling, if we have vertex normals
 
+	VertexFormat _vertexFormat; //!< Layout of vertex attributes in the VBO
 	bool _isInitialized = false; //!< Is mesh initialized flag
 	GLuint _vao = 0; //!< VAO ID from OpenGL
 	VertexBufferObject _vbo; //!< Our VBO wrapper class holding static mesh data
+	int _numVBOVertices = 0; //!< Number of vertices stored in VBO (needed to set attribute pointers)
 
 	/** \brief  Initializes vertex data. */
 	virtual void initializeData() {};
 
 	/** \brief  Sets vertex attribute pointers in a standard way. */
 	void setVertexAttributesPointers(int numVertices);
+
+	/** \brief  Packs vertex data in the layout of vertex format, uploads them to the VBO and sets attribute pointers.
+	*   Data of attributes, which the mesh doesn't have, may be empty.
+	*   \param numVertices Number of vertices
+	*   \param positions   Vertex positions
+	*   \param texCoords   Vertex texture coordinates
+	*   \param normals     Vertex normals
+	*/
+	void uploadVertexData(int numVertices, const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& texCoords, const std::vector<glm::vec3>& normals);
 };
 
 }; // namespace static_meshes_3D
\ No newline at end of file
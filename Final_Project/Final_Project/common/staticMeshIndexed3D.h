@@ -1,26 +1,78 @@
 #pragma once
 
+#include "meshOptimizer.h"
 #include "staticMesh3D.h"
 
 namespace static_meshes_3D {
 
 /**
 	Represents generic 3D static mesh rendered with indexed rendering.
+	Vertices shared by several primitives are stored only once and all primitives of the mesh are rendered
+	with one glDrawElements call, strips are separated by primitive restart index.
 */
 class StaticMeshIndexed3D : public StaticMesh3D
 {
 public:
-	StaticMeshIndexed3D(bool withPositions, bool withTextureCoordinates, bool withNormals);
+	StaticMeshIndexed3D(bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout = VertexLayout::Planar,
+		const VertexEncoding& encoding = VertexEncoding());
 	virtual ~StaticMeshIndexed3D();
 
+	void render() const override;
+	void renderPoints() const override;
+	void renderInstanced(GLsizei numInstances) const override;
+
+	/** \brief  Reads indices of the mesh back from the GPU.
+	*   \param indices Indices in the order of rendering, strips separated by primitive restart index
+	*/
+	void readIndexData(std::vector<GLuint>& indices) const;
+
+	/** \brief  Reads indices of the mesh back from the GPU as triangle list (strips are split at restart indices).
+	*   \param indices Triangle list indices, with the winding of rendered triangles
+	*/
+	void readTriangleIndices(std::vector<GLuint>& indices) const;
+
+	/** \brief  Reorders triangles for post-transform vertex cache, optionally in clusters reducing overdraw, and vertices
+	*   for sequential fetch, then uploads them again. Strips are replaced by triangle list only if it transforms fewer vertices.
+	*   \param reduceOverdraw Whether to sort triangle clusters so that outer surfaces render first
+	*   \param before         Receives vertex cache statistics of the indices before optimization (optional)
+	*   \param after          Receives vertex cache statistics of the optimized indices (optional)
+	*   \return True if the mesh has been reordered or false if it's kept as it was.
+	*/
+	bool optimize(bool reduceOverdraw = false, MeshOptimizer::VertexCacheStatistics* before = nullptr,
+		MeshOptimizer::VertexCacheStatistics* after = nullptr);
+
+	/** \brief  Binds mesh vertex and index data and sets attribute pointers in currently bound VAO. */
+	void setupVertexAttributes() const override;
+
 	void deleteMesh() override;
 
+	/** \brief  Gets primitive type of the indices (GL_TRIANGLES or GL_TRIANGLE_STRIP). */
+	GLenum getPrimitiveType() const;
+
+	/** \brief  Gets index separating strips of the mesh (equal to number of vertices, so it never addresses a vertex). */
+	GLuint getPrimitiveRestartIndex() const;
+
+	/** \brief  Gets number of vertices stored in the VBO. */
+	int getNumVertices() const;
+
+	/** \brief  Gets number of indices rendered, including primitive restart indices. */
+	int getNumIndices() const;
+
 protected:
 	VertexBufferObject _indicesVBO; //!< Our VBO wrapper class holding indices data
 
+	GLenum _primitiveType = GL_TRIANGLES; //!< Primitive type rendered from the indices
 	int _numVertices = 0; //!< Holds the total number of generated vertices
 	int _numIndices = 0; //!< Holds the number of generated indices used for rendering
 	int _primitiveRestartIndex = 0; //!< Index of primitive restart
+
+	/** \brief  Uploads indices to the index buffer and binds it to currently bound VAO (the mesh VAO).
+	*   Number of vertices and primitive restart index must have been set already. Index buffer is created
+	*   while the mesh initializes, later uploads (of optimized indices) replace its data.
+	*   \param primitiveType Primitive type rendered from the indices
+	*   \param indices       Indices to upload, taken over by the index buffer
+	*/
+	void uploadIndexData(GLenum primitiveType, std::vector<GLuint>&& indices);
 };
 
 }; // namespace static_meshes_3D
\ No newline at end of file
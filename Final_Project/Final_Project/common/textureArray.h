@@ -0,0 +1,139 @@
+#pragma once
+
+// STL
+#include <cstddef>
+
+#include <glad\glad.h>
+
+/**
+  Storage formats of texture array layers.
+*/
+enum class TextureFormat
+{
+	RGBA8, //! Uncompressed, mipmaps are generated on the GPU
+	BC1, //! 4 bits per pixel, opaque (S3TC DXT1), mipmaps are compressed on the CPU
+	BC7, //! 8 bits per pixel, with alpha (BPTC), mipmaps are compressed on the CPU
+};
+
+/**
+  Wraps OpenGL's 2D texture array, all layers have the same size and format.
+  Images of other sizes are resampled to the layer size when they are added (padding them instead
+  would show the padding wherever texture coordinates repeat). Shaders select layer by its index,
+  so draws with different textures don't need to rebind anything.
+
+  Layer data, as passed to uploadLayer, is level 0 in RGBA8 for uncompressed arrays, or all mipmap
+  levels of the layer one after another (largest first) for block-compressed arrays.
+*/
+class TextureArray
+{
+public:
+	/** \brief Creates texture array with immutable storage for all layers and mipmap levels.
+	*   \param width     Width of every layer, in pixels
+	*   \param height    Height of every layer, in pixels
+	*   \param numLayers Number of layers
+	*   \param format    Storage format of all layers
+	*   \return True if successful or false otherwise.
+	*/
+	bool create(GLsizei width, GLsizei height, GLsizei numLayers, TextureFormat format = TextureFormat::RGBA8);
+
+	/** \brief Uploads image to the next free layer, resampling it to the layer size if needed.
+	*   \param pixels Image data, 4 bytes (RGBA) per pixel, rows going from top to bottom
+	*   \param width  Image width, in pixels
+	*   \param height Image height, in pixels
+	*   \return Index of the layer, or -1 if the array is full.
+	*/
+	int addLayer(const unsigned char* pixels, int width, int height);
+
+	/** \brief Loads image file and uploads it to the next free layer.
+	*   \param filename Path to the image
+	*   \return Index of the layer, or -1 if the image couldn't be loaded or the array is full.
+	*/
+	int addLayerFromFile(const char* filename);
+
+	/** \brief Reserves consecutive free layers, to be filled by uploadLayer later (e.g. once they're decoded).
+	*   \param count Number of layers
+	*   \return Index of the first reserved layer, or -1 if there aren't enough free layers.
+	*/
+	int reserveLayers(int count);
+
+	/** \brief Converts image of the layer size to layer data of the array format (compresses all mipmap levels).
+	*   \param layerPixels Image data, 4 bytes (RGBA) per pixel, layer width x height, rows going from bottom to top
+	*   \param layerData   Receives getLayerDataSize() bytes of layer data (may be the same memory for RGBA8)
+	*/
+	void encodeLayer(const unsigned char* layerPixels, unsigned char* layerData) const;
+
+	/** \brief Uploads layer data to already reserved layer.
+	*   \param layer     Index of the layer
+	*   \param layerData Layer data in the array format, rows going from bottom to top
+	*                    (byte offset into the buffer, when a pixel unpack buffer is bound)
+	*/
+	void uploadLayer(int layer, const unsigned char* layerData) const;
+
+	/** \brief Generates mipmap levels of all layers, call it after all layers are added (uncompressed arrays only). */
+	void generateMipmaps() const;
+
+	/** \brief Generates mipmap levels of one layer only, so that layers uploaded later don't touch the others.
+	*   Block-compressed layers are uploaded with all their levels, so there's nothing to generate for them.
+	*   \param layer Index of the layer
+	*/
+	void generateLayerMipmaps(int layer) const;
+
+	/** \brief Binds texture array to the texture unit.
+	*   \param textureUnit Texture unit (GL_TEXTURE0, GL_TEXTURE1...)
+	*/
+	void bind(GLenum textureUnit = GL_TEXTURE0) const;
+
+	/** \brief Gets OpenGL-assigned texture ID. */
+	GLuint getTextureID() const;
+
+	/** \brief Gets width of every layer, in pixels. */
+	GLsizei getWidth() const;
+
+	/** \brief Gets height of every layer, in pixels. */
+	GLsizei getHeight() const;
+
+	/** \brief Gets number of mipmap levels. */
+	GLsizei getNumLevels() const;
+
+	/** \brief Gets storage format of the layers. */
+	TextureFormat getFormat() const;
+
+	/** \brief Gets size of data of one layer, as passed to uploadLayer, in bytes. */
+	size_t getLayerDataSize() const;
+
+	/** \brief Gets size of one mipmap level of an image in given format, in bytes.
+	*   \param format Storage format
+	*   \param width  Level width, in pixels
+	*   \param height Level height, in pixels
+	*/
+	static size_t getLevelDataSize(TextureFormat format, GLsizei width, GLsizei height);
+
+	/** \brief Gets number of layers filled (or reserved) so far. */
+	int getNumLayers() const;
+
+	/** \brief Deletes texture array. */
+	void destroy();
+
+	/** \brief Resamples RGBA image to another size by averaging source pixels covered by each destination pixel.
+	*   Rows are flipped on the way, because images are stored from the top, but OpenGL textures start at the bottom.
+	*   \param source            Source image, rows going from top to bottom
+	*   \param sourceWidth       Source image width, in pixels
+	*   \param sourceHeight      Source image height, in pixels
+	*   \param destination       Destination image, rows going from bottom to top
+	*   \param destinationWidth  Destination image width, in pixels
+	*   \param destinationHeight Destination image height, in pixels
+	*/
+	static void resampleFlipped(const unsigned char* source, int sourceWidth, int sourceHeight,
+		unsigned char* destination, int destinationWidth, int destinationHeight);
+
+private:
+	GLuint _textureID = 0; //! OpenGL assigned texture ID
+	GLsizei _width = 0; //! Width of every layer
+	GLsizei _height = 0; //! Height of every layer
+	GLsizei _numLevels = 0; //! Number of mipmap levels
+	TextureFormat _format = TextureFormat::RGBA8; //! Storage format of all layers
+	GLsizei _maxLayers = 0; //! Number of allocated layers
+	GLsizei _numLayers = 0; //! Number of filled or reserved layers
+
+	bool _isCreated = false;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <string>
+
+#include "textureArray.h"
+
+/**
+  Cache of block-compressed texture array layers on disk, so that later startups skip decoding and compressing images.
+  Every image gets a cache file next to it (e.g. images/grass.jpg.bc7), holding all mipmap levels of its layer.
+  The file is keyed by hash of the image file content together with the layer size and format, so a changed image,
+  a different layer size or format simply miss the cache and the file gets rewritten.
+*/
+class TextureCache
+{
+public:
+	/** \brief Hashes content of the file (64-bit FNV-1a).
+	*   \param filename Path to the file
+	*   \param hash     Receives the hash
+	*   \return True if the file has been read or false otherwise.
+	*/
+	static bool hashFile(const std::string& filename, uint64_t& hash);
+
+	/** \brief Gets path of cache file of image for texture format.
+	*   \param imageFilename Path to the image
+	*   \param format        Texture format of the cached layer
+	*/
+	static std::string getCacheFilename(const std::string& imageFilename, TextureFormat format);
+
+	/** \brief Checks, if complete cache file matching the image and the texture array exists, without reading the layer data.
+	*   \param imageFilename Path to the image
+	*   \param imageHash     Hash of the image file content
+	*   \param textureArray  Texture array the layer is for, gives format, size and number of levels
+	*/
+	static bool contains(const std::string& imageFilename, uint64_t imageHash, const TextureArray& textureArray);
+
+	/** \brief Reads cached layer data, if the cache file matches the image and the texture array.
+	*   \param imageFilename Path to the image
+	*   \param imageHash     Hash of the image file content
+	*   \param textureArray  Texture array the layer is for, gives format, size and number of levels
+	*   \param layerData     Receives textureArray.getLayerDataSize() bytes of layer data
+	*   \return True if the layer has been read from the cache or false otherwise (cache miss).
+	*/
+	static bool load(const std::string& imageFilename, uint64_t imageHash, const TextureArray& textureArray, unsigned char* layerData);
+
+	/** \brief Writes layer data to cache file of the image, replacing the previous one.
+	*   \param imageFilename Path to the image
+	*   \param imageHash     Hash of the image file content
+	*   \param textureArray  Texture array the layer is for, gives format, size and number of levels
+	*   \param layerData     textureArray.getLayerDataSize() bytes of layer data
+	*   \return True if the cache file has been written or false otherwise.
+	*/
+	static bool save(const std::string& imageFilename, uint64_t imageHash, const TextureArray& textureArray, const unsigned char* layerData);
+};
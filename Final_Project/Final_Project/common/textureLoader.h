@@ -0,0 +1,87 @@
+#pragma once
+
+// STL
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "textureArray.h"
+#include "textureStreamer.h"
+#include "threadPool.h"
+
+/**
+  Loads image files into texture array layers. Decoding, resampling and block compression run concurrently on worker threads,
+  large JPEGs are split across the threads too.
+  Block-compressed layers are cached on disk (see TextureCache), later loads read them instead of decoding the images.
+  Images are uploaded either by the calling thread (which owns the OpenGL context) as soon as they're ready,
+  or, when loading asynchronously, by texture streamer over the next frames.
+*/
+class TextureLoader
+{
+public:
+	/** Time spent in each loading stage of the last load, in milliseconds. */
+	struct Timings
+	{
+		unsigned int numThreads = 0; //! Number of decoding threads
+		int numImages = 0; //! Number of loaded images
+		int numFailedImages = 0; //! Number of images, which failed to load
+		int numCacheHits = 0; //! Number of block-compressed layers read from the cache
+		double decodeMilliseconds = 0.0; //! Image decoding (or hashing and reading the cache), summed over all threads
+		double resampleMilliseconds = 0.0; //! Resampling to layer size, summed over all threads
+		double compressMilliseconds = 0.0; //! Block compression of all mipmap levels, summed over all threads
+		double uploadMilliseconds = 0.0; //! Uploading to the GPU on the calling thread (synchronous load only)
+		double waitMilliseconds = 0.0; //! Calling thread waiting for decoded images (synchronous load only)
+		double totalMilliseconds = 0.0; //! Whole load, until the last image has been decoded (and uploaded)
+	};
+
+	/** \brief Starts decoding threads.
+	*   \param numThreads Number of threads, 0 means one per hardware thread
+	*/
+	explicit TextureLoader(unsigned int numThreads = 0);
+
+	/** \brief Loads images into consecutive free layers of texture array, in the order of file names.
+	*   \param textureArray Created texture array with enough free layers
+	*   \param filenames    Paths to the images
+	*   \param layers       Receives layer index of every image (-1 for images, which failed to load)
+	*   \return True if all images have been loaded or false otherwise.
+	*/
+	bool loadLayers(TextureArray& textureArray, const std::vector<std::string>& filenames, std::vector<int>& layers);
+
+	/** \brief Reserves layers and starts decoding images into them, without waiting for anything.
+	*   Layers are decoded straight into staging buffers of the streamer, which uploads them as its update() is called.
+	*   \param textureArray Created texture array with enough free layers, must outlive the load
+	*   \param filenames    Paths to the images
+	*   \param layers       Receives layer index of every image (its content arrives once decoded and streamed)
+	*   \param streamer     Streamer uploading decoded layers, must outlive the load
+	*   \return True if the layers have been reserved and loading started or false otherwise.
+	*/
+	bool loadLayersAsync(TextureArray& textureArray, const std::vector<std::string>& filenames, std::vector<int>& layers, TextureStreamer& streamer);
+
+	/** \brief Loads images as layer data in the format of texture array, without uploading them (e.g. to bake an asset pack).
+	*   \param textureArray Created texture array, gives format and size of the layers
+	*   \param filenames    Paths to the images
+	*   \param layerData    Receives layer data of every image (empty for images, which failed to load)
+	*   \return True if all images have been loaded or false otherwise.
+	*/
+	bool encodeLayers(const TextureArray& textureArray, const std::vector<std::string>& filenames, std::vector<std::vector<unsigned char>>& layerData);
+
+	/** \brief Cancels loading: drops images waiting for a thread and waits for the ones being decoded. Images waiting
+	*   for a staging buffer give up. Call it before destroying texture array or streamer of asynchronous load.
+	*/
+	void cancel();
+
+	/** \brief Checks, if some images of asynchronous load are still being decoded. */
+	bool isLoading() const;
+
+	/** \brief Gets stage timings of the last load (asynchronous load updates them as images are decoded). */
+	Timings getLastTimings() const;
+
+private:
+	mutable std::mutex _timingsMutex; //! Guards timings and number of loading images
+	Timings _timings; //! Timings of the last load
+	int _numLoadingImages = 0; //! Images of asynchronous load, which aren't decoded yet
+	TextureStreamer* _streamer = nullptr; //! Streamer of the last asynchronous load, guarded by timings mutex
+	std::atomic<bool> _isCancelling{ false }; //! Set while cancelling, images given up by running jobs aren't reported as errors
+	ThreadPool _threadPool; //! Threads decoding images, declared last to finish their jobs before other members are destroyed
+};
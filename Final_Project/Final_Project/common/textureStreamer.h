@@ -0,0 +1,118 @@
+#pragma once
+
+// STL
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <glad\glad.h>
+
+#include "textureArray.h"
+
+/**
+  Streams texture array layers to the GPU through a pool of persistently mapped pixel buffer objects.
+  Worker threads acquire a staging buffer, decode or resample the layer straight into it and queue it;
+  update(), called once per frame on the thread owning the OpenGL context, issues glTexSubImage3D from
+  the queued buffers, so the driver copies the data asynchronously. Every buffer is guarded by a fence
+  and is handed out again only after the GPU has consumed it, so the render loop never waits for an upload.
+*/
+class TextureStreamer
+{
+public:
+	/** Upload counts and time spent streaming. */
+	struct Statistics
+	{
+		int numUploadedLayers = 0; //! Layers whose upload has been issued
+		int numResidentLayers = 0; //! Layers whose upload the GPU has finished
+		int numStagingWaits = 0; //! Times a worker had to wait for a free staging buffer
+		size_t numUploadedBytes = 0; //! Bytes uploaded from staging buffers
+		double updateMilliseconds = 0.0; //! CPU time spent in update()
+	};
+
+	/** \brief Creates pool of persistently mapped pixel buffer objects.
+	*   \param bufferSize Size of every buffer, in bytes (at least one layer)
+	*   \param numBuffers Number of buffers, i.e. maximal number of layers being written or uploaded at once
+	*   \return True if successful or false otherwise.
+	*/
+	bool create(size_t bufferSize, int numBuffers);
+
+	/** \brief Waits for a free staging buffer (can be called from any thread).
+	*   \return Mapped memory of getBufferSize() bytes to write the layer into, or nullptr if the streamer is destroyed
+	*   or acquiring is cancelled.
+	*/
+	unsigned char* acquireStagingBuffer();
+
+	/** \brief Makes workers waiting for a staging buffer, and all later acquires, give up, so that loads can be cancelled
+	*   while update() isn't called anymore. Acquired buffers stay valid until destroy(), acquiring resumes after create().
+	*/
+	void cancelAcquires();
+
+	/** \brief Queues filled staging buffer for upload (can be called from any thread).
+	*   \param textureArray  Texture array, which must outlive the upload
+	*   \param layer         Index of reserved layer
+	*   \param stagingBuffer Buffer returned by acquireStagingBuffer, holding layer data (see TextureArray::uploadLayer)
+	*/
+	void queueStagedLayer(TextureArray& textureArray, int layer, unsigned char* stagingBuffer);
+
+	/** \brief Returns staging buffer without uploading it, e.g. when decoding has failed (can be called from any thread).
+	*   \param stagingBuffer Buffer returned by acquireStagingBuffer
+	*/
+	void releaseStagingBuffer(unsigned char* stagingBuffer);
+
+	/** \brief Retires finished uploads and issues new ones. Call once per frame on the OpenGL context thread.
+	*   \param maxUploads Maximal number of layers uploaded during this call
+	*/
+	void update(int maxUploads = 2);
+
+	/** \brief Gets size of every staging buffer, in bytes. */
+	size_t getBufferSize() const;
+
+	/** \brief Gets number of layers being written, queued or in flight. */
+	int getNumPendingLayers() const;
+
+	/** \brief Gets upload statistics since creation. */
+	Statistics getStatistics() const;
+
+	/** \brief Deletes all buffers and fences, dropping queued layers and waking up waiting workers. */
+	void destroy();
+
+private:
+	/** Stage of a staging buffer. */
+	enum class BufferState
+	{
+		Free, //! Can be acquired
+		Writing, //! Acquired by a worker
+		Queued, //! Filled, waiting for upload
+		InFlight //! Upload issued, waiting for fence
+	};
+
+	/** Persistently mapped pixel buffer object. */
+	struct StagingBuffer
+	{
+		GLuint bufferID = 0;
+		unsigned char* mapped = nullptr; //! Persistent mapping of the whole buffer
+		BufferState state = BufferState::Free;
+		GLsync fence = nullptr; //! Fence of upload in flight
+		TextureArray* textureArray = nullptr; //! Target of queued upload
+		int layer = 0; //! Target layer of queued upload
+	};
+
+	/** \brief Finds staging buffer by its mapped memory, must be called with mutex locked. */
+	StagingBuffer* findBuffer(const unsigned char* mapped);
+
+	/** \brief Checks fences of uploads in flight and frees buffers, which are consumed by the GPU. */
+	void retireFinishedUploads();
+
+	std::vector<StagingBuffer> _buffers; //! Pool of staging buffers
+	size_t _bufferSize = 0; //! Size of every staging buffer, in bytes
+
+	mutable std::mutex _mutex; //! Guards buffer states, queue and statistics
+	std::condition_variable _bufferFreed; //! Signalled when a buffer becomes free or the streamer is destroyed
+	std::deque<StagingBuffer*> _queuedBuffers; //! Filled buffers in upload order
+
+	Statistics _statistics; //! Statistics since creation
+
+	bool _isCreated = false;
+	bool _isAcquireCancelled = false; //! Set by cancelAcquires, acquireStagingBuffer returns nullptr then
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+// STL
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+  Fixed number of worker threads executing queued jobs in FIFO order.
+  Jobs must not touch OpenGL, the context is current only on the main thread.
+*/
+class ThreadPool
+{
+public:
+	/** \brief Starts worker threads.
+	*   \param numThreads Number of workers, 0 means one per hardware thread
+	*/
+	explicit ThreadPool(unsigned int numThreads = 0);
+
+	/** \brief Finishes queued jobs and joins worker threads. */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/** \brief Queues job to be executed by one of the workers.
+	*   \param job Job to execute
+	*/
+	void enqueue(std::function<void()> job);
+
+	/** \brief Blocks until all queued jobs are finished. */
+	void waitIdle();
+
+	/** \brief Drops queued jobs and blocks until the running ones are finished. Jobs queued meanwhile (e.g. by
+	*   running jobs) are dropped too, parallelFor stays correct as its calling thread takes the indices of dropped helpers.
+	*   \return Number of dropped jobs.
+	*/
+	size_t cancel();
+
+	/** \brief Calls body for every index in [0, count) and returns once all calls are finished.
+	*   The calling thread takes indices too, workers help as they become free, so jobs may call it as well.
+	*   \param count Number of indices
+	*   \param body  Called with every index, possibly on several threads at once
+	*/
+	void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+	/** \brief Gets number of worker threads. */
+	unsigned int getNumThreads() const;
+
+private:
+	/** \brief Executes jobs until the pool is stopped. */
+	void workerLoop();
+
+	std::vector<std::thread> _workers; //! Worker threads
+	std::deque<std::function<void()>> _jobs; //! Jobs waiting for a worker
+	std::mutex _mutex; //! Guards jobs, number of busy workers and stop flag
+	std::condition_variable _jobQueued; //! Signalled when job is queued or pool is stopped
+	std::condition_variable _jobFinished; //! Signalled when worker finishes a job
+	unsigned int _numBusyWorkers = 0; //! Workers executing a job right now
+
+	bool _isStopping = false;
+	bool _isCancelling = false; //! Set while cancel waits for running jobs, jobs queued meanwhile are dropped
+};
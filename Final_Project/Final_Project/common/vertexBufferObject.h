@@ -1,21 +1,34 @@
 #pragma once
 
 // STL
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
 #include <vector>
 
 #include <glad\glad.h>
 
 /**
   Wraps OpenGL's vertex buffer object to a higher level class.
+  Besides static data gathered in memory and uploaded once, it can be a streaming buffer for data written every frame
+  (dynamic vertices, instance transforms, uniforms): its immutable storage stays mapped for its whole lifetime and is split
+  into frame regions, each guarded by a fence, so the CPU writes one region while the GPU still reads the previous ones.
 */
 
 class VertexBufferObject
 {
 public:
 	/** \brief Creates a new VBO, with optional reserved buffer size.
-	*   \param size Buffer size reservation, in bytes (so that memory allocations don't take place while adding data)
+	*   \param reserveSizeBytes Buffer size reservation, in bytes (so that memory allocations don't take place while adding data)
 	*/
-	void createVBO(uint32_t reserveSizeBytes = 0);
+	void createVBO(size_t reserveSizeBytes = 0);
+
+	/** \brief Reserves in-memory buffer for data to be added, so that it doesn't grow while adding them.
+	*   \param reserveSizeBytes Buffer size reservation, in bytes
+	*/
+	void reserveRawData(size_t reserveSizeBytes);
 
 	/** \brief Binds this vertex buffer object (makes current).
 	*   \param bufferType Type of the bound buffer (usually GL_ARRAY_BUFFER, but can be also GL_ELEMENT_BUFFER for instance)
@@ -23,77 +36,212 @@ public:
 	void bindVBO(GLenum bufferType = GL_ARRAY_BUFFER);
 
 	/** \brief Adds raw data to the in-memory buffer, before they get uploaded.
-	*   \param ptrData  Pointer to the raw data (arbitrary type)
-	*   \param dataSize Size of the added data (in bytes)
-	*   \param repeat How many times to repeat same data in the buffer (default is 1)
+	*   \param ptrData       Pointer to the raw data (arbitrary type), must not point into this buffer
+	*   \param dataSizeBytes Size of the added data (in bytes)
+	*   \param repeat        How many times to repeat same data in the buffer (default is 1)
 	*/
-	void addRawData(const void* ptrData, uint32_t dataSizeBytes, int repeat = 1);
+	void addRawData(const void* ptrData, size_t dataSizeBytes, size_t repeat = 1);
 
 	/** \brief Adds arbitrary data to the in-memory buffer, before they get uploaded.
-	*   \param ptrData Data to be added
-	*   \param repeat  How many times to repeat same data in the buffer (default is 1)
+	*   \param obj    Data to be added
+	*   \param repeat How many times to repeat same data in the buffer (default is 1)
 	*/
 	template<typename T>
-	void addData(const T& obj, int repeat = 1)
+	void addData(const T& obj, size_t repeat = 1)
 	{
 		addRawData(&obj, sizeof(T), repeat);
 	}
 
+	/** \brief Adds contiguous array of elements to the in-memory buffer in one copy.
+	*   \param ptrData Pointer to the first element
+	*   \param count   Number of elements
+	*/
+	template<typename T>
+	void addDataArray(const T* ptrData, size_t count)
+	{
+		addRawData(ptrData, sizeof(T) * count);
+	}
+
+	/** \brief Adds range of elements (e.g. of a container) to the in-memory buffer, growing it only once.
+	*   \param first Forward iterator to the first element
+	*   \param last  Iterator past the last element
+	*/
+	template<typename ForwardIterator>
+	void addDataRange(ForwardIterator first, ForwardIterator last)
+	{
+		using T = typename std::iterator_traits<ForwardIterator>::value_type;
+		auto destination = static_cast<unsigned char*>(appendRawData(sizeof(T) * static_cast<size_t>(std::distance(first, last))));
+		for (; first != last; ++first, destination += sizeof(T))
+		{
+			const T element = *first;
+			std::memcpy(destination, &element, sizeof(T));
+		}
+	}
+
+	/** \brief Takes over vector of elements as the in-memory buffer, without copying them.
+	*   If some data have been added already, the elements are copied after them instead.
+	*   \param data Vector to take over, empty afterwards
+	*/
+	template<typename T>
+	void adoptData(std::vector<T>&& data)
+	{
+		if (getRawDataSize() > 0)
+		{
+			addDataArray(data.data(), data.size());
+			data.clear();
+			return;
+		}
+
+		// Type-erased owner keeps the vector's memory alive until the data are uploaded
+		auto adopted = std::make_shared<std::vector<T>>(std::move(data));
+		_adoptedData = adopted->data();
+		_adoptedDataSize = sizeof(T) * adopted->size();
+		_adoptedDataOwner = std::move(adopted);
+	}
+
 	/** \brief Gets pointer to the data from in-memory buffer (only before uploading them).
 	*   \return Pointer to the raw data.
 	*/
 	void* getRawDataPointer();
 
+	/** \brief Gets size of the data in in-memory buffer, that haven't been uploaded yet.
+	*   \return Size in bytes.
+	*/
+	size_t getRawDataSize() const;
+
 	/** \brief Uploads gathered data to the GPU memory. Now the VBO is ready to be used.
 	*   \param usageHint Hint for OpenGL, how is the data intended to be used (GL_STATIC_DRAW, GL_DYNAMIC_DRAW)
 	*/
 	void uploadDataToGPU(GLenum usageHint);
 
-	void* mapBufferToMemory(GLenum usageHint) const;
+	/** \brief Uploads data straight from given memory (e.g. memory-mapped file), bypassing the in-memory buffer.
+	*   \param ptrData   Pointer to the raw data
+	*   \param dataSize  Size of the data (in bytes)
+	*   \param usageHint Hint for OpenGL, how is the data intended to be used (GL_STATIC_DRAW, GL_DYNAMIC_DRAW)
+	*/
+	void uploadDataToGPU(const void* ptrData, size_t dataSize, GLenum usageHint);
+
+	/** \brief Creates a streaming buffer with persistently mapped storage, split into frame regions written one after another.
+	*   Writing a region needs no map / unmap calls and never synchronizes implicitly, it waits only if the GPU still reads the region.
+	*   \param regionSizeBytes Size of the data written every frame, in bytes
+	*   \param numRegions      Number of frame regions (3 for triple buffering)
+	*   \param bufferType      Type of the buffer (GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER...)
+	*   \return True if successful or false otherwise.
+	*/
+	bool createStreamingVBO(size_t regionSizeBytes, size_t numRegions = 3, GLenum bufferType = GL_ARRAY_BUFFER);
 
-	void* mapSubBufferToMemory(GLenum usageHint, size_t offset, size_t length) const;
+	/** \brief Moves to the next frame region of streaming buffer, waiting for its fence if the GPU hasn't finished reading it yet.
+	*   \return Pointer to the mapped region, to be written until endFrameRegion, or nullptr, if the buffer is not streaming.
+	*/
+	void* beginFrameRegion();
 
-	void unmapBuffer() const;
+	//* \brief Fences current frame region, call it after issuing all commands reading the region.
+	void endFrameRegion();
 
-	GLuint getBufferID() const;
+	/** \brief Binds current frame region to indexed binding point of uniform or shader storage blocks.
+	*   \param bindingPoint Binding point, as declared in shaders with layout(binding = ...)
+	*/
+	void bindFrameRegion(GLuint bindingPoint) const;
 
-	/** \brief Maps buffer data to a memory pointer.
-	*   \param usageHint Hint for OpenGL, how is the data intended to be used (GL_STATIC_DRAW, GL_DYNAMIC_DRAW)
+	/** \brief Gets byte offset of current frame region in the buffer (for vertex attribute offsets or glBindVertexBuffer).
+	*   \return Offset in bytes.
+	*/
+	size_t getFrameRegionOffset() const;
+
+	/** \brief Gets size of one frame region, aligned so that every region can be bound as a uniform block.
+	*   \return Size in bytes.
+	*/
+	size_t getFrameRegionSize() const;
+
+	/** \brief Gets how many times beginFrameRegion had to wait for the GPU (the CPU got more frames ahead than there are regions).
+	*   \return Number of waits.
+	*/
+	size_t getNumFenceWaits() const;
+
+	/** \brief Checks, if the buffer has been created as streaming buffer. */
+	bool isStreaming() const;
+
+	/** \brief Maps buffer data to a memory pointer (streaming buffer is mapped already, so it just returns its storage).
+	*   \param usageHint Access to the mapped data (GL_READ_ONLY, GL_WRITE_ONLY, GL_READ_WRITE)
 	*   \return Pointer to the mapped data, or nullptr, if something fails.
 	*/
-	void* mapBufferToMemory(GLenum usageHint);
+	void* mapBufferToMemory(GLenum usageHint) const;
 
-	/** \brief Maps buffer sub-data to a memory pointer.
-	*   \param  usageHint Hint for OpenGL, how is the data intended to be used (GL_READ_ONLY, GL_WRITE_ONLY...`)
+	/** \brief Maps buffer sub-data to a memory pointer (streaming buffer is mapped already, so it just returns part of its storage).
+	*   \param  usageHint Access bits of the mapping (GL_MAP_READ_BIT, GL_MAP_WRITE_BIT...)
 	*   \param  offset    Byte offset in buffer, where to start
 	*   \param  length    Byte length of the mapped data
 	*   \return Pointer to the mapped data, or nullptr, if something fails.
 	*/
-	void* mapSubBufferToMemory(GLenum usageHint, uint32_t offset, uint32_t length);
+	void* mapSubBufferToMemory(GLenum usageHint, size_t offset, size_t length) const;
 
-	//* \brief Unmaps buffer (must have been mapped previously).
-	void unmapBuffer();
+	//* \brief Unmaps buffer (must have been mapped previously), streaming buffer stays mapped until it's deleted.
+	void unmapBuffer() const;
 
 	/** \brief Gets OpenGL-assigned buffer ID.
 	*   \return Buffer ID.
 	*/
-	GLuint getBufferID();
+	GLuint getBufferID() const;
 
-	/** \brief Gets buffer size, in bytes.
+	/** \brief Gets buffer size, in bytes (of the uploaded data, or of the data gathered so far before uploading).
 	*   \return Buffer size in bytes.
 	*/
-	uint32_t getBufferSize();
+	size_t getBufferSize() const;
 
 	//* \brief Deletes VBO and frees memory and internal structures.
 	void deleteVBO();
 
 private:
-	GLuint _bufferID = 0; //! OpenGL assigned buffer ID
-	int _bufferType; //! Buffer type (GL_ARRAY_BUFFER, GL_ELEMENT_BUFFER...)
+	/** Allocator default-initializing elements constructed without value, so growing the in-memory buffer doesn't zero
+	*   the bytes, which the caller of appendRawData writes right away (each added byte is written only once).
+	*/
+	template<typename T>
+	struct DefaultInitAllocator : std::allocator<T>
+	{
+		template<typename U>
+		struct rebind
+		{
+			using other = DefaultInitAllocator<U>;
+		};
+
+		using std::allocator<T>::allocator;
+
+		template<typename U>
+		void construct(U* ptr)
+		{
+			::new(static_cast<void*>(ptr)) U;
+		}
+
+		template<typename U, typename... Args>
+		void construct(U* ptr, Args&&... args)
+		{
+			::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+		}
+	};
+
+	/** \brief Grows the in-memory buffer, moving adopted data into it first.
+	*   \param dataSizeBytes Number of bytes to append
+	*   \return Pointer to the appended bytes, to be written by the caller.
+	*/
+	void* appendRawData(size_t dataSizeBytes);
+
+	/** \brief Empties the in-memory buffer, keeping its capacity, and releases adopted data. */
+	void clearRawData();
 
-	std::vector<unsigned char> _rawData; //! In-memory raw data buffer, used to gather the data for VBO.
-	size_t _bytesAdded = 0; //! Number of bytes added to the buffer so far
-	uint32_t _uploadedDataSize; //! Holds buffer data size after uploading to GPU
+	GLuint _bufferID = 0; //! OpenGL assigned buffer ID
+	GLenum _bufferType = GL_ARRAY_BUFFER; //! Buffer type (GL_ARRAY_BUFFER, GL_ELEMENT_BUFFER...)
+
+	std::vector<unsigned char, DefaultInitAllocator<unsigned char>> _rawData; //! In-memory raw data buffer, used to gather the data for VBO, its size is the number of bytes added so far
+	std::shared_ptr<void> _adoptedDataOwner; //! Vector taken over by adoptData, used instead of _rawData while set
+	void* _adoptedData = nullptr; //! Elements of the adopted vector
+	size_t _adoptedDataSize = 0; //! Size of the adopted elements, in bytes
+	size_t _uploadedDataSize = 0; //! Holds buffer data size after uploading to GPU
+
+	unsigned char* _streamingData = nullptr; //! Persistently mapped storage of streaming buffer
+	std::vector<GLsync> _regionFences; //! Fence of every frame region, placed after the commands reading it, nullptr if not fenced
+	size_t _regionSize = 0; //! Aligned size of one frame region, in bytes
+	size_t _currentRegion = 0; //! Index of the frame region being written
+	size_t _numFenceWaits = 0; //! How many times writing a region had to wait for the GPU
 
 	bool _isBufferCreated = false;
 	bool _isDataUploaded = false; //! Flag telling, if data has been uploaded to GPU already.
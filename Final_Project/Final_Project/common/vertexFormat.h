@@ -0,0 +1,144 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include <glad\glad.h>
+
+namespace static_meshes_3D {
+
+/** Arrangement of vertex attributes in the vertex buffer. */
+enum class VertexLayout
+{
+	Planar, //!< All positions, then all texture coordinates, then all normals, one tightly packed stream per attribute
+	Interleaved //!< Position, texture coordinate and normal of every vertex next to each other, one stream for all
+};
+
+/** Encoding of vertex positions in the buffer. */
+enum class PositionEncoding
+{
+	Float, //!< 3 floats, 12 bytes
+	Half, //!< 3 half floats relative to the center of mesh bounds, 8 bytes (padded)
+	Snorm16 //!< 3 normalized shorts over mesh bounds, 8 bytes (padded)
+};
+
+/** Encoding of vertex normals in the buffer. */
+enum class NormalEncoding
+{
+	Float, //!< 3 floats, 12 bytes
+	Packed //!< 3 normalized 10-bit components of GL_INT_2_10_10_10_REV, 4 bytes
+};
+
+/** Encoding of texture coordinates in the buffer. */
+enum class TexCoordEncoding
+{
+	Float, //!< 2 floats, 8 bytes
+	Half, //!< 2 half floats, 4 bytes
+	Unorm16 //!< 2 normalized unsigned shorts, 4 bytes, only for coordinates within [0, 1] (others fall back to Half)
+};
+
+/** Encodings of vertex attributes, chosen per mesh. Integer encodings are dequantized by vertex fetch for free. */
+struct VertexEncoding
+{
+	PositionEncoding positions = PositionEncoding::Float;
+	NormalEncoding normals = NormalEncoding::Float;
+	TexCoordEncoding texCoords = TexCoordEncoding::Float;
+
+	/** \brief  Gets the most compact encoding, 16 bytes per vertex with all attributes instead of 32. */
+	static VertexEncoding compact();
+};
+
+/**
+	Describes vertex attributes of a mesh and how they lie in its vertex buffer. The same descriptor packs generated
+	vertex data for upload, unpacks them back and sets attribute pointers, so that these three always agree.
+*/
+class VertexFormat
+{
+public:
+	/** One attribute stored in the vertex buffer. */
+	struct Attribute
+	{
+		int index; //!< Vertex attribute index
+		GLint numComponents; //!< Number of components of the attribute (3 for vec3)
+		GLenum type; //!< Type of the components in the buffer (GL_FLOAT)
+		GLboolean normalized; //!< Whether integer components are normalized to [0, 1] or [-1, 1]
+		GLsizei byteSize; //!< Size of one attribute value, in bytes
+		size_t vertexOffset; //!< Offset of the attribute within an interleaved vertex, in bytes
+	};
+
+	VertexFormat(bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout = VertexLayout::Planar,
+		const VertexEncoding& encoding = VertexEncoding());
+
+	/** \brief  Gets arrangement of the attributes in the buffer. */
+	VertexLayout getLayout() const;
+
+	/** \brief  Gets encodings of the attributes (texture coordinates may have fallen back to Half while packing). */
+	const VertexEncoding& getEncoding() const;
+
+	/** \brief  Gets transform of positions, as fetched by vertex shader, back to mesh space (identity for float positions).
+	*   Quantized meshes are drawn with model matrix multiplied by it, its scale is uniform, so normal matrices stay valid.
+	*   \return Dequantization matrix.
+	*/
+	glm::mat4 getPositionDequantization() const;
+
+	/** \brief  Gets byte size of one vertex, with all of its attributes. */
+	GLsizei getVertexByteSize() const;
+
+	/** \brief  Gets stored attributes, in the order of positions, texture coordinates and normals. */
+	const std::vector<Attribute>& getAttributes() const;
+
+	/** \brief  Calculates byte offset of the first value of the attribute in the buffer.
+	*   \param attribute   One of the attributes of this format
+	*   \param numVertices Number of vertices in the buffer (planar streams follow each other)
+	*   \return Offset in bytes.
+	*/
+	size_t getAttributeOffset(const Attribute& attribute, size_t numVertices) const;
+
+	/** \brief  Gets byte distance between values of the attribute of two consecutive vertices. */
+	GLsizei getAttributeStride(const Attribute& attribute) const;
+
+	/** \brief  Packs vertex data to the buffer layout. Data of attributes, which the format doesn't have, are ignored.
+	*   Quantization of the mesh (its bounds) is chosen from the data here, so attribute pointers must be set afterwards.
+	*   \param numVertices Number of vertices
+	*   \param positions   Vertex positions
+	*   \param texCoords   Vertex texture coordinates
+	*   \param normals     Vertex normals
+	*   \return Buffer data, ready for upload.
+	*/
+	std::vector<unsigned char> packVertices(size_t numVertices, const glm::vec3* positions, const glm::vec2* texCoords, const glm::vec3* normals);
+
+	/** \brief  Unpacks vertex data from the buffer layout. Missing attributes are filled with zeros.
+	*   \param data        Buffer data, as produced by packVertices
+	*   \param numVertices Number of vertices
+	*   \param positions   Vertex positions
+	*   \param texCoords   Vertex texture coordinates
+	*   \param normals     Vertex normals
+	*/
+	void unpackVertices(const unsigned char* data, size_t numVertices, std::vector<glm::vec3>& positions, std::vector<glm::vec2>& texCoords, std::vector<glm::vec3>& normals) const;
+
+	/** \brief  Enables attributes and sets their pointers in currently bound VAO, to currently bound GL_ARRAY_BUFFER.
+	*   \param numVertices Number of vertices in the buffer
+	*/
+	void setupAttributePointers(size_t numVertices) const;
+
+private:
+	/** \brief  Builds stored attributes from their encodings. */
+	void buildAttributes();
+
+	bool _hasPositions; //!< Flag telling, if vertices have positions
+	bool _hasTextureCoordinates; //!< Flag telling, if vertices have texture coordinates
+	bool _hasNormals; //!< Flag telling, if vertices have normals
+	VertexLayout _layout; //!< Arrangement of the attributes
+	VertexEncoding _encoding; //!< Encodings of the attributes
+	std::vector<Attribute> _attributes; //!< Stored attributes
+	GLsizei _vertexByteSize = 0; //!< Byte size of one vertex
+
+	glm::vec3 _positionCenter = glm::vec3(0.0f); //!< Center of mesh bounds, quantized positions are relative to it
+	float _positionScale = 1.0f; //!< Largest half-size of mesh bounds, snorm16 positions are divided by it
+};
+
+} // namespace static_meshes_3D
@@ -7,13 +7,15 @@
 
 // Project
 #include "cylinder.h"
+#include "common/gpuObjectCounter.h"
 
 
 
 namespace static_meshes_3D {
 
-	Cylinder::Cylinder(float radius, int numSlices, float height, bool withPositions, bool withTextureCoordinates, bool withNormals)
-		: StaticMesh3D(withPositions, withTextureCoordinates, withNormals)
+	Cylinder::Cylinder(float radius, int numSlices, float height, bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout,
+		const VertexEncoding& encoding)
+		: StaticMesh3D(withPositions, withTextureCoordinates, withNormals, layout, encoding)
 		, _radius(radius)
 		, _numSlices(numSlices)
 		, _height(height)
@@ -48,9 +50,9 @@ namespace static_meshes_3D {
 		_numVerticesTotal = _numVerticesSide + _numVerticesTopBottom * 2;
 
 		// Generate VAO and VBO for vertex attributes
-		glGenVertexArrays(1, &_vao);
+		GpuObjectCounter::genVertexArrays(1, &_vao);
 		glBindVertexArray(_vao);
-		_vbo.createVBO(getVertexByteSize() * _numVerticesTotal);
+		_vbo.createVBO();
 
 		// Pre-calculate sines / cosines for given number of slices
 		const auto sliceAngleStep = 2.0f * glm::pi<float>() / float(_numSlices);
@@ -65,6 +67,11 @@ namespace static_meshes_3D {
 			currentSliceAngle += sliceAngleStep;
 		}
 
+		// Attributes are gathered first, vertex format then packs them into the VBO in its layout
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> texCoords;
+		std::vector<glm::vec3> normals;
+
 		if (hasPositions())
 		{
 			// Pre-calculate X and Z coordinates
@@ -76,31 +83,25 @@ namespace static_meshes_3D {
 				z.push_back(sines[i] * _radius);
 			}
 
+			positions.reserve(_numVerticesTotal);
+
 			// Add cylinder side vertices
 			for (auto i = 0; i <= _numSlices; i++)
 			{
-				const auto topPosition = glm::vec3(x[i], _height / 2.0f, z[i]);
-				const auto bottomPosition = glm::vec3(x[i], -_height / 2.0f, z[i]);
-				_vbo.addRawData(&topPosition, sizeof(glm::vec3));
-				_vbo.addRawData(&bottomPosition, sizeof(glm::vec3));
+				positions.push_back(glm::vec3(x[i], _height / 2.0f, z[i]));
+				positions.push_back(glm::vec3(x[i], -_height / 2.0f, z[i]));
 			}
 
 			// Add top cylinder cover
-			glm::vec3 topCenterPosition(0.0f, _height / 2.0f, 0.0f);
-			_vbo.addRawData(&topCenterPosition, sizeof(glm::vec3));
-			for (auto i = 0; i <= _numSlices; i++)
-			{
-				const auto topPosition = glm::vec3(x[i], _height / 2.0f, z[i]);
-				_vbo.addRawData(&topPosition, sizeof(glm::vec3));
+			positions.push_back(glm::vec3(0.0f, _height / 2.0f, 0.0f));
+			for (auto i = 0; i <= _numSlices; i++) {
+				positions.push_back(glm::vec3(x[i], _height / 2.0f, z[i]));
 			}
 
 			// Add bottom cylinder cover
-			glm::vec3 bottomCenterPosition(0.0f, -_height / 2.0f, 0.0f);
-			_vbo.addRawData(&bottomCenterPosition, sizeof(glm::vec3));
-			for (auto i = 0; i <= _numSlices; i++)
-			{
-				const auto bottomPosition = glm::vec3(x[i], -_height / 2.0f, -z[i]);
-				_vbo.addRawData(&bottomPosition, sizeof(glm::vec3));
+			positions.push_back(glm::vec3(0.0f, -_height / 2.0f, 0.0f));
+			for (auto i = 0; i <= _numSlices; i++) {
+				positions.push_back(glm::vec3(x[i], -_height / 2.0f, -z[i]));
 			}
 		}
 
@@ -110,11 +111,13 @@ namespace static_meshes_3D {
 			// I have decided to map the texture twice around cylinder, looks fine
 			const auto sliceTextureStepU = 2.0f / float(_numSlices);
 
+			texCoords.reserve(_numVerticesTotal);
+
 			auto currentSliceTexCoordU = 0.0f;
 			for (auto i = 0; i <= _numSlices; i++)
 			{
-				_vbo.addData(glm::vec2(currentSliceTexCoordU, 1.0f));
-				_vbo.addData(glm::vec2(currentSliceTexCoordU, 0.0f));
+				texCoords.push_back(glm::vec2(currentSliceTexCoordU, 1.0f));
+				texCoords.push_back(glm::vec2(currentSliceTexCoordU, 0.0f));
 
 				// Update texture coordinate of current slice 
 				currentSliceTexCoordU += sliceTextureStepU;
@@ -122,35 +125,34 @@ namespace static_meshes_3D {
 
 			// Generate circle texture coordinates for cylinder top cover
 			glm::vec2 topBottomCenterTexCoord(0.5f, 0.5f);
-			_vbo.addData(topBottomCenterTexCoord);
+			texCoords.push_back(topBottomCenterTexCoord);
 			for (auto i = 0; i <= _numSlices; i++) {
-				_vbo.addData(glm::vec2(topBottomCenterTexCoord.x + sines[i] * 0.5f, topBottomCenterTexCoord.y + cosines[i] * 0.5f));
+				texCoords.push_back(glm::vec2(topBottomCenterTexCoord.x + sines[i] * 0.5f, topBottomCenterTexCoord.y + cosines[i] * 0.5f));
 			}
 
 			// Generate circle texture coordinates for cylinder bottom cover
-			_vbo.addData(topBottomCenterTexCoord);
+			texCoords.push_back(topBottomCenterTexCoord);
 			for (auto i = 0; i <= _numSlices; i++) {
-				_vbo.addData(glm::vec2(topBottomCenterTexCoord.x + sines[i] * 0.5f, topBottomCenterTexCoord.y - cosines[i] * 0.5f));
+				texCoords.push_back(glm::vec2(topBottomCenterTexCoord.x + sines[i] * 0.5f, topBottomCenterTexCoord.y - cosines[i] * 0.5f));
 			}
 		}
 
 		if (hasNormals())
 		{
+			normals.reserve(_numVerticesTotal);
 			for (auto i = 0; i <= _numSlices; i++) {
-				_vbo.addData(glm::vec3(cosines[i], 0.0f, sines[i]), 2);
+				normals.insert(normals.end(), 2, glm::vec3(cosines[i], 0.0f, sines[i]));
 			}
 
 			// Add normal for every vertex of cylinder top cover
-			_vbo.addData(glm::vec3(0.0f, 1.0f, 0.0f), _numVerticesTopBottom);
+			normals.insert(normals.end(), _numVerticesTopBottom, glm::vec3(0.0f, 1.0f, 0.0f));
 
 			// Add normal for every vertex of cylinder bottom cover
-			_vbo.addData(glm::vec3(0.0f, -1.0f, 0.0f), _numVerticesTopBottom);
+			normals.insert(normals.end(), _numVerticesTopBottom, glm::vec3(0.0f, -1.0f, 0.0f));
 		}
 
 		// Finally upload data to the GPU
-		_vbo.bindVBO();
-		_vbo.uploadDataToGPU(GL_STATIC_DRAW);
-		setVertexAttributesPointers(_numVerticesTotal);
+		uploadVertexData(_numVerticesTotal, positions, texCoords, normals);
 
 		_isInitialized = true;
 	}
@@ -173,6 +175,15 @@ namespace static_meshes_3D {
 		glDrawArrays(GL_TRIANGLE_FAN, _numVerticesSide + _numVerticesTopBottom, _numVerticesTopBottom);
 	}
 
+	std::vector<StaticMesh3D::DrawRange> Cylinder::getDrawRanges() const
+	{
+		return {
+			{ GL_TRIANGLE_STRIP, 0, _numVerticesSide },
+			{ GL_TRIANGLE_FAN, _numVerticesSide, _numVerticesTopBottom },
+			{ GL_TRIANGLE_FAN, _numVerticesSide + _numVerticesTopBottom, _numVerticesTopBottom }
+		};
+	}
+
 	void Cylinder::renderPoints() const
 	{
 		if (!_isInitialized) {
@@ -184,6 +195,22 @@ namespace static_meshes_3D {
 		glDrawArrays(GL_POINTS, 0, _numVerticesTotal);
 	}
 
+	void Cylinder::renderInstanced(GLsizei numInstances) const
+	{
+		if (!_isInitialized) {
+			return;
+		}
+
+		// Render cylinder side first
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, _numVerticesSide, numInstances);
+
+		// Render top cover
+		glDrawArraysInstanced(GL_TRIANGLE_FAN, _numVerticesSide, _numVerticesTopBottom, numInstances);
+
+		// Render bottom cover
+		glDrawArraysInstanced(GL_TRIANGLE_FAN, _numVerticesSide + _numVerticesTopBottom, _numVerticesTopBottom, numInstances);
+	}
+
 
 
 } // namespace static_meshes_3D
\ No newline at end of file
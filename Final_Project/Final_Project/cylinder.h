@@ -10,10 +10,13 @@ namespace static_meshes_3D {
 	{
 	public:
 		Cylinder(float radius, int numSlices, float height,
-			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true);
+			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, VertexLayout layout = VertexLayout::Planar,
+			const VertexEncoding& encoding = VertexEncoding());
 
 		void render() const override;
 		void renderPoints() const override;
+		void renderInstanced(GLsizei numInstances) const override;
+		std::vector<DrawRange> getDrawRanges() const override;
 
 		/**
 		 * Gets cylinder radius.
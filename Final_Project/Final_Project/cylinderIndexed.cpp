@@ -0,0 +1,180 @@
+// STL
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+// Project
+#include "cylinderIndexed.h"
+#include "common/gpuObjectCounter.h"
+
+
+
+namespace static_meshes_3D {
+
+	namespace {
+
+		// Adds convex polygon as one strip zig-zagging between both ends of its rim (0, 1, n-1, 2, n-2...),
+		// so it keeps winding of a fan around the rim, but needs no center vertex
+		void addPolygonStrip(std::vector<GLuint>& indices, GLuint firstVertex, int numVertices)
+		{
+			indices.push_back(firstVertex);
+			for (auto low = 1, high = numVertices - 1; low <= high; )
+			{
+				indices.push_back(firstVertex + low++);
+				if (low <= high) {
+					indices.push_back(firstVertex + high--);
+				}
+			}
+		}
+
+	} // namespace
+
+	CylinderIndexed::CylinderIndexed(float radius, int numSlices, float height, bool withPositions, bool withTextureCoordinates, bool withNormals,
+		VertexLayout layout, const VertexEncoding& encoding)
+		: CylinderIndexed(radius, numSlices, height, true, withPositions, withTextureCoordinates, withNormals, layout, encoding) {}
+
+	CylinderIndexed::CylinderIndexed(float radius, int numSlices, float height, bool withCovers,
+		bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout, const VertexEncoding& encoding)
+		: StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals, layout, encoding)
+		, _radius(radius)
+		, _numSlices(numSlices)
+		, _height(height)
+		, _withCovers(withCovers)
+	{
+		initializeData();
+	}
+
+	float CylinderIndexed::getRadius() const
+	{
+		return _radius;
+	}
+
+	int CylinderIndexed::getSlices() const
+	{
+		return _numSlices;
+	}
+
+	float CylinderIndexed::getHeight() const
+	{
+		return _height;
+	}
+
+	bool CylinderIndexed::hasCovers() const
+	{
+		return _withCovers;
+	}
+
+	void CylinderIndexed::initializeData()
+	{
+		if (_isInitialized) {
+			return;
+		}
+
+		// Side needs duplicated seam (its texture coordinates differ), covers only one vertex per slice
+		const auto numVerticesSide = (_numSlices + 1) * 2;
+		const auto numVerticesCover = _withCovers ? _numSlices : 0;
+		_numVertices = numVerticesSide + numVerticesCover * 2;
+		_primitiveRestartIndex = _numVertices;
+
+		// Generate VAO and VBO for vertex attributes
+		GpuObjectCounter::genVertexArrays(1, &_vao);
+		glBindVertexArray(_vao);
+		_vbo.createVBO();
+
+		// Pre-calculate sines / cosines for given number of slices
+		const auto sliceAngleStep = 2.0f * glm::pi<float>() / float(_numSlices);
+		auto currentSliceAngle = 0.0f;
+		std::vector<float> sines, cosines;
+		for (auto i = 0; i <= _numSlices; i++)
+		{
+			sines.push_back(sin(currentSliceAngle));
+			cosines.push_back(cos(currentSliceAngle));
+
+			// Update slice angle
+			currentSliceAngle += sliceAngleStep;
+		}
+
+		// Attributes are gathered first, vertex format then packs them into the VBO in its layout
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> texCoords;
+		std::vector<glm::vec3> normals;
+
+		if (hasPositions())
+		{
+			positions.reserve(_numVertices);
+
+			// Add cylinder side vertices
+			for (auto i = 0; i <= _numSlices; i++)
+			{
+				positions.push_back(glm::vec3(cosines[i] * _radius, _height / 2.0f, sines[i] * _radius));
+				positions.push_back(glm::vec3(cosines[i] * _radius, -_height / 2.0f, sines[i] * _radius));
+			}
+
+			// Add rims of top and bottom covers (bottom one is mirrored, so that it faces down)
+			for (auto i = 0; i < numVerticesCover; i++) {
+				positions.push_back(glm::vec3(cosines[i] * _radius, _height / 2.0f, sines[i] * _radius));
+			}
+
+			for (auto i = 0; i < numVerticesCover; i++) {
+				positions.push_back(glm::vec3(cosines[i] * _radius, -_height / 2.0f, -sines[i] * _radius));
+			}
+		}
+
+		if (hasTextureCoordinates())
+		{
+			// Texture is mapped twice around cylinder, same as with non-indexed cylinder
+			const auto sliceTextureStepU = 2.0f / float(_numSlices);
+
+			texCoords.reserve(_numVertices);
+			for (auto i = 0; i <= _numSlices; i++)
+			{
+				texCoords.push_back(glm::vec2(sliceTextureStepU * i, 1.0f));
+				texCoords.push_back(glm::vec2(sliceTextureStepU * i, 0.0f));
+			}
+
+			// Generate circle texture coordinates for cylinder top and bottom covers
+			for (auto i = 0; i < numVerticesCover; i++) {
+				texCoords.push_back(glm::vec2(0.5f + sines[i] * 0.5f, 0.5f + cosines[i] * 0.5f));
+			}
+
+			for (auto i = 0; i < numVerticesCover; i++) {
+				texCoords.push_back(glm::vec2(0.5f + sines[i] * 0.5f, 0.5f - cosines[i] * 0.5f));
+			}
+		}
+
+		if (hasNormals())
+		{
+			normals.reserve(_numVertices);
+			for (auto i = 0; i <= _numSlices; i++) {
+				normals.insert(normals.end(), 2, glm::vec3(cosines[i], 0.0f, sines[i]));
+			}
+
+			normals.insert(normals.end(), numVerticesCover, glm::vec3(0.0f, 1.0f, 0.0f));
+			normals.insert(normals.end(), numVerticesCover, glm::vec3(0.0f, -1.0f, 0.0f));
+		}
+
+		uploadVertexData(_numVertices, positions, texCoords, normals);
+
+		// Side strip, then cover strips, each of them after primitive restart
+		std::vector<GLuint> indices;
+		indices.reserve(numVerticesSide + (numVerticesCover + 1) * 2);
+		for (auto i = 0; i < numVerticesSide; i++) {
+			indices.push_back(i);
+		}
+
+		if (_withCovers)
+		{
+			indices.push_back(_primitiveRestartIndex);
+			addPolygonStrip(indices, numVerticesSide, numVerticesCover);
+			indices.push_back(_primitiveRestartIndex);
+			addPolygonStrip(indices, numVerticesSide + numVerticesCover, numVerticesCover);
+		}
+
+		uploadIndexData(GL_TRIANGLE_STRIP, std::move(indices));
+
+		_isInitialized = true;
+	}
+
+} // namespace static_meshes_3D
@@ -0,0 +1,54 @@
+#pragma once
+#include "common/staticMeshIndexed3D.h"
+
+namespace static_meshes_3D {
+
+	/**
+	* Cylinder static mesh with given radius, number of slices and height, rendered with indices.
+	* Side and both covers are strips separated by primitive restart, so the whole cylinder is one draw call.
+	* Covers are zig-zag strips over their rim, without center vertex.
+	*/
+	class CylinderIndexed : public StaticMeshIndexed3D
+	{
+	public:
+		CylinderIndexed(float radius, int numSlices, float height,
+			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, VertexLayout layout = VertexLayout::Planar,
+			const VertexEncoding& encoding = VertexEncoding());
+
+		/**
+		 * Gets cylinder radius.
+		 */
+		float getRadius() const;
+
+		/**
+		 * Gets number of cylinder slices.
+		 */
+		int getSlices() const;
+
+		/**
+		 * Gets cylinder height.
+		 */
+		float getHeight() const;
+
+		/**
+		 * Checks, if cylinder has top and bottom covers.
+		 */
+		bool hasCovers() const;
+
+	protected:
+		/**
+		 * Constructs cylinder with or without covers (tube has none).
+		 */
+		CylinderIndexed(float radius, int numSlices, float height, bool withCovers,
+			bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout, const VertexEncoding& encoding);
+
+	private:
+		float _radius; // Cylinder radius (distance from the center of cylinder to surface)
+		int _numSlices; // Number of cylinder slices
+		float _height; // Height of the cylinder
+		bool _withCovers; // Whether top and bottom covers are generated
+
+		void initializeData() override;
+	};
+
+} // namespace static_meshes_3D
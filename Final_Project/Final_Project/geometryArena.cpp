@@ -0,0 +1,229 @@
+// STL
+#include <iostream>
+#include <cstddef>
+
+// Project
+#include "common/geometryArena.h"
+
+const int GeometryArena::POSITION_ATTRIBUTE_INDEX           = 0;
+const int GeometryArena::NORMAL_ATTRIBUTE_INDEX             = 1;
+const int GeometryArena::TEXTURE_COORDINATE_ATTRIBUTE_INDEX = 2;
+
+GeometryArena::MeshRange GeometryArena::addMesh(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices)
+{
+	if (_isUploaded)
+	{
+		std::cerr << "Geometry arena is already uploaded! Meshes must be added before calling upload!" << std::endl;
+		return MeshRange();
+	}
+
+	MeshRange range;
+	range.firstIndex = static_cast<GLuint>(_numIndices);
+	range.indexCount = static_cast<GLuint>(indices.size());
+	range.baseVertex = static_cast<GLint>(_numVertices);
+
+	_vertices.insert(_vertices.end(), vertices.begin(), vertices.end());
+	_indices.insert(_indices.end(), indices.begin(), indices.end());
+	_numVertices += static_cast<int>(vertices.size());
+	_numIndices += static_cast<int>(indices.size());
+	return range;
+}
+
+GeometryArena::MeshRange GeometryArena::addTriangles(const GLfloat* vertices, size_t numVertices)
+{
+	std::vector<Vertex> meshVertices(numVertices);
+	std::vector<GLuint> indices(numVertices);
+	for (size_t i = 0; i < numVertices; i++)
+	{
+		const auto vertex = vertices + i * 8;
+		meshVertices[i].position = glm::vec3(vertex[0], vertex[1], vertex[2]);
+		meshVertices[i].normal = glm::vec3(vertex[3], vertex[4], vertex[5]);
+		meshVertices[i].texCoord = glm::vec2(vertex[6], vertex[7]);
+		indices[i] = static_cast<GLuint>(i);
+	}
+
+	return addMesh(meshVertices, indices);
+}
+
+GeometryArena::MeshRange GeometryArena::addMesh(const static_meshes_3D::StaticMesh3D& mesh)
+{
+	// Indexed meshes have no draw ranges, their indices are converted instead
+	if (const auto indexedMesh = dynamic_cast<const static_meshes_3D::StaticMeshIndexed3D*>(&mesh)) {
+		return addMesh(*indexedMesh);
+	}
+
+	const auto vertices = readVertices(mesh);
+
+	// Convert every draw range to triangle list
+	std::vector<GLuint> indices;
+	for (const auto& range : mesh.getDrawRanges())
+	{
+		const auto first = static_cast<GLuint>(range.first);
+		for (GLsizei i = 0; i + 2 < range.count; i++)
+		{
+			if (range.mode == GL_TRIANGLES)
+			{
+				if (i % 3 != 0) {
+					continue;
+				}
+				indices.insert(indices.end(), { first + i, first + i + 1, first + i + 2 });
+			}
+			else if (range.mode == GL_TRIANGLE_STRIP)
+			{
+				// Every other triangle of a strip has reversed winding
+				if (i % 2 == 0) {
+					indices.insert(indices.end(), { first + i, first + i + 1, first + i + 2 });
+				}
+				else {
+					indices.insert(indices.end(), { first + i + 1, first + i, first + i + 2 });
+				}
+			}
+			else if (range.mode == GL_TRIANGLE_FAN) {
+				indices.insert(indices.end(), { first, first + i + 1, first + i + 2 });
+			}
+			else
+			{
+				std::cerr << "Geometry arena doesn't support primitive type " << range.mode << "!" << std::endl;
+				break;
+			}
+		}
+	}
+
+	optimizeTriangles(vertices, indices);
+	return addMesh(vertices, indices);
+}
+
+GeometryArena::MeshRange GeometryArena::addMesh(const static_meshes_3D::StaticMeshIndexed3D& mesh)
+{
+	if (mesh.getPrimitiveType() != GL_TRIANGLES && mesh.getPrimitiveType() != GL_TRIANGLE_STRIP)
+	{
+		std::cerr << "Geometry arena doesn't support primitive type " << mesh.getPrimitiveType() << "!" << std::endl;
+		return addMesh(readVertices(mesh), std::vector<GLuint>());
+	}
+
+	const auto vertices = readVertices(mesh);
+	std::vector<GLuint> indices;
+	mesh.readTriangleIndices(indices);
+	optimizeTriangles(vertices, indices);
+	return addMesh(vertices, indices);
+}
+
+std::vector<GeometryArena::Vertex> GeometryArena::readVertices(const static_meshes_3D::StaticMesh3D& mesh)
+{
+	std::vector<glm::vec3> positions, normals;
+	std::vector<glm::vec2> texCoords;
+	mesh.readVertexData(positions, texCoords, normals);
+
+	std::vector<Vertex> vertices(positions.size());
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		vertices[i].position = positions[i];
+		vertices[i].normal = normals[i];
+		vertices[i].texCoord = texCoords[i];
+	}
+
+	return vertices;
+}
+
+void GeometryArena::optimizeTriangles(const std::vector<Vertex>& vertices, std::vector<GLuint>& indices)
+{
+	if (indices.empty()) {
+		return;
+	}
+
+	// Arena draws triangle lists only, so unlike strips of the source mesh they always gain from the reordering
+	std::vector<glm::vec3> positions(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++) {
+		positions[i] = vertices[i].position;
+	}
+
+	MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertices.size());
+	MeshOptimizer::optimizeOverdraw(indices.data(), indices.size(), positions.data(), vertices.size());
+}
+
+bool GeometryArena::upload()
+{
+	if (!upload(_vertices.data(), _vertices.size(), _indices.data(), _indices.size())) {
+		return false;
+	}
+
+	// Data live on the GPU now
+	std::vector<Vertex>().swap(_vertices);
+	std::vector<GLuint>().swap(_indices);
+	return true;
+}
+
+bool GeometryArena::upload(const Vertex* vertices, size_t numVertices, const GLuint* indices, size_t numIndices)
+{
+	if (_isUploaded)
+	{
+		std::cerr << "Geometry arena is already uploaded! You need to destroy it before uploading again!" << std::endl;
+		return false;
+	}
+
+	if (numVertices == 0 || numIndices == 0)
+	{
+		std::cerr << "Geometry arena is empty, there's nothing to upload!" << std::endl;
+		return false;
+	}
+
+	// Buffers are filled right from the given memory, there's no in-memory copy
+	_vbo.createVBO();
+	_vbo.bindVBO();
+	_vbo.uploadDataToGPU(vertices, sizeof(Vertex) * numVertices, GL_STATIC_DRAW);
+
+	_ibo.createVBO();
+	_ibo.bindVBO(GL_ELEMENT_ARRAY_BUFFER);
+	_ibo.uploadDataToGPU(indices, sizeof(GLuint) * numIndices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	_numVertices = static_cast<int>(numVertices);
+	_numIndices = static_cast<int>(numIndices);
+	std::cout << "Uploaded geometry arena with " << _numVertices << " vertices and " << _numIndices << " indices" << std::endl;
+	_isUploaded = true;
+	return true;
+}
+
+const std::vector<GeometryArena::Vertex>& GeometryArena::getVertices() const
+{
+	return _vertices;
+}
+
+const std::vector<GLuint>& GeometryArena::getIndices() const
+{
+	return _indices;
+}
+
+void GeometryArena::setupVertexAttributes() const
+{
+	glBindBuffer(GL_ARRAY_BUFFER, _vbo.getBufferID());
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo.getBufferID());
+
+	glEnableVertexAttribArray(POSITION_ATTRIBUTE_INDEX);
+	glVertexAttribPointer(POSITION_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+	glEnableVertexAttribArray(NORMAL_ATTRIBUTE_INDEX);
+	glVertexAttribPointer(NORMAL_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
+	glEnableVertexAttribArray(TEXTURE_COORDINATE_ATTRIBUTE_INDEX);
+	glVertexAttribPointer(TEXTURE_COORDINATE_ATTRIBUTE_INDEX, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, texCoord)));
+}
+
+int GeometryArena::getNumVertices() const
+{
+	return _numVertices;
+}
+
+int GeometryArena::getNumIndices() const
+{
+	return _numIndices;
+}
+
+void GeometryArena::destroy()
+{
+	_vbo.deleteVBO();
+	_ibo.deleteVBO();
+	_vertices.clear();
+	_indices.clear();
+	_numVertices = 0;
+	_numIndices = 0;
+	_isUploaded = false;
+}
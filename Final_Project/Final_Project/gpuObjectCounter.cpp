@@ -0,0 +1,67 @@
+// Project
+#include "common/gpuObjectCounter.h"
+
+std::atomic<int> GpuObjectCounter::_numBuffers(0);
+std::atomic<int> GpuObjectCounter::_numVertexArrays(0);
+std::atomic<int> GpuObjectCounter::_numTextures(0);
+
+void GpuObjectCounter::genBuffers(GLsizei count, GLuint* buffers)
+{
+	glGenBuffers(count, buffers);
+	_numBuffers += count;
+}
+
+void GpuObjectCounter::deleteBuffers(GLsizei count, const GLuint* buffers)
+{
+	_numBuffers -= countNames(count, buffers);
+	glDeleteBuffers(count, buffers);
+}
+
+void GpuObjectCounter::genVertexArrays(GLsizei count, GLuint* arrays)
+{
+	glGenVertexArrays(count, arrays);
+	_numVertexArrays += count;
+}
+
+void GpuObjectCounter::deleteVertexArrays(GLsizei count, const GLuint* arrays)
+{
+	_numVertexArrays -= countNames(count, arrays);
+	glDeleteVertexArrays(count, arrays);
+}
+
+void GpuObjectCounter::genTextures(GLsizei count, GLuint* textures)
+{
+	glGenTextures(count, textures);
+	_numTextures += count;
+}
+
+void GpuObjectCounter::deleteTextures(GLsizei count, const GLuint* textures)
+{
+	_numTextures -= countNames(count, textures);
+	glDeleteTextures(count, textures);
+}
+
+int GpuObjectCounter::getNumBuffers()
+{
+	return _numBuffers;
+}
+
+int GpuObjectCounter::getNumVertexArrays()
+{
+	return _numVertexArrays;
+}
+
+int GpuObjectCounter::getNumTextures()
+{
+	return _numTextures;
+}
+
+int GpuObjectCounter::countNames(GLsizei count, const GLuint* names)
+{
+	auto result = 0;
+	for (GLsizei i = 0; i < count; i++) {
+		result += names[i] != 0 ? 1 : 0;
+	}
+
+	return result;
+}
@@ -0,0 +1,221 @@
+// STL
+#include <algorithm>
+#include <iostream>
+
+// Project
+#include "common/indirectDrawList.h"
+#include "common/gpuObjectCounter.h"
+
+const int IndirectDrawList::DRAW_INDEX_ATTRIBUTE_INDEX = 11;
+
+void IndirectDrawList::addDraw(const GeometryArena::MeshRange& mesh, GLuint textureLayer, const ObjectTransform& transform, float shininess, const glm::vec2& uvScale)
+{
+	_draws.push_back(PendingDraw{ mesh, static_cast<GLuint>(_objects.size()), 1 });
+	addObject(transform.getModel(), transform.getNormalMatrix(), shininess, textureLayer, uvScale);
+}
+
+void IndirectDrawList::addInstancedDraw(const GeometryArena::MeshRange& mesh, GLuint textureLayer, const std::vector<glm::mat4>& modelMatrices, float shininess)
+{
+	if (modelMatrices.empty()) {
+		return;
+	}
+
+	std::vector<glm::mat3> normalMatrices(modelMatrices.size());
+	ObjectTransform::computeNormalMatrices(modelMatrices.data(), normalMatrices.data(), modelMatrices.size());
+
+	_draws.push_back(PendingDraw{ mesh, static_cast<GLuint>(_objects.size()), static_cast<GLuint>(modelMatrices.size()) });
+	for (size_t i = 0; i < modelMatrices.size(); i++) {
+		addObject(modelMatrices[i], normalMatrices[i], shininess, textureLayer);
+	}
+}
+
+void IndirectDrawList::addLodDraw(const LodMesh& mesh, GLuint textureLayer, const ObjectTransform& transform, float shininess)
+{
+	if (mesh.levels.empty()) {
+		return;
+	}
+
+	_lodMeshes.push_back(mesh);
+	_lodObjects.push_back(LodObject{ _lodMeshes.size() - 1, static_cast<GLuint>(_objects.size()), static_cast<GLuint>(_draws.size()), -1 });
+	addDraw(mesh.levels[0], textureLayer, transform, shininess);
+}
+
+void IndirectDrawList::addLodInstancedDraw(const LodMesh& mesh, GLuint textureLayer, const std::vector<glm::mat4>& modelMatrices, float shininess)
+{
+	if (mesh.levels.empty() || modelMatrices.empty()) {
+		return;
+	}
+
+	std::vector<glm::mat3> normalMatrices(modelMatrices.size());
+	ObjectTransform::computeNormalMatrices(modelMatrices.data(), normalMatrices.data(), modelMatrices.size());
+
+	_lodMeshes.push_back(mesh);
+	for (size_t i = 0; i < modelMatrices.size(); i++)
+	{
+		_lodObjects.push_back(LodObject{ _lodMeshes.size() - 1, static_cast<GLuint>(_objects.size()), static_cast<GLuint>(_draws.size()), -1 });
+		_draws.push_back(PendingDraw{ mesh.levels[0], static_cast<GLuint>(_objects.size()), 1 });
+		addObject(modelMatrices[i], normalMatrices[i], shininess, textureLayer);
+	}
+}
+
+bool IndirectDrawList::build(const GeometryArena& arena)
+{
+	if (_isBuilt)
+	{
+		std::cerr << "This draw list is already built! You need to destroy it before building it again!" << std::endl;
+		return false;
+	}
+
+	if (_draws.empty())
+	{
+		std::cerr << "Draw list is empty, there's nothing to build!" << std::endl;
+		return false;
+	}
+
+	_commands.clear();
+	for (const auto& draw : _draws)
+	{
+		DrawElementsIndirectCommand command;
+		command.count = draw.mesh.indexCount;
+		command.instanceCount = draw.numObjects;
+		command.firstIndex = draw.mesh.firstIndex;
+		command.baseVertex = draw.mesh.baseVertex;
+		command.baseInstance = draw.firstObject;
+		_commands.push_back(command);
+	}
+	_numCommands = static_cast<int>(_commands.size());
+
+	// VAO combining arena vertices with object index attribute
+	GpuObjectCounter::genVertexArrays(1, &_vao);
+	glBindVertexArray(_vao);
+	arena.setupVertexAttributes();
+
+	std::vector<GLuint> drawIndices(_objects.size());
+	for (size_t i = 0; i < drawIndices.size(); i++) {
+		drawIndices[i] = static_cast<GLuint>(i);
+	}
+
+	// Draw index buffer takes over the vector built here, so it needs no reservation
+	_drawIndexBuffer.createVBO();
+	_drawIndexBuffer.bindVBO();
+	_drawIndexBuffer.adoptData(std::move(drawIndices));
+	_drawIndexBuffer.uploadDataToGPU(GL_STATIC_DRAW);
+	glEnableVertexAttribArray(DRAW_INDEX_ATTRIBUTE_INDEX);
+	glVertexAttribIPointer(DRAW_INDEX_ATTRIBUTE_INDEX, 1, GL_UNSIGNED_INT, sizeof(GLuint), reinterpret_cast<void*>(0));
+	glVertexAttribDivisor(DRAW_INDEX_ATTRIBUTE_INDEX, 1);
+	glBindVertexArray(0);
+
+	// Commands stay in memory for level of detail updates, which rewrite some of them
+	_commandsBuffer.createVBO();
+	_commandsBuffer.bindVBO(GL_DRAW_INDIRECT_BUFFER);
+	_commandsBuffer.uploadDataToGPU(_commands.data(), sizeof(DrawElementsIndirectCommand) * _commands.size(),
+		_lodObjects.empty() ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	_objectsBuffer.createSSBO(sizeof(ObjectData) * _objects.size(), GL_STATIC_DRAW);
+	_objectsBuffer.setData(_objects.data(), sizeof(ObjectData) * _objects.size());
+
+	std::cout << "Built indirect draw list with " << _numCommands << " commands for " << _objects.size() << " objects" << std::endl;
+	_isBuilt = true;
+	return true;
+}
+
+void IndirectDrawList::render(GLuint objectsBindingPoint) const
+{
+	if (!_isBuilt) {
+		return;
+	}
+
+	glBindVertexArray(_vao);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandsBuffer.getBufferID());
+	_objectsBuffer.bindBufferBase(objectsBindingPoint);
+
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, _numCommands, 0);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+int IndirectDrawList::updateLevels(const glm::vec3& viewPosition, const glm::mat4& projection, float viewportHeight)
+{
+	if (!_isBuilt || _lodObjects.empty()) {
+		return 0;
+	}
+
+	// Hysteresis keeps levels steady, so commands are rewritten only in frames when some object crosses a switch size
+	auto numChanged = 0;
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandsBuffer.getBufferID());
+	for (auto& lodObject : _lodObjects)
+	{
+		const auto& lodMesh = _lodMeshes[lodObject.lodMesh];
+		const auto screenSize = LodSelector::getScreenSize(_objects[lodObject.object].model, lodMesh.boundingRadius, viewPosition, projection, viewportHeight);
+		const auto level = std::min(lodMesh.selector.selectLevel(screenSize, lodObject.level), static_cast<int>(lodMesh.levels.size()) - 1);
+		if (level == lodObject.level) {
+			continue;
+		}
+
+		lodObject.level = level;
+		auto& command = _commands[lodObject.command];
+		command.count = lodMesh.levels[level].indexCount;
+		command.firstIndex = lodMesh.levels[level].firstIndex;
+		command.baseVertex = lodMesh.levels[level].baseVertex;
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * lodObject.command, sizeof(DrawElementsIndirectCommand), &command);
+		numChanged++;
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	return numChanged;
+}
+
+size_t IndirectDrawList::getNumDrawnIndices() const
+{
+	size_t result = 0;
+	for (const auto& command : _commands) {
+		result += size_t(command.count) * command.instanceCount;
+	}
+
+	return result;
+}
+
+int IndirectDrawList::getNumCommands() const
+{
+	return _numCommands;
+}
+
+int IndirectDrawList::getNumObjects() const
+{
+	return static_cast<int>(_objects.size());
+}
+
+void IndirectDrawList::destroy()
+{
+	if (_isBuilt)
+	{
+		GpuObjectCounter::deleteVertexArrays(1, &_vao);
+		_vao = 0;
+		_commandsBuffer.deleteVBO();
+		_drawIndexBuffer.deleteVBO();
+		_objectsBuffer.deleteSSBO();
+	}
+
+	_draws.clear();
+	_objects.clear();
+	_lodMeshes.clear();
+	_lodObjects.clear();
+	_commands.clear();
+	_numCommands = 0;
+	_isBuilt = false;
+}
+
+void IndirectDrawList::addObject(const glm::mat4& model, const glm::mat3& normalMatrix, float shininess, GLuint textureLayer, const glm::vec2& uvScale)
+{
+	ObjectData object = {};
+	object.model = model;
+	for (int i = 0; i < 3; i++) {
+		object.normalMatrix[i] = glm::vec4(normalMatrix[i], 0.0f);
+	}
+	object.shininess = shininess;
+	object.textureLayer = textureLayer;
+	object.uvScale = uvScale;
+	_objects.push_back(object);
+}
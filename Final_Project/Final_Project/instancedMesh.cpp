@@ -0,0 +1,137 @@
+// STL
+#include <iostream>
+#include <cstddef>
+
+// Project
+#include "common/instancedMesh.h"
+#include "common/gpuObjectCounter.h"
+#include "common/objectTransform.h"
+
+namespace static_meshes_3D {
+
+const int InstancedMesh::INSTANCE_MODEL_ATTRIBUTE_INDEX    = 3;
+const int InstancedMesh::INSTANCE_MATERIAL_ATTRIBUTE_INDEX = 7;
+const int InstancedMesh::INSTANCE_NORMAL_MATRIX_ATTRIBUTE_INDEX = 8;
+const GLuint InstancedMesh::MATERIAL_LAYER = 0xFFFFFFFF;
+
+InstancedMesh::InstancedMesh(std::shared_ptr<const StaticMesh3D> mesh)
+    : _mesh(std::move(mesh)) {}
+
+InstancedMesh::~InstancedMesh()
+{
+    deleteInstances();
+}
+
+void InstancedMesh::setInstances(const std::vector<glm::mat4>& modelMatrices, const std::vector<GLuint>& materialIndices)
+{
+    if (!materialIndices.empty() && materialIndices.size() != modelMatrices.size())
+    {
+        std::cerr << "Number of instance material indices (" << materialIndices.size() << ") doesn't match number of instances (" << modelMatrices.size() << ")!" << std::endl;
+        return;
+    }
+
+    if (!_isInitialized)
+    {
+        // Own VAO, so that the same mesh can be instanced several times with different data
+        GpuObjectCounter::genVertexArrays(1, &_vao);
+        glBindVertexArray(_vao);
+        _mesh->setupVertexAttributes();
+
+        _instancesVBO.createVBO();
+        _instancesVBO.bindVBO();
+
+        // Model matrix takes 4 consecutive attributes, one per column
+        for (int i = 0; i < 4; i++)
+        {
+            const auto attributeIndex = INSTANCE_MODEL_ATTRIBUTE_INDEX + i;
+            glEnableVertexAttribArray(attributeIndex);
+            glVertexAttribPointer(attributeIndex, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), reinterpret_cast<void*>(sizeof(glm::vec4) * i));
+            glVertexAttribDivisor(attributeIndex, 1);
+        }
+
+        // Normal matrix takes 3 consecutive attributes, one per column
+        for (int i = 0; i < 3; i++)
+        {
+            const auto attributeIndex = INSTANCE_NORMAL_MATRIX_ATTRIBUTE_INDEX + i;
+            glEnableVertexAttribArray(attributeIndex);
+            glVertexAttribPointer(attributeIndex, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), reinterpret_cast<void*>(offsetof(InstanceData, normalMatrix) + sizeof(glm::vec3) * i));
+            glVertexAttribDivisor(attributeIndex, 1);
+        }
+
+        // Material index is an integer attribute, so it reaches the shader unconverted
+        glEnableVertexAttribArray(INSTANCE_MATERIAL_ATTRIBUTE_INDEX);
+        glVertexAttribIPointer(INSTANCE_MATERIAL_ATTRIBUTE_INDEX, 1, GL_UNSIGNED_INT, sizeof(InstanceData), reinterpret_cast<void*>(offsetof(InstanceData, materialIndex)));
+        glVertexAttribDivisor(INSTANCE_MATERIAL_ATTRIBUTE_INDEX, 1);
+
+        _isInitialized = true;
+    }
+
+    std::vector<glm::mat3> normalMatrices(modelMatrices.size());
+    ObjectTransform::computeNormalMatrices(modelMatrices.data(), normalMatrices.data(), modelMatrices.size());
+
+    // Quantized positions of the mesh are brought back to mesh space by instance matrices (normals are not quantized that way)
+    const auto dequantization = _mesh->getVertexFormat().getPositionDequantization();
+
+    // Instances are built in place and handed over to the VBO without another copy
+    std::vector<InstanceData> instances(modelMatrices.size());
+    for (size_t i = 0; i < modelMatrices.size(); i++)
+    {
+        instances[i].model = modelMatrices[i] * dequantization;
+        instances[i].normalMatrix = normalMatrices[i];
+        instances[i].materialIndex = materialIndices.empty() ? MATERIAL_LAYER : materialIndices[i];
+    }
+    _instancesVBO.adoptData(std::move(instances));
+
+    _instancesVBO.bindVBO();
+    _instancesVBO.uploadDataToGPU(GL_STATIC_DRAW);
+    _numInstances = static_cast<int>(modelMatrices.size());
+    _modelMatrices = modelMatrices;
+
+    glBindVertexArray(0);
+}
+
+void InstancedMesh::render() const
+{
+    if (!_isInitialized || _numInstances == 0) {
+        return;
+    }
+
+    glBindVertexArray(_vao);
+    _mesh->renderInstanced(_numInstances);
+}
+
+int InstancedMesh::getNumInstances() const
+{
+    return _numInstances;
+}
+
+const std::vector<glm::mat4>& InstancedMesh::getModelMatrices() const
+{
+    return _modelMatrices;
+}
+
+const StaticMesh3D& InstancedMesh::getMesh() const
+{
+    return *_mesh;
+}
+
+GLuint InstancedMesh::getVAO() const
+{
+    return _vao;
+}
+
+void InstancedMesh::deleteInstances()
+{
+    if (!_isInitialized) {
+        return;
+    }
+
+    GpuObjectCounter::deleteVertexArrays(1, &_vao);
+    _instancesVBO.deleteVBO();
+    _numInstances = 0;
+    _modelMatrices.clear();
+
+    _isInitialized = false;
+}
+
+} // namespace static_meshes_3D
@@ -0,0 +1,71 @@
+// STL
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+// GLM
+#include <glm/gtc/constants.hpp>
+
+// Project
+#include "common/lodSelector.h"
+
+const float LodSelector::DEFAULT_HYSTERESIS = 0.15f;
+const float LodSelector::DEFAULT_MAX_EDGE_PIXELS = 16.0f;
+
+LodSelector::LodSelector(std::vector<float> minScreenSizes, float hysteresis)
+	: _minScreenSizes(std::move(minScreenSizes))
+	, _hysteresis(hysteresis) {}
+
+LodSelector LodSelector::fromSliceCounts(const std::vector<int>& sliceCounts, float maxEdgePixels, float hysteresis)
+{
+	// Level i is needed only while the next coarser level would have longer edges than tolerated
+	std::vector<float> minScreenSizes;
+	for (size_t i = 1; i < sliceCounts.size(); i++) {
+		minScreenSizes.push_back(float(sliceCounts[i]) * maxEdgePixels / glm::pi<float>());
+	}
+
+	return LodSelector(std::move(minScreenSizes), hysteresis);
+}
+
+float LodSelector::getScreenSize(const glm::mat4& model, float radius, const glm::vec3& viewPosition, const glm::mat4& projection, float viewportHeight)
+{
+	const glm::vec3 center(model[3]);
+	const auto scale = std::max(std::max(glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1]))), glm::length(glm::vec3(model[2])));
+	const auto worldRadius = radius * scale;
+
+	// projection[1][1] maps view space height to NDC, perspective projection also divides it by distance (w = -z)
+	// Distance from camera is used instead of view depth, so that turning the camera alone never switches levels
+	const auto isPerspective = projection[2][3] != 0.0f;
+	const auto distance = glm::length(center - viewPosition);
+	if (isPerspective && distance <= worldRadius) {
+		return std::numeric_limits<float>::max();
+	}
+
+	const auto ndcRadius = worldRadius * projection[1][1] / (isPerspective ? distance : 1.0f);
+	return ndcRadius * viewportHeight;
+}
+
+int LodSelector::getNumLevels() const
+{
+	return static_cast<int>(_minScreenSizes.size()) + 1;
+}
+
+int LodSelector::selectLevel(float screenSize, int currentLevel) const
+{
+	const auto numLevels = getNumLevels();
+	if (currentLevel >= 0 && currentLevel < numLevels)
+	{
+		const auto lowerSize = currentLevel + 1 < numLevels ? _minScreenSizes[currentLevel] * (1.0f - _hysteresis) : 0.0f;
+		const auto upperSize = currentLevel > 0 ? _minScreenSizes[currentLevel - 1] * (1.0f + _hysteresis) : std::numeric_limits<float>::max();
+		if (screenSize >= lowerSize && screenSize < upperSize) {
+			return currentLevel;
+		}
+	}
+
+	auto level = 0;
+	while (level + 1 < numLevels && screenSize < _minScreenSizes[level]) {
+		level++;
+	}
+
+	return level;
+}
\ No newline at end of file
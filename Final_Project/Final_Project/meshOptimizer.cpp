@@ -0,0 +1,310 @@
+// STL
+#include <algorithm>
+#include <numeric>
+
+// Project
+#include "common/meshOptimizer.h"
+
+namespace {
+
+const GLuint UNUSED_VERTEX = ~GLuint(0);
+
+// FIFO post-transform cache, a vertex stays cached until cacheSize other vertices have been transformed after it
+class FifoCache
+{
+public:
+	FifoCache(size_t numVertices, int cacheSize)
+		: _timestamps(numVertices, 0)
+		, _time(cacheSize + 1)
+		, _cacheSize(cacheSize) {}
+
+	// Looks vertex up, transforming it on miss, returns 1 on miss and 0 on hit
+	int access(GLuint vertex)
+	{
+		if (_time - _timestamps[vertex] <= _cacheSize) {
+			return 0;
+		}
+
+		_timestamps[vertex] = _time++;
+		return 1;
+	}
+
+	// Evicts all vertices
+	void flush()
+	{
+		_time += _cacheSize;
+	}
+
+private:
+	std::vector<int> _timestamps; // Time of the last transform of every vertex
+	int _time; // Number of transforms so far, offset so that no vertex is cached initially
+	int _cacheSize;
+};
+
+// Sum of cache misses of triangle's vertices
+int accessTriangle(FifoCache& cache, const GLuint* triangle)
+{
+	return cache.access(triangle[0]) + cache.access(triangle[1]) + cache.access(triangle[2]);
+}
+
+} // namespace
+
+MeshOptimizer::VertexCacheStatistics MeshOptimizer::analyzeVertexCache(const GLuint* indices, size_t numIndices, size_t numVertices, int cacheSize)
+{
+	VertexCacheStatistics result;
+	FifoCache cache(numVertices, cacheSize);
+	std::vector<bool> isReferenced(numVertices, false);
+	size_t numReferenced = 0;
+	for (size_t i = 0; i < numIndices; i++)
+	{
+		result.numTransformedVertices += cache.access(indices[i]);
+		if (!isReferenced[indices[i]])
+		{
+			isReferenced[indices[i]] = true;
+			numReferenced++;
+		}
+	}
+
+	const auto numTriangles = numIndices / 3;
+	result.acmr = numTriangles > 0 ? float(result.numTransformedVertices) / float(numTriangles) : 0.0f;
+	result.atvr = numReferenced > 0 ? float(result.numTransformedVertices) / float(numReferenced) : 0.0f;
+	return result;
+}
+
+void MeshOptimizer::optimizeVertexCache(GLuint* indices, size_t numIndices, size_t numVertices, int cacheSize)
+{
+	const auto numTriangles = numIndices / 3;
+	if (numTriangles == 0 || numVertices == 0) {
+		return;
+	}
+
+	// Triangles around every vertex, all lists in one array
+	std::vector<size_t> adjacencyOffsets(numVertices + 1, 0);
+	for (size_t i = 0; i < numTriangles * 3; i++) {
+		adjacencyOffsets[indices[i] + 1]++;
+	}
+	std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+
+	std::vector<GLuint> adjacency(numTriangles * 3);
+	std::vector<size_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t i = 0; i < numTriangles * 3; i++) {
+		adjacency[adjacencyFill[indices[i]]++] = static_cast<GLuint>(i / 3);
+	}
+
+	std::vector<int> liveTriangles(numVertices);
+	for (size_t v = 0; v < numVertices; v++) {
+		liveTriangles[v] = static_cast<int>(adjacencyOffsets[v + 1] - adjacencyOffsets[v]);
+	}
+
+	std::vector<int> cacheTimes(numVertices, 0);
+	std::vector<bool> isEmitted(numTriangles, false);
+	std::vector<GLuint> deadEnds; // Recently emitted vertices, to continue from when fanning runs out of candidates
+	std::vector<GLuint> candidates;
+	std::vector<GLuint> result;
+	result.reserve(numTriangles * 3);
+	auto time = cacheSize + 1;
+	size_t cursor = 0;
+
+	// Vertex with live triangles from the dead-end stack, or the next one in input order
+	const auto skipDeadEnd = [&]() -> long long
+	{
+		while (!deadEnds.empty())
+		{
+			const auto vertex = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveTriangles[vertex] > 0) {
+				return vertex;
+			}
+		}
+
+		for (; cursor < numVertices; cursor++)
+		{
+			if (liveTriangles[cursor] > 0) {
+				return static_cast<long long>(cursor);
+			}
+		}
+
+		return -1;
+	};
+
+	// Tipsify emits all triangles around a fanning vertex, then continues from one of their vertices
+	long long fanningVertex = 0;
+	while (fanningVertex >= 0)
+	{
+		candidates.clear();
+		for (auto a = adjacencyOffsets[fanningVertex]; a < adjacencyOffsets[fanningVertex + 1]; a++)
+		{
+			const auto triangle = adjacency[a];
+			if (isEmitted[triangle]) {
+				continue;
+			}
+
+			for (auto k = 0; k < 3; k++)
+			{
+				const auto vertex = indices[triangle * 3 + k];
+				result.push_back(vertex);
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				liveTriangles[vertex]--;
+				if (time - cacheTimes[vertex] > cacheSize) {
+					cacheTimes[vertex] = time++;
+				}
+			}
+
+			isEmitted[triangle] = true;
+		}
+
+		// Prefer the oldest candidate, that still stays in cache while fanning around it (emitting at most 2 new vertices per triangle)
+		long long nextVertex = -1;
+		auto bestPriority = -1;
+		for (const auto vertex : candidates)
+		{
+			if (liveTriangles[vertex] <= 0) {
+				continue;
+			}
+
+			auto priority = 0;
+			if (time - cacheTimes[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+				priority = time - cacheTimes[vertex];
+			}
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				nextVertex = vertex;
+			}
+		}
+
+		fanningVertex = nextVertex >= 0 ? nextVertex : skipDeadEnd();
+	}
+
+	std::copy(result.begin(), result.end(), indices);
+}
+
+void MeshOptimizer::optimizeOverdraw(GLuint* indices, size_t numIndices, const glm::vec3* positions, size_t numVertices, float threshold, int cacheSize)
+{
+	const auto numTriangles = numIndices / 3;
+	if (numTriangles == 0) {
+		return;
+	}
+
+	// Hard boundaries are triangles missing all of their vertices, cache optimization has started over there anyway
+	FifoCache cache(numVertices, cacheSize);
+	std::vector<size_t> hardClusters;
+	for (size_t t = 0; t < numTriangles; t++)
+	{
+		if (accessTriangle(cache, indices + t * 3) == 3 || t == 0) {
+			hardClusters.push_back(t);
+		}
+	}
+	hardClusters.push_back(numTriangles);
+
+	// Soft boundaries split hard clusters further, wherever ACMR of the part so far is within threshold of the whole cluster
+	std::vector<size_t> clusters;
+	for (size_t c = 0; c + 1 < hardClusters.size(); c++)
+	{
+		const auto first = hardClusters[c];
+		const auto last = hardClusters[c + 1];
+
+		cache.flush();
+		auto clusterMisses = 0;
+		for (auto t = first; t < last; t++) {
+			clusterMisses += accessTriangle(cache, indices + t * 3);
+		}
+		const auto clusterThreshold = threshold * float(clusterMisses) / float(last - first);
+
+		cache.flush();
+		clusters.push_back(first);
+		auto partFirst = first;
+		auto partMisses = 0;
+		for (auto t = first; t < last; t++)
+		{
+			partMisses += accessTriangle(cache, indices + t * 3);
+			if (t + 1 < last && float(partMisses) / float(t + 1 - partFirst) <= clusterThreshold)
+			{
+				clusters.push_back(t + 1);
+				partFirst = t + 1;
+				partMisses = 0;
+				cache.flush();
+			}
+		}
+	}
+	clusters.push_back(numTriangles);
+
+	// Area weighted centroid and normal of every cluster (triangles are front facing counter-clockwise)
+	const auto numClusters = clusters.size() - 1;
+	std::vector<glm::vec3> clusterCentroids(numClusters, glm::vec3(0.0f));
+	std::vector<glm::vec3> clusterNormals(numClusters, glm::vec3(0.0f));
+	std::vector<float> clusterAreas(numClusters, 0.0f);
+	glm::vec3 meshCentroid(0.0f);
+	auto meshArea = 0.0f;
+	for (size_t c = 0; c < numClusters; c++)
+	{
+		for (auto t = clusters[c]; t < clusters[c + 1]; t++)
+		{
+			const auto& p0 = positions[indices[t * 3]];
+			const auto& p1 = positions[indices[t * 3 + 1]];
+			const auto& p2 = positions[indices[t * 3 + 2]];
+			const auto normal = glm::cross(p1 - p0, p2 - p0);
+			const auto area = glm::length(normal);
+			clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+			clusterNormals[c] += normal;
+			clusterAreas[c] += area;
+		}
+
+		meshCentroid += clusterCentroids[c];
+		meshArea += clusterAreas[c];
+	}
+
+	if (meshArea > 0.0f) {
+		meshCentroid /= meshArea;
+	}
+
+	// Clusters far out from the center, facing away from it, are likely to occlude the rest, they go first
+	std::vector<float> occlusionPotentials(numClusters, 0.0f);
+	for (size_t c = 0; c < numClusters; c++)
+	{
+		const auto normalLength = glm::length(clusterNormals[c]);
+		if (clusterAreas[c] > 0.0f && normalLength > 0.0f) {
+			occlusionPotentials[c] = glm::dot(clusterCentroids[c] / clusterAreas[c] - meshCentroid, clusterNormals[c] / normalLength);
+		}
+	}
+
+	std::vector<size_t> order(numClusters);
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&occlusionPotentials](size_t a, size_t b) {
+		return occlusionPotentials[a] > occlusionPotentials[b];
+	});
+
+	std::vector<GLuint> result;
+	result.reserve(numTriangles * 3);
+	for (const auto c : order) {
+		result.insert(result.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+	}
+
+	std::copy(result.begin(), result.end(), indices);
+}
+
+std::vector<GLuint> MeshOptimizer::optimizeVertexFetch(GLuint* indices, size_t numIndices, size_t numVertices)
+{
+	std::vector<GLuint> remap(numVertices, UNUSED_VERTEX);
+	GLuint nextVertex = 0;
+	for (size_t i = 0; i < numIndices; i++)
+	{
+		auto& newIndex = remap[indices[i]];
+		if (newIndex == UNUSED_VERTEX) {
+			newIndex = nextVertex++;
+		}
+
+		indices[i] = newIndex;
+	}
+
+	for (auto& newIndex : remap)
+	{
+		if (newIndex == UNUSED_VERTEX) {
+			newIndex = nextVertex++;
+		}
+	}
+
+	return remap;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+// STL
+#include <functional>
+
+// Project
+#include "meshRegistry.h"
+
+namespace static_meshes_3D {
+
+	namespace {
+
+		void hashCombine(size_t& seed, size_t value)
+		{
+			seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		}
+
+	} // namespace
+
+	bool MeshRegistry::MeshKey::operator==(const MeshKey& other) const
+	{
+		return type == other.type
+			&& radius == other.radius
+			&& slices == other.slices
+			&& stacks == other.stacks
+			&& height == other.height
+			&& attributeFlags == other.attributeFlags
+			&& encodingFlags == other.encodingFlags;
+	}
+
+	size_t MeshRegistry::MeshKeyHash::operator()(const MeshKey& key) const
+	{
+		size_t result = std::hash<int>()(static_cast<int>(key.type));
+		hashCombine(result, std::hash<float>()(key.radius));
+		hashCombine(result, std::hash<int>()(key.slices));
+		hashCombine(result, std::hash<int>()(key.stacks));
+		hashCombine(result, std::hash<float>()(key.height));
+		hashCombine(result, std::hash<int>()(key.attributeFlags));
+		hashCombine(result, std::hash<int>()(key.encodingFlags));
+		return result;
+	}
+
+	std::shared_ptr<Cylinder> MeshRegistry::getCylinder(float radius, int numSlices, float height, bool withPositions, bool withTextureCoordinates, bool withNormals,
+		const VertexEncoding& encoding)
+	{
+		const MeshKey key{ MeshType::Cylinder, radius, numSlices, 0, height, getAttributeFlags(withPositions, withTextureCoordinates, withNormals), getEncodingFlags(encoding) };
+		return getOrCreate<Cylinder>(key, [&]() {
+			return std::make_shared<Cylinder>(radius, numSlices, height, withPositions, withTextureCoordinates, withNormals, VertexLayout::Planar, encoding);
+		});
+	}
+
+	std::shared_ptr<Tube> MeshRegistry::getTube(float radius, int numSlices, float height, bool withPositions, bool withTextureCoordinates, bool withNormals,
+		const VertexEncoding& encoding)
+	{
+		const MeshKey key{ MeshType::Tube, radius, numSlices, 0, height, getAttributeFlags(withPositions, withTextureCoordinates, withNormals), getEncodingFlags(encoding) };
+		return getOrCreate<Tube>(key, [&]() {
+			return std::make_shared<Tube>(radius, numSlices, height, withPositions, withTextureCoordinates, withNormals, VertexLayout::Planar, encoding);
+		});
+	}
+
+	std::shared_ptr<CylinderIndexed> MeshRegistry::getCylinderIndexed(float radius, int numSlices, float height, bool withPositions, bool withTextureCoordinates, bool withNormals,
+		const VertexEncoding& encoding)
+	{
+		const MeshKey key{ MeshType::CylinderIndexed, radius, numSlices, 0, height, getAttributeFlags(withPositions, withTextureCoordinates, withNormals), getEncodingFlags(encoding) };
+		return getOrCreate<CylinderIndexed>(key, [&]() {
+			return std::make_shared<CylinderIndexed>(radius, numSlices, height, withPositions, withTextureCoordinates, withNormals, VertexLayout::Planar, encoding);
+		});
+	}
+
+	std::shared_ptr<TubeIndexed> MeshRegistry::getTubeIndexed(float radius, int numSlices, float height, bool withPositions, bool withTextureCoordinates, bool withNormals,
+		const VertexEncoding& encoding)
+	{
+		const MeshKey key{ MeshType::TubeIndexed, radius, numSlices, 0, height, getAttributeFlags(withPositions, withTextureCoordinates, withNormals), getEncodingFlags(encoding) };
+		return getOrCreate<TubeIndexed>(key, [&]() {
+			return std::make_shared<TubeIndexed>(radius, numSlices, height, withPositions, withTextureCoordinates, withNormals, VertexLayout::Planar, encoding);
+		});
+	}
+
+	std::shared_ptr<Sphere> MeshRegistry::getSphere(float radius, int sectors, int stacks, const VertexEncoding& encoding)
+	{
+		// Sphere always generates positions and texture coordinates
+		const MeshKey key{ MeshType::Sphere, radius, sectors, stacks, 0.0f, getAttributeFlags(true, true, false), getEncodingFlags(encoding) };
+		return getOrCreate<Sphere>(key, [&]() {
+			return std::make_shared<Sphere>(radius, sectors, stacks, true, encoding);
+		});
+	}
+
+	int MeshRegistry::getHits() const
+	{
+		return _hits;
+	}
+
+	int MeshRegistry::getMisses() const
+	{
+		return _misses;
+	}
+
+	int MeshRegistry::getNumLiveMeshes() const
+	{
+		int result = 0;
+		for (const auto& entry : _meshes)
+		{
+			if (!entry.second.expired()) {
+				result++;
+			}
+		}
+		for (const auto& mesh : _unsharedMeshes)
+		{
+			if (!mesh.expired()) {
+				result++;
+			}
+		}
+
+		return result;
+	}
+
+	void MeshRegistry::resetCounters()
+	{
+		_hits = 0;
+		_misses = 0;
+	}
+
+	void MeshRegistry::setSharingEnabled(bool isSharingEnabled)
+	{
+		_isSharingEnabled = isSharingEnabled;
+	}
+
+	int MeshRegistry::getAttributeFlags(bool withPositions, bool withTextureCoordinates, bool withNormals)
+	{
+		return (withPositions ? 1 : 0) | (withTextureCoordinates ? 2 : 0) | (withNormals ? 4 : 0);
+	}
+
+	int MeshRegistry::getEncodingFlags(const VertexEncoding& encoding)
+	{
+		return static_cast<int>(encoding.positions) | (static_cast<int>(encoding.normals) << 2) | (static_cast<int>(encoding.texCoords) << 3);
+	}
+
+} // namespace static_meshes_3D
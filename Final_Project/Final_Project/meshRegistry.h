@@ -0,0 +1,141 @@
+#pragma once
+
+// STL
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Project
+#include "cylinder.h"
+#include "cylinderIndexed.h"
+#include "tube.h"
+#include "tubeIndexed.h"
+#include "Sphere.h"
+
+namespace static_meshes_3D {
+
+	/**
+	* Cache of generated parametric meshes (cylinders, tubes and spheres).
+	* Meshes with the same geometry parameters share one GPU upload, the registry
+	* hands out reference counted pointers and only keeps weak references itself.
+	*/
+	class MeshRegistry
+	{
+	public:
+		/**
+		 * Gets cylinder with given geometry, generating it only if no such cylinder is alive.
+		 */
+		std::shared_ptr<Cylinder> getCylinder(float radius, int numSlices, float height,
+			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, const VertexEncoding& encoding = VertexEncoding());
+
+		/**
+		 * Gets tube with given geometry, generating it only if no such tube is alive.
+		 */
+		std::shared_ptr<Tube> getTube(float radius, int numSlices, float height,
+			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, const VertexEncoding& encoding = VertexEncoding());
+
+		/**
+		 * Gets indexed cylinder with given geometry, generating it only if no such cylinder is alive.
+		 */
+		std::shared_ptr<CylinderIndexed> getCylinderIndexed(float radius, int numSlices, float height,
+			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, const VertexEncoding& encoding = VertexEncoding());
+
+		/**
+		 * Gets indexed tube with given geometry, generating it only if no such tube is alive.
+		 */
+		std::shared_ptr<TubeIndexed> getTubeIndexed(float radius, int numSlices, float height,
+			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, const VertexEncoding& encoding = VertexEncoding());
+
+		/**
+		 * Gets sphere with given geometry, generating it only if no such sphere is alive.
+		 */
+		std::shared_ptr<Sphere> getSphere(float radius, int sectors, int stacks, const VertexEncoding& encoding = VertexEncoding());
+
+		/**
+		 * Gets number of requests served from already generated meshes.
+		 */
+		int getHits() const;
+
+		/**
+		 * Gets number of requests, that had to generate and upload a new mesh.
+		 */
+		int getMisses() const;
+
+		/**
+		 * Gets number of meshes currently alive.
+		 */
+		int getNumLiveMeshes() const;
+
+		/**
+		 * Resets hit / miss counters.
+		 */
+		void resetCounters();
+
+		/**
+		 * Enables or disables sharing, without it every request generates and uploads its own mesh
+		 * (to compare GPU objects and frame time with and without sharing).
+		 */
+		void setSharingEnabled(bool isSharingEnabled);
+
+	private:
+		enum class MeshType { Cylinder, Tube, CylinderIndexed, TubeIndexed, Sphere };
+
+		// Identifies mesh by its type and all parameters affecting generated data
+		struct MeshKey
+		{
+			MeshType type;
+			float radius;
+			int slices;
+			int stacks;
+			float height;
+			int attributeFlags;
+			int encodingFlags;
+
+			bool operator==(const MeshKey& other) const;
+		};
+
+		struct MeshKeyHash
+		{
+			size_t operator()(const MeshKey& key) const;
+		};
+
+		std::unordered_map<MeshKey, std::weak_ptr<void>, MeshKeyHash> _meshes; // Alive meshes by their key
+		std::vector<std::weak_ptr<void>> _unsharedMeshes; // Meshes generated while sharing was disabled
+		bool _isSharingEnabled = true; // Are meshes with the same key shared
+		int _hits = 0; // Requests served from cache
+		int _misses = 0; // Requests that generated new mesh
+
+		static int getAttributeFlags(bool withPositions, bool withTextureCoordinates, bool withNormals);
+		static int getEncodingFlags(const VertexEncoding& encoding);
+
+		template<typename T, typename CreateFunc>
+		std::shared_ptr<T> getOrCreate(const MeshKey& key, CreateFunc create)
+		{
+			if (!_isSharingEnabled)
+			{
+				_misses++;
+				std::shared_ptr<T> mesh = create();
+				_unsharedMeshes.push_back(mesh);
+				return mesh;
+			}
+
+			auto it = _meshes.find(key);
+			if (it != _meshes.end())
+			{
+				if (auto mesh = it->second.lock())
+				{
+					_hits++;
+					return std::static_pointer_cast<T>(mesh);
+				}
+			}
+
+			_misses++;
+			std::shared_ptr<T> mesh = create();
+			_meshes[key] = mesh;
+			return mesh;
+		}
+	};
+
+} // namespace static_meshes_3D
@@ -0,0 +1,113 @@
+// Project
+#include "common/objectTransform.h"
+
+// SSE is always available on x64 and with /arch:SSE or higher on x86
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OBJECT_TRANSFORM_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+ObjectTransform::ObjectTransform()
+	: _model(1.0f)
+	, _normalMatrix(1.0f) {}
+
+ObjectTransform::ObjectTransform(const glm::mat4& model)
+	: _model(model)
+	, _normalMatrix(computeNormalMatrix(model)) {}
+
+void ObjectTransform::setModel(const glm::mat4& model)
+{
+	if (model == _model) {
+		return;
+	}
+
+	_model = model;
+	_normalMatrix = computeNormalMatrix(model);
+}
+
+const glm::mat4& ObjectTransform::getModel() const
+{
+	return _model;
+}
+
+const glm::mat3& ObjectTransform::getNormalMatrix() const
+{
+	return _normalMatrix;
+}
+
+glm::mat3 ObjectTransform::computeNormalMatrix(const glm::mat4& model)
+{
+	const glm::vec3 a(model[0]);
+	const glm::vec3 b(model[1]);
+	const glm::vec3 c(model[2]);
+
+	// Columns of inverse transpose are these cross products divided by determinant
+	glm::mat3 result;
+	result[0] = glm::cross(b, c);
+	result[1] = glm::cross(c, a);
+	result[2] = glm::cross(a, b);
+
+	// Keep orientation of mirrored objects, the magnitude gets normalized away in shader
+	const auto determinant = glm::dot(a, result[0]);
+	if (determinant < 0.0f)
+	{
+		result[0] = -result[0];
+		result[1] = -result[1];
+		result[2] = -result[2];
+	}
+
+	return result;
+}
+
+void ObjectTransform::computeNormalMatrices(const glm::mat4* models, glm::mat3* normalMatrices, size_t count)
+{
+	size_t i = 0;
+
+#ifdef OBJECT_TRANSFORM_USE_SSE
+	const auto cross = [](const __m128* u, const __m128* v, __m128* out)
+	{
+		out[0] = _mm_sub_ps(_mm_mul_ps(u[1], v[2]), _mm_mul_ps(u[2], v[1]));
+		out[1] = _mm_sub_ps(_mm_mul_ps(u[2], v[0]), _mm_mul_ps(u[0], v[2]));
+		out[2] = _mm_sub_ps(_mm_mul_ps(u[0], v[1]), _mm_mul_ps(u[1], v[0]));
+	};
+
+	const auto signBit = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		// Transpose upper 3x3 parts of 4 matrices, so that SSE lane k works on matrix i + k
+		__m128 m[3][3];
+		for (int column = 0; column < 3; column++)
+		{
+			for (int row = 0; row < 3; row++) {
+				m[column][row] = _mm_setr_ps(models[i][column][row], models[i + 1][column][row], models[i + 2][column][row], models[i + 3][column][row]);
+			}
+		}
+
+		__m128 n[3][3];
+		cross(m[1], m[2], n[0]);
+		cross(m[2], m[0], n[1]);
+		cross(m[0], m[1], n[2]);
+
+		// Negate matrices with negative determinant by flipping sign bits
+		const auto determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][0], n[0][0]), _mm_mul_ps(m[0][1], n[0][1])), _mm_mul_ps(m[0][2], n[0][2]));
+		const auto sign = _mm_and_ps(determinant, signBit);
+
+		alignas(16) float lanes[4];
+		for (int column = 0; column < 3; column++)
+		{
+			for (int row = 0; row < 3; row++)
+			{
+				_mm_store_ps(lanes, _mm_xor_ps(n[column][row], sign));
+				for (int k = 0; k < 4; k++) {
+					normalMatrices[i + k][column][row] = lanes[k];
+				}
+			}
+		}
+	}
+#endif
+
+	// Remaining matrices (or all of them without SSE)
+	for (; i < count; i++) {
+		normalMatrices[i] = computeNormalMatrix(models[i]);
+	}
+}
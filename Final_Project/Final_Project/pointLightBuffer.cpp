@@ -0,0 +1,108 @@
+// STL
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+
+// Project
+#include "common/pointLightBuffer.h"
+
+namespace {
+
+// Light contribution below this level isn't visible in 8-bit color
+const float ATTENUATION_THRESHOLD = 5.0f / 256.0f;
+
+float maxComponent(const glm::vec3& v)
+{
+	return std::max(v.x, std::max(v.y, v.z));
+}
+
+} // namespace
+
+int PointLightBuffer::addLight(const glm::vec3& position, const glm::vec3& ambient, const glm::vec3& diffuse, const glm::vec3& specular,
+	float constant, float linear, float quadratic)
+{
+	PointLight light;
+	light.position = position;
+	light.ambient = ambient;
+	light.diffuse = diffuse;
+	light.specular = specular;
+	light.constant = constant;
+	light.linear = linear;
+	light.quadratic = quadratic;
+
+	const auto maxIntensity = std::max(maxComponent(ambient), std::max(maxComponent(diffuse), maxComponent(specular)));
+	light.radius = computeAttenuationRadius(maxIntensity, constant, linear, quadratic);
+
+	_lights.push_back(light);
+	_isDirty = true;
+	return static_cast<int>(_lights.size()) - 1;
+}
+
+void PointLightBuffer::setLightPosition(int lightIndex, const glm::vec3& position)
+{
+	_lights[lightIndex].position = position;
+	_isDirty = true;
+}
+
+const PointLight& PointLightBuffer::getLight(int lightIndex) const
+{
+	return _lights[lightIndex];
+}
+
+int PointLightBuffer::getNumLights() const
+{
+	return static_cast<int>(_lights.size());
+}
+
+void PointLightBuffer::uploadToGPU(GLuint bindingPoint)
+{
+	if (!_isDirty) {
+		return;
+	}
+
+	const auto lightsSize = sizeof(PointLight) * _lights.size();
+	const auto requiredSize = sizeof(LightBufferHeader) + lightsSize;
+	if (_ssbo.getBufferID() == 0) {
+		_ssbo.createSSBO(requiredSize, GL_DYNAMIC_DRAW);
+	}
+	else {
+		_ssbo.reserve(requiredSize);
+	}
+
+	LightBufferHeader header = {};
+	header.numLights = static_cast<GLuint>(_lights.size());
+	_ssbo.setData(&header, sizeof(LightBufferHeader));
+	if (lightsSize > 0) {
+		_ssbo.setData(_lights.data(), lightsSize, sizeof(LightBufferHeader));
+	}
+
+	_ssbo.bindBufferBase(bindingPoint);
+	_isDirty = false;
+}
+
+void PointLightBuffer::deleteLights()
+{
+	_ssbo.deleteSSBO();
+	_lights.clear();
+	_isDirty = true;
+}
+
+float PointLightBuffer::computeAttenuationRadius(float maxIntensity, float constant, float linear, float quadratic)
+{
+	// Solve maxIntensity / (constant + linear * d + quadratic * d^2) = threshold for d
+	const auto c = constant - maxIntensity / ATTENUATION_THRESHOLD;
+	if (c >= 0.0f) {
+		return 0.0f; // Light is never bright enough to be visible
+	}
+
+	if (quadratic > 0.0f) {
+		return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+	}
+
+	if (linear > 0.0f) {
+		return -c / linear;
+	}
+
+	return FLT_MAX; // No attenuation, light reaches everywhere
+}
@@ -0,0 +1,266 @@
+// STL
+#include <algorithm>
+#include <iostream>
+
+// GLM
+#include <glm/gtc/type_ptr.hpp>
+
+// Project
+#include "common/renderQueue.h"
+
+namespace {
+
+// Key field widths, from most to least significant bits
+const int PROGRAM_BITS = 8;
+const int VAO_BITS = 12;
+const int TEXTURE_BITS = 12;
+const int MATERIAL_BITS = 8;
+const int DEPTH_BITS = 24;
+
+static_assert(PROGRAM_BITS + VAO_BITS + TEXTURE_BITS + MATERIAL_BITS + DEPTH_BITS == 64, "Sort key fields must fill 64 bits");
+
+const int MAX_MATERIALS = 1 << MATERIAL_BITS;
+
+// Marks state, which hasn't been set yet during execute()
+const GLuint UNKNOWN_STATE = ~0u;
+
+uint64_t keyField(uint64_t value, int bits, int shift)
+{
+	return (value & ((uint64_t(1) << bits) - 1)) << shift;
+}
+
+} // namespace
+
+int RenderQueue::addMaterial(const RenderMaterial& material)
+{
+	if (static_cast<int>(_materials.size()) >= MAX_MATERIALS)
+	{
+		std::cerr << "Render queue supports at most " << MAX_MATERIALS << " materials!" << std::endl;
+		return 0;
+	}
+
+	_materials.push_back(material);
+	return static_cast<int>(_materials.size()) - 1;
+}
+
+void RenderQueue::setViewPosition(const glm::vec3& viewPosition, float farPlane)
+{
+	_viewPosition = viewPosition;
+	_farPlane = farPlane;
+}
+
+void RenderQueue::submit(const ShaderProgram& program, GLuint vao, GLuint texture, int materialIndex, const ObjectTransform* transform, std::function<void()> draw,
+	const glm::mat4& positionDequantization)
+{
+	if (materialIndex < 0 || materialIndex >= static_cast<int>(_materials.size()))
+	{
+		std::cerr << "Draw submitted with unknown material " << materialIndex << "!" << std::endl;
+		return;
+	}
+
+	// Instanced draws have no single position, they're sorted as nearest
+	auto normalizedDepth = 0.0f;
+	if (transform != nullptr) {
+		normalizedDepth = glm::length(glm::vec3(transform->getModel()[3]) - _viewPosition) / _farPlane;
+	}
+
+	_keys.push_back(makeSortKey(program.getProgramID(), vao, texture, materialIndex, normalizedDepth));
+	_order.push_back(static_cast<uint32_t>(_items.size()));
+	_items.push_back(Item{ &program, vao, texture, materialIndex, transform, std::move(draw), positionDequantization });
+}
+
+void RenderQueue::execute()
+{
+	radixSort(_keys, _order, _keysTemp, _orderTemp);
+
+	_statistics = Statistics();
+	_programStates.clear();
+
+	auto currentProgram = UNKNOWN_STATE;
+	auto currentVAO = UNKNOWN_STATE;
+	auto currentTexture = UNKNOWN_STATE;
+	auto naiveUniformChanges = 0;
+
+	// All textures of the scene are texture arrays in texture unit 0, materials select their layers
+	glActiveTexture(GL_TEXTURE0);
+
+	for (const auto itemIndex : _order)
+	{
+		const auto& item = _items[itemIndex];
+		const auto& program = *item.program;
+		const auto programId = program.getProgramID();
+		if (programId != currentProgram)
+		{
+			glUseProgram(programId);
+			currentProgram = programId;
+			_statistics.programChanges++;
+		}
+
+		if (item.vao != currentVAO)
+		{
+			glBindVertexArray(item.vao);
+			currentVAO = item.vao;
+			_statistics.vaoChanges++;
+		}
+
+		if (item.texture != currentTexture)
+		{
+			glBindTexture(GL_TEXTURE_2D_ARRAY, item.texture);
+			currentTexture = item.texture;
+			_statistics.textureChanges++;
+		}
+
+		auto& programState = _programStates[programId];
+		if (item.materialIndex != programState.materialIndex)
+		{
+			_statistics.uniformChanges += applyMaterial(program, _materials[item.materialIndex]);
+			programState.materialIndex = item.materialIndex;
+		}
+
+		const auto instanced = item.transform == nullptr ? 1 : 0;
+		const auto instancedLoc = program.getUniformLocation(ShaderUniform::Instanced);
+		if (instancedLoc != -1 && instanced != programState.instanced)
+		{
+			glUniform1i(instancedLoc, instanced);
+			programState.instanced = instanced;
+			_statistics.uniformChanges++;
+		}
+
+		// Dequantization is a translation and uniform scale, so the normal matrix of the transform stays valid
+		if (item.transform != nullptr)
+		{
+			const glm::mat4 model = item.transform->getModel() * item.positionDequantization;
+			glUniformMatrix4fv(program.getUniformLocation(ShaderUniform::Model), 1, GL_FALSE, glm::value_ptr(model));
+			const auto normalMatrixLoc = program.getUniformLocation(ShaderUniform::NormalMatrix);
+			if (normalMatrixLoc != -1) {
+				glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, glm::value_ptr(item.transform->getNormalMatrix()));
+			}
+		}
+
+		item.draw();
+		_statistics.numDraws++;
+	}
+
+	// Without sorting, every draw would set all of its state
+	for (const auto& item : _items)
+	{
+		auto uniformsPerDraw = 0;
+		const auto& program = *item.program;
+		for (const auto uniform : { ShaderUniform::MaterialShininess, ShaderUniform::UVScale, ShaderUniform::LightColor, ShaderUniform::TextureLayer, ShaderUniform::Instanced })
+		{
+			if (program.getUniformLocation(uniform) != -1) {
+				uniformsPerDraw++;
+			}
+		}
+		naiveUniformChanges += uniformsPerDraw;
+	}
+
+	_statistics.programChangesSaved = _statistics.numDraws - _statistics.programChanges;
+	_statistics.vaoChangesSaved = _statistics.numDraws - _statistics.vaoChanges;
+	_statistics.textureChangesSaved = _statistics.numDraws - _statistics.textureChanges;
+	_statistics.uniformChangesSaved = naiveUniformChanges - _statistics.uniformChanges;
+
+	glBindVertexArray(0);
+
+	_items.clear();
+	_keys.clear();
+	_order.clear();
+}
+
+int RenderQueue::getNumItems() const
+{
+	return static_cast<int>(_items.size());
+}
+
+const RenderQueue::Statistics& RenderQueue::getLastFrameStatistics() const
+{
+	return _statistics;
+}
+
+uint64_t RenderQueue::makeSortKey(GLuint programId, GLuint vao, GLuint texture, int materialIndex, float normalizedDepth)
+{
+	const auto maxDepth = (uint64_t(1) << DEPTH_BITS) - 1;
+	const auto depth = static_cast<uint64_t>(std::min(std::max(normalizedDepth, 0.0f), 1.0f) * maxDepth);
+
+	auto shift = 64;
+	uint64_t key = 0;
+	key |= keyField(programId, PROGRAM_BITS, shift -= PROGRAM_BITS);
+	key |= keyField(vao, VAO_BITS, shift -= VAO_BITS);
+	key |= keyField(texture, TEXTURE_BITS, shift -= TEXTURE_BITS);
+	key |= keyField(static_cast<uint64_t>(materialIndex), MATERIAL_BITS, shift -= MATERIAL_BITS);
+	key |= keyField(depth, DEPTH_BITS, shift -= DEPTH_BITS);
+	return key;
+}
+
+void RenderQueue::radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& indices, std::vector<uint64_t>& keysTemp, std::vector<uint32_t>& indicesTemp)
+{
+	const auto count = keys.size();
+	keysTemp.resize(count);
+	indicesTemp.resize(count);
+
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		size_t histogram[256] = {};
+		for (const auto key : keys) {
+			histogram[(key >> shift) & 0xFF]++;
+		}
+
+		// All keys have the same digit, this pass wouldn't change the order
+		if (count == 0 || histogram[(keys[0] >> shift) & 0xFF] == count) {
+			continue;
+		}
+
+		size_t offset = 0;
+		for (auto& bucket : histogram)
+		{
+			const auto bucketSize = bucket;
+			bucket = offset;
+			offset += bucketSize;
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const auto destination = histogram[(keys[i] >> shift) & 0xFF]++;
+			keysTemp[destination] = keys[i];
+			indicesTemp[destination] = indices[i];
+		}
+
+		keys.swap(keysTemp);
+		indices.swap(indicesTemp);
+	}
+}
+
+int RenderQueue::applyMaterial(const ShaderProgram& program, const RenderMaterial& material) const
+{
+	auto numUniforms = 0;
+
+	const auto shininessLoc = program.getUniformLocation(ShaderUniform::MaterialShininess);
+	if (shininessLoc != -1)
+	{
+		glUniform1f(shininessLoc, material.shininess);
+		numUniforms++;
+	}
+
+	const auto uvScaleLoc = program.getUniformLocation(ShaderUniform::UVScale);
+	if (uvScaleLoc != -1)
+	{
+		glUniform2fv(uvScaleLoc, 1, glm::value_ptr(material.uvScale));
+		numUniforms++;
+	}
+
+	const auto colorLoc = program.getUniformLocation(ShaderUniform::LightColor);
+	if (colorLoc != -1)
+	{
+		glUniform3fv(colorLoc, 1, glm::value_ptr(material.color));
+		numUniforms++;
+	}
+
+	const auto textureLayerLoc = program.getUniformLocation(ShaderUniform::TextureLayer);
+	if (textureLayerLoc != -1)
+	{
+		glUniform1ui(textureLayerLoc, material.textureLayer);
+		numUniforms++;
+	}
+
+	return numUniforms;
+}
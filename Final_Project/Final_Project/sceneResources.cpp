@@ -0,0 +1,615 @@
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// GLM
+#include <glm/gtx/transform.hpp>
+
+// Project
+#include "sceneResources.h"
+#include "common/gpuObjectCounter.h"
+
+namespace {
+
+// Vertex data (vertex positions, normals, texture coordinates)
+// Roof vertices - 54 vertices
+const GLfloat roofVerts[] = {
+     -1.0f, 0.7f, 1.0f,  -1.0f, 0.0f, 0.0f,  2.0f, 0.0f, // Left front low
+     -1.0f, 0.75f, 1.0f,  -1.0f, 0.0f, 0.0f,  2.0f, 2.0f, // Left front high
+     -1.0f, 0.7f, -1.0f,  -1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Left back low
+
+     -1.0f, 0.75f, 1.0f,  -1.0f, 0.0f, 0.0f,  2.0f, 2.0f, // Left front high
+     -1.0f, 0.7f, -1.0f,  -1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Left back low
+     -1.0f, 0.75f, -1.0f,  -1.0f, 0.0f, 0.0f,  0.f, 2.0f, // Left back high
+
+     -1.0f, 0.7f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Left front low
+     -1.0f, 0.75f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 2.0f, // Left front high
+     0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 2.0f, // Mid front high
+
+     -1.0f, 0.7f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Left front low
+     0.0f, 0.95f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 0.0f, // Mid front low
+     0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 2.0f, // Mid front high
+
+     -1.0f, 0.7f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Left back low
+     -1.0f, 0.75f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 2.0f, // Left back high
+     0.0f, 1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 2.0, // Mid back high
+
+     -1.0f, 0.7f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Left back low
+     0.0f, 0.95f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 0.0f, // Mid back low
+     0.0f, 1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 2.0f, // Mid back high
+
+     0.0f, 0.95f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 0.0f, // Mid front low
+     0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 2.0f, // Mid front high
+     1.0f, 0.7f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Right front low
+
+     0.0f, 1.0f, 1.0f,  0.0f, 0.0f, 1.0f,  2.0f, 0.0f, // Mid front high
+     1.0f, 0.7f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Right front low
+     1.0f, 0.75f, 1.0f,  0.0f, 0.0f, 1.0f,  0.0f, 2.0f, // Right front high
+
+     0.0f, 0.95f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 0.0f, // Mid back low
+     0.0f, 1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 0.0f, // Mid back high
+     1.0f, 0.7f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Right back low
+
+     0.0f, 1.0f, -1.0f,  0.0f, 0.0f, -1.0f,  2.0f, 2.0f, // Mid back high
+     1.0f, 0.7f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Right back low
+     1.0f, 0.75f, -1.0f,  0.0f, 0.0f, -1.0f,  0.0f, 4.0f, // Right back high
+
+     -1.0f, 0.75f, 1.0f,  -0.242536f, 0.97014f, 0.0f,  4.0f, 0.0f, // Left front high
+     -1.0f, 0.75f, -1.0f,  -0.242536f, 0.97014f, 0.0f,  0.0f, 0.0f, // Left back high
+     0.0f, 1.0f, -1.0f,  -0.242536f, 0.97014f, 0.0f,  0.0f, 4.0f, // Mid back high
+
+     -1.0f, 0.75f, 1.0f,  -0.242536f, 0.97014f, 0.0f,  4.0f, 0.0f, // Left front high
+     0.0f, 1.0f, 1.0f,  -0.242536f, 0.97014f, 0.0f,  4.0f, 4.0f, // Mid front high
+     0.0f, 1.0f, -1.0f,  -0.242536f, 0.97014f, 0.0f,  0.0f, 4.0f, // Mid back high
+
+     -1.0f, 0.7f, 1.0f,  0.242536f, -0.97014f, 0.0f,  0.0f, 0.0f, // Left front low
+     -1.0f, 0.7f, -1.0f,  0.242536f, -0.97014f, 0.0f,  4.0f, 0.0f, // Left back low
+     0.0f, 0.95f, -1.0f,  0.242536f, -0.97014f, 0.0f,  4.0f, 4.0f, // Mid back low
+
+     -1.0f, 0.7f, 1.0f,  0.242536f, -0.97014f, 0.0f,  0.0f, 0.0f, // Left front low
+     0.0f, 0.95f, 1.0f,  0.242536f, -0.97014f, 0.0f,  0.0f, 4.0f, // Mid front low
+     0.0f, 0.95f, -1.0f,  0.242536f, -0.97014f, 0.0f,  4.0f, 4.0f, // Mid back low
+
+     0.0f, 1.0f, 1.0f,  0.242536f, 0.97014f, 0.0f,  0.0f, 4.0f, // Mid front high
+     1.0f, 0.75f, 1.0f,  0.242536f, 0.97014f, 0.0f,  0.0f, 0.0f, // Right front high
+     1.0f, 0.75f, -1.0f,  0.242536f, 0.97014f, 0.0f,  4.0f, 0.0f, // Right back high
+
+     0.0f, 1.0f, 1.0f,  0.242536f, 0.97014f, 0.0f,  0.0f, 4.0f, // Mid front high
+     0.0f, 1.0f, -1.0f,  0.242536f, 0.97014f, 0.0f,  4.0f, 4.0f, // Mid back high
+     1.0f, 0.75f, -1.0f,  0.242536f, 0.97014f, 0.0f,  4.0f, 0.0f, // Right back high
+
+     0.0f, 0.95f, 1.0f,  -0.242536f, -0.97014f, 0.0f,  0.0f, 4.0f, // Mid front low
+     1.0f, 0.7f, 1.0f,  -0.242536f, -0.97014f, 0.0f,  0.0f, 0.0f, // Right front low
+     1.0f, 0.7f, -1.0f,  -0.242536f, -0.97014f, 0.0f,  4.0f, 0.0f, // Right back low
+
+     0.0f, 0.95f, 1.0f,  -0.242536f, -0.97014f, 0.0f,  0.0f, 4.0f, // Mid front low
+     0.0f, 0.95f, -1.0f,  -0.242536f, -0.97014f, 0.0f,  4.0f, 4.0f, // Mid back low
+     1.0f, 0.7f, -1.0f,  -0.242536f, -0.97014f, 0.0f,  4.0f, 0.0f, // Right back low
+};
+
+// Shed vertices - 30 vertices
+const GLfloat shedVerts[] = {
+    // Left
+     -0.9f, -1.0f, 0.9f,  -1.0f, 0.0f, 0.0f,  0.5f, 0.0f, // Front left bottom
+     -0.9f, -1.0f, -0.9f,  -1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Back left bottom
+     -0.9f, 0.75f, -0.9f,  -1.0f, 0.0f, 0.0f, 0.5f, 1.0f, // Back left top
+
+     -0.9f, -1.0f, 0.9f,  -1.0f, 0.0f, 0.0f,  0.5f, 0.0f, // Front left bottom
+     -0.9f, 0.75f, 0.9f,  -1.0f, 0.0f, 0.0f,  0.5f, 1.0f, // Front left top
+     -0.9f, 0.75f, -0.9f,  -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, // Back left top
+     // Front
+     -0.9f, -1.0f, 0.9f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Front left bottom
+     -0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.0f, 1.0f, // Front left top
+     0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.5f, 1.0f, // Front right top
+
+     -0.9f, -1.0f, 0.9f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Front left bottom
+     0.9f, -1.0f, 0.9f,  0.0f, 0.0f, 1.0f,  0.5f, 0.0f, // Front right bottom
+     0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.5f, 1.0f, // Front right top
+     // Front top
+     -0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f, // Front left top
+     0.0f, 0.95f, 0.9f,  0.0f, 0.0f, 1.0f,  0.25f, 0.12f, // Front middle
+     0.9f, 0.75f, 0.9f,  0.0f, 0.0f, 1.0f,  0.5f, 0.0f, // Front right top
+     // Right
+     0.9f, -1.0f, 0.9f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Front right bottom
+     0.9f, 0.75f, 0.9f,  1.0f, 0.0f, 0.0f,  0.0f, 1.0f, // Front right top
+     0.9f, 0.75f, -0.9f,  1.0f, 0.0f, 0.0f,  0.5f, 1.0f, // Back right top
+
+     0.9f, -1.0f, 0.9f,  1.0f, 0.0f, 0.0f,  0.0f, 0.0f, // Front right bottom
+     0.9f, -1.0f, -0.9f,  1.0f, 0.0f, 0.0f,  0.5f, 0.0f, // Back right bottom
+     0.9f, 0.75f, -0.9f,  1.0f, 0.0f, 0.0f,  0.5f, 1.0f, // Back right top
+     // Back
+     0.9f, -1.0f, -0.9f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Back right bottom
+     0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.0f, 1.0f, // Back right top
+     -0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.5f, 1.0f, // Back left top
+
+     0.9f, -1.0f, -0.9f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Back right bottom
+     -0.9f, -1.0f, -0.9f,  0.0f, 0.0f, -1.0f,  0.5f, 0.0f, // Back left bottom
+     -0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.5f, 1.0f, // Back left top
+     // Back top
+     0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.0f, 0.0f, // Back right top
+     0.0f, 0.95f, -0.9f,  0.0f, 0.0f, -1.0f,  0.25f, 0.12f, // Back middle
+     -0.9f, 0.75f, -0.9f,  0.0f, 0.0f, -1.0f,  0.5f, 0.0f, // Back left top
+};
+
+//Plane vertices (grass, door, chairs) - 6 vertices
+const GLfloat planeVerts[] = {
+    -1.0f, -1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f,
+    -1.0f, 1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 5.0f,
+    1.0f, 1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  5.0f, 5.0f,
+
+    -1.0f, -1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  0.0f, 0.0f,
+    1.0f, 1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  5.0f, 5.0f,
+    1.0f, -1.0f, 0.0f,  0.0f, 0.0f, 1.0f,  5.0f, 0.0f,
+};
+
+// Pyramid vertices (trees) - 18 vertices
+const GLfloat pyramidVerts[] = {
+    //Positions          // Normal vectors   //Texture Coordinates
+    // Base 1
+     -1.0f, -1.0f,  1.0f,  0.0f, -1.0f, 0.0f,  0.0f, 0.0f, // Front left 
+     -1.0f, -1.0f, -1.0f,  0.0f, -1.0f, 0.0f,  0.0f, 1.0f, // Back left 
+     1.0f, -1.0f, -1.0f,  0.0f, -1.0f, 0.0f,  1.0f, 1.0f, // Back right
+     // Base 2
+     -1.0f, -1.0f,  1.0f,  0.0f, -1.0f, 0.0f,  0.0f, 0.0f, // Front left  
+     1.0f, -1.0f, -1.0f,  0.0f, -1.0f, 0.0f,  1.0f, 1.0f, // Back right 
+     1.0f, -1.0f,  1.0f,  0.0f, -1.0f, 0.0f,  1.0f, 0.0f, // Front right
+     // Left
+     -1.0f, -1.0f, -1.0f,  0.89443f, -0.44721f, 0.0f,  0.0f, 0.0f, // Back left 
+     -1.0f, -1.0f,  1.0f,  0.89443f, -0.44721f, 0.0f,  5.0f, 0.0f, // Front left 
+     0.0f,  1.0f,  0.0f,  0.89443f, -0.44721f, 0.0f,  2.5f, 5.0f, // Top center 
+     // Back
+     1.0f, -1.0f, -1.0f,  0.0f, 0.44721f, -0.89443f,  0.0f, 0.0f, // Back right 
+     -1.0f, -1.0f, -1.0f,  0.0f, 0.44721f, -0.89443f,  5.0f, 0.0f, // Back left 
+     0.0f,  1.0f,  0.0f,  0.0f, 0.44721f, -0.89443f,  2.5f, 5.0f, // Top center 
+     //Right
+     1.0f, -1.0f,  1.0f,  0.89443f, 0.44721f, 0.0f,  0.0f, 0.0f, // Front right
+     1.0f, -1.0f, -1.0f,  0.89443f, 0.44721f, 0.0f,  5.0f, 0.0f, // Back right 
+     0.0f,  1.0f,  0.0f,  0.89443f, 0.44721f, 0.0f,  2.5f, 5.0f, // Top center
+     // Front
+     -1.0f, -1.0f,  1.0f,  0.0f, 0.44721f, 0.89443f,  0.0f, 0.0f, // Front left 
+     1.0f, -1.0f,  1.0f,  0.0f, 0.44721f, 0.89443f,  5.0f, 0.0f, // Front right 
+     0.0f,  1.0f,  0.0f,  0.0f, 0.44721f, 0.89443f,  2.5f, 5.0f, // Top center 
+};
+
+const GLuint floatsPerVertex = 3;
+const GLuint floatsPerNormal = 3;
+const GLuint floatsPerUV = 2;
+// Strides between vertex coordinates
+const GLint stride = sizeof(GLfloat) * (floatsPerVertex + floatsPerNormal + floatsPerUV);
+
+// Names of geometry arena entries in asset pack
+const char* const ARENA_VERTICES_ENTRY = "scene/arena.vertices";
+const char* const ARENA_INDICES_ENTRY = "scene/arena.indices";
+const char* const ARENA_MESHES_ENTRY = "scene/arena.meshes";
+
+// Slice counts of the levels of detail of parametric meshes, 10 slices of the original meshes are the third level
+const int LOD_SLICES[SceneResources::NUM_LOD_LEVELS] = { 40, 20, 10, 5 };
+
+// Creates levels of detail of a parametric mesh, createLevel generates mesh with given number of slices
+template <typename MeshType, typename CreateLevel>
+static_meshes_3D::MeshLod<MeshType> createLod(float boundingRadius, CreateLevel createLevel)
+{
+	std::vector<std::shared_ptr<MeshType>> levels;
+	for (const auto slices : LOD_SLICES) {
+		levels.push_back(createLevel(slices));
+	}
+
+	const std::vector<int> sliceCounts(std::begin(LOD_SLICES), std::end(LOD_SLICES));
+	return static_meshes_3D::MeshLod<MeshType>(std::move(levels), LodSelector::fromSliceCounts(sliceCounts), boundingRadius);
+}
+
+// Radius of bounding sphere of a cylinder centered at the origin
+float cylinderBoundingRadius(float radius, float height)
+{
+	return std::sqrt(radius * radius + height * height / 4.0f);
+}
+
+// Checks, that every mesh range lies within the index buffer and its indices within the vertex buffer
+bool areRangesValid(const GeometryArena::MeshRange* ranges, size_t numRanges, const GLuint* indices, size_t numIndices, size_t numVertices)
+{
+	for (size_t i = 0; i < numRanges; i++)
+	{
+		const auto& range = ranges[i];
+		if (range.baseVertex < 0 || static_cast<size_t>(range.firstIndex) + range.indexCount > numIndices) {
+			return false;
+		}
+
+		for (auto index = indices + range.firstIndex; index != indices + range.firstIndex + range.indexCount; ++index)
+		{
+			if (static_cast<size_t>(range.baseVertex) + *index >= numVertices) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+template <typename T>
+void addEntry(std::vector<AssetPack::EntryData>& entries, const char* name, const T* data, size_t count)
+{
+	AssetPack::EntryData entry;
+	entry.name = name;
+	entry.data.resize(sizeof(T) * count);
+	if (count > 0) {
+		std::memcpy(entry.data.data(), data, entry.data.size());
+	}
+	entries.push_back(std::move(entry));
+}
+
+} // namespace
+
+SceneResources::~SceneResources()
+{
+	destroy();
+}
+
+bool SceneResources::create(const AssetPack* assetPack, bool shareMeshes)
+{
+	if (_isCreated)
+	{
+		std::cerr << "Scene resources are already created! You need to destroy them before re-creating them!" << std::endl;
+		return false;
+	}
+
+	_plane = createMesh(planeVerts, sizeof(planeVerts));
+	_shed = createMesh(shedVerts, sizeof(shedVerts));
+	_roof = createMesh(roofVerts, sizeof(roofVerts));
+	_pyramid = createMesh(pyramidVerts, sizeof(pyramidVerts));
+
+	// Parametric meshes in all levels of detail, identical geometry is generated and uploaded only once
+	_meshRegistry.setSharingEnabled(shareMeshes);
+	auto& registry = _meshRegistry;
+	_firepit = createLod<static_meshes_3D::CylinderIndexed>(cylinderBoundingRadius(1.0f, 0.125f),
+		[&registry](int slices) { return registry.getCylinderIndexed(1.0f, slices, 0.125f); });
+	_firepitRim = createLod<static_meshes_3D::TubeIndexed>(cylinderBoundingRadius(1.0f, 0.25f),
+		[&registry](int slices) { return registry.getTubeIndexed(1.0f, slices, 0.25f); });
+	// Indexed meshes keep their strips, unless the reordered triangle list transforms fewer vertices
+	const auto optimizeLevel = [](const char* name, int level, static_meshes_3D::StaticMeshIndexed3D& mesh)
+	{
+		MeshOptimizer::VertexCacheStatistics before, after;
+		const auto isReordered = mesh.optimize(true, &before, &after);
+		std::cout << "Vertex cache of " << name << " level " << level << ": ACMR " << before.acmr << " -> " << after.acmr
+			<< ", ATVR " << before.atvr << " -> " << after.atvr << (isReordered ? ", triangle list" : ", strips kept") << std::endl;
+	};
+	for (int level = 0; level < NUM_LOD_LEVELS; level++)
+	{
+		optimizeLevel("fire pit", level, *_firepit.getSharedLevel(level));
+		optimizeLevel("fire pit rim", level, *_firepitRim.getSharedLevel(level));
+	}
+	// Sphere is stretched in its xy plane by 1.02, its levels and the props below are stored in compact encoding
+	// (half the bytes per vertex, dequantized by instance matrices or by the render queue)
+	const auto compact = static_meshes_3D::VertexEncoding::compact();
+	_knob = createLod<Sphere>(0.1f * 1.02f, [&registry, &compact](int slices) { return registry.getSphere(0.1f, slices, slices, compact); });
+	_moon = createLod<Sphere>(0.5f * 1.02f, [&registry, &compact](int slices) { return registry.getSphere(0.5f, slices, slices, compact); });
+	// Spheres reorder their triangles when generated, only the result is reported
+	const auto reportSphere = [](const char* name, const static_meshes_3D::MeshLod<Sphere>& lod)
+	{
+		for (int level = 0; level < lod.getNumLevels(); level++)
+		{
+			const Sphere& sphere = lod.getLevel(level);
+			const auto& indices = sphere.GetIndices();
+			const auto statistics = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), sphere.GetVertices().size() / 5);
+			std::cout << "Vertex cache of " << name << " level " << level << ": ACMR " << statistics.acmr << ", ATVR " << statistics.atvr << std::endl;
+		}
+	};
+	reportSphere("knob", _knob);
+	reportSphere("moon", _moon);
+
+	// Repeated props, each group is rendered with instanced draw call(s)
+	const auto cylinderLod = [&registry, &compact](float radius, float height) {
+		return createLod<static_meshes_3D::Cylinder>(cylinderBoundingRadius(radius, height),
+			[&registry, &compact, radius, height](int slices) { return registry.getCylinder(radius, slices, height, true, true, true, compact); });
+	};
+	const auto chairPost = cylinderLod(0.03f, 1.5f);
+	_blueChairPosts = createInstances(chairPost, { glm::vec3(3.0f, 1.625f, 1.75f), glm::vec3(3.0f, 1.625f, 3.25f) });
+	_redChairPosts = createInstances(chairPost, { glm::vec3(-3.0f, 1.625f, 1.75f), glm::vec3(-3.0f, 1.625f, 3.25f) });
+	_chairLegs = createInstances(cylinderLod(0.03f, 0.75f), {
+		glm::vec3(3.0f, 0.5f, 3.25f), glm::vec3(3.0f, 0.5f, 1.75f), glm::vec3(2.1f, 0.5f, 3.15f), glm::vec3(2.1f, 0.5f, 1.85f),
+		glm::vec3(-3.0f, 0.5f, 3.25f), glm::vec3(-3.0f, 0.5f, 1.75f), glm::vec3(-2.1f, 0.5f, 3.15f), glm::vec3(-2.1f, 0.5f, 1.85f) });
+	_trunks = createInstances(cylinderLod(0.25f, 1.0f), { glm::vec3(-2.25f, 0.5f, 10.0f), glm::vec3(2.25f, 0.5f, 10.0f) });
+	glBindVertexArray(0);
+
+	_isCreated = true;
+	if (!createArena(assetPack))
+	{
+		destroy();
+		return false;
+	}
+
+	std::cout << "Created scene resources with " << getGpuObjectCount() << " static mesh OpenGL objects and "
+		<< _meshRegistry.getNumLiveMeshes() << " parametric meshes" << std::endl;
+	return true;
+}
+
+void SceneResources::destroy()
+{
+	if (!_isCreated) {
+		return;
+	}
+
+	deleteMesh(_plane);
+	deleteMesh(_shed);
+	deleteMesh(_roof);
+	deleteMesh(_pyramid);
+
+	_blueChairPosts = InstancedLod();
+	_redChairPosts = InstancedLod();
+	_chairLegs = InstancedLod();
+	_trunks = InstancedLod();
+	_firepit = static_meshes_3D::MeshLod<static_meshes_3D::CylinderIndexed>();
+	_firepitRim = static_meshes_3D::MeshLod<static_meshes_3D::TubeIndexed>();
+	_knob = static_meshes_3D::MeshLod<Sphere>();
+	_moon = static_meshes_3D::MeshLod<Sphere>();
+
+	_arena.destroy();
+	for (auto& levels : _arenaMeshes)
+	{
+		for (auto& range : levels) {
+			range = GeometryArena::MeshRange();
+		}
+	}
+
+	_isCreated = false;
+}
+
+const SceneResources::MeshHandle& SceneResources::getPlane() const
+{
+	return _plane;
+}
+
+const SceneResources::MeshHandle& SceneResources::getShed() const
+{
+	return _shed;
+}
+
+const SceneResources::MeshHandle& SceneResources::getRoof() const
+{
+	return _roof;
+}
+
+const SceneResources::MeshHandle& SceneResources::getPyramid() const
+{
+	return _pyramid;
+}
+
+const static_meshes_3D::InstancedMesh& SceneResources::InstancedLod::getLevel(int level) const
+{
+	return *levels[std::min(std::max(level, 0), static_cast<int>(levels.size()) - 1)];
+}
+
+const std::vector<glm::mat4>& SceneResources::InstancedLod::getModelMatrices() const
+{
+	return levels[0]->getModelMatrices();
+}
+
+const SceneResources::InstancedLod& SceneResources::getBlueChairPosts() const
+{
+	return _blueChairPosts;
+}
+
+const SceneResources::InstancedLod& SceneResources::getRedChairPosts() const
+{
+	return _redChairPosts;
+}
+
+const SceneResources::InstancedLod& SceneResources::getChairLegs() const
+{
+	return _chairLegs;
+}
+
+const SceneResources::InstancedLod& SceneResources::getTrunks() const
+{
+	return _trunks;
+}
+
+const static_meshes_3D::MeshLod<static_meshes_3D::CylinderIndexed>& SceneResources::getFirepit() const
+{
+	return _firepit;
+}
+
+const static_meshes_3D::MeshLod<static_meshes_3D::TubeIndexed>& SceneResources::getFirepitRim() const
+{
+	return _firepitRim;
+}
+
+const static_meshes_3D::MeshLod<Sphere>& SceneResources::getKnob() const
+{
+	return _knob;
+}
+
+const static_meshes_3D::MeshLod<Sphere>& SceneResources::getMoon() const
+{
+	return _moon;
+}
+
+const GeometryArena& SceneResources::getArena() const
+{
+	return _arena;
+}
+
+const GeometryArena::MeshRange& SceneResources::getArenaMesh(ArenaMesh mesh, int level) const
+{
+	return _arenaMeshes[static_cast<int>(mesh)][std::min(std::max(level, 0), NUM_LOD_LEVELS - 1)];
+}
+
+IndirectDrawList::LodMesh SceneResources::getArenaLod(ArenaMesh mesh) const
+{
+	IndirectDrawList::LodMesh result;
+	const auto setLod = [&result](const LodSelector& selector, float boundingRadius) {
+		result.selector = selector;
+		result.boundingRadius = boundingRadius;
+	};
+
+	switch (mesh)
+	{
+	case ArenaMesh::Firepit: setLod(_firepit.getSelector(), _firepit.getBoundingRadius()); break;
+	case ArenaMesh::FirepitRim: setLod(_firepitRim.getSelector(), _firepitRim.getBoundingRadius()); break;
+	case ArenaMesh::Knob: setLod(_knob.getSelector(), _knob.getBoundingRadius()); break;
+	case ArenaMesh::ChairPost: setLod(_blueChairPosts.lod.getSelector(), _blueChairPosts.lod.getBoundingRadius()); break;
+	case ArenaMesh::ChairLeg: setLod(_chairLegs.lod.getSelector(), _chairLegs.lod.getBoundingRadius()); break;
+	case ArenaMesh::Trunk: setLod(_trunks.lod.getSelector(), _trunks.lod.getBoundingRadius()); break;
+	default: break;
+	}
+
+	for (int level = 0; level < result.selector.getNumLevels(); level++) {
+		result.levels.push_back(getArenaMesh(mesh, level));
+	}
+
+	return result;
+}
+
+const static_meshes_3D::MeshRegistry& SceneResources::getMeshRegistry() const
+{
+	return _meshRegistry;
+}
+
+int SceneResources::getGpuObjectCount() const
+{
+	int result = 0;
+	for (const MeshHandle* mesh : { &_plane, &_shed, &_roof, &_pyramid })
+	{
+		result += mesh->vao != 0 ? 1 : 0;
+		result += mesh->vbo != 0 ? 1 : 0;
+	}
+
+	return result;
+}
+
+SceneResources::MeshHandle SceneResources::createMesh(const GLfloat* vertices, GLsizeiptr byteSize)
+{
+	MeshHandle mesh;
+	mesh.numVertices = GLsizei(byteSize / stride);
+
+	GpuObjectCounter::genVertexArrays(1, &mesh.vao); // Generate VAO
+	glBindVertexArray(mesh.vao);
+	GpuObjectCounter::genBuffers(1, &mesh.vbo); // Generate VBO
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo); // Activates the buffer
+	glBufferData(GL_ARRAY_BUFFER, byteSize, vertices, GL_STATIC_DRAW); // Sends vertex or coordinate data to the GPU
+
+	// Create Vertex Attribute Pointers
+	glVertexAttribPointer(0, floatsPerVertex, GL_FLOAT, GL_FALSE, stride, (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, floatsPerNormal, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, floatsPerUV, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+	glEnableVertexAttribArray(2);
+
+	return mesh;
+}
+
+void SceneResources::bake(std::vector<AssetPack::EntryData>& entries) const
+{
+	GeometryArena arena;
+	ArenaMeshLevels ranges[static_cast<int>(ArenaMesh::Count)];
+	addArenaMeshes(arena, ranges);
+
+	addEntry(entries, ARENA_VERTICES_ENTRY, arena.getVertices().data(), arena.getVertices().size());
+	addEntry(entries, ARENA_INDICES_ENTRY, arena.getIndices().data(), arena.getIndices().size());
+	addEntry(entries, ARENA_MESHES_ENTRY, &ranges[0][0], static_cast<size_t>(ArenaMesh::Count) * NUM_LOD_LEVELS);
+}
+
+bool SceneResources::createArena(const AssetPack* assetPack)
+{
+	if (assetPack != nullptr)
+	{
+		// Baked arena skips reading parametric meshes back from the GPU and converting them to triangle lists,
+		// a pack baked with different levels of detail has different size of mesh ranges and is rebuilt
+		const auto vertices = assetPack->getEntry(ARENA_VERTICES_ENTRY);
+		const auto indices = assetPack->getEntry(ARENA_INDICES_ENTRY);
+		const auto meshes = assetPack->getEntry(ARENA_MESHES_ENTRY);
+		// Ranges are checked against the loaded buffers, so that a damaged pack can't make the GPU read out of them
+		const auto numVertices = vertices.size / sizeof(GeometryArena::Vertex);
+		const auto numIndices = indices.size / sizeof(GLuint);
+		ArenaMeshLevels ranges[static_cast<int>(ArenaMesh::Count)];
+		if (meshes.size == sizeof(ranges) && vertices.size % sizeof(GeometryArena::Vertex) == 0 && indices.size % sizeof(GLuint) == 0)
+		{
+			std::memcpy(ranges, meshes.data, sizeof(ranges));
+			if (areRangesValid(&ranges[0][0], static_cast<size_t>(ArenaMesh::Count) * NUM_LOD_LEVELS, reinterpret_cast<const GLuint*>(indices.data), numIndices, numVertices))
+			{
+				std::memcpy(_arenaMeshes, ranges, sizeof(_arenaMeshes));
+				return _arena.upload(reinterpret_cast<const GeometryArena::Vertex*>(vertices.data), numVertices, reinterpret_cast<const GLuint*>(indices.data), numIndices);
+			}
+		}
+
+		std::cerr << "Asset pack doesn't hold valid geometry arena of this scene, building it instead!" << std::endl;
+	}
+
+	addArenaMeshes(_arena, _arenaMeshes);
+	return _arena.upload();
+}
+
+void SceneResources::addArenaMeshes(GeometryArena& arena, ArenaMeshLevels* ranges) const
+{
+	// Meshes without levels of detail have the same range at every level
+	const auto setRange = [ranges](ArenaMesh mesh, const GeometryArena::MeshRange& range) {
+		for (auto& levelRange : ranges[static_cast<int>(mesh)]) {
+			levelRange = range;
+		}
+	};
+
+	setRange(ArenaMesh::Plane, arena.addTriangles(planeVerts, sizeof(planeVerts) / stride));
+	setRange(ArenaMesh::Shed, arena.addTriangles(shedVerts, sizeof(shedVerts) / stride));
+	setRange(ArenaMesh::Roof, arena.addTriangles(roofVerts, sizeof(roofVerts) / stride));
+	setRange(ArenaMesh::Pyramid, arena.addTriangles(pyramidVerts, sizeof(pyramidVerts) / stride));
+
+	for (int level = 0; level < NUM_LOD_LEVELS; level++)
+	{
+		const auto setLevelRange = [ranges, level](ArenaMesh mesh, const GeometryArena::MeshRange& range) {
+			ranges[static_cast<int>(mesh)][level] = range;
+		};
+
+		setLevelRange(ArenaMesh::Firepit, arena.addMesh(_firepit.getLevel(level)));
+		setLevelRange(ArenaMesh::FirepitRim, arena.addMesh(_firepitRim.getLevel(level)));
+		setLevelRange(ArenaMesh::Knob, addSphere(arena, _knob.getLevel(level)));
+		setLevelRange(ArenaMesh::ChairPost, arena.addMesh(_blueChairPosts.lod.getLevel(level)));
+		setLevelRange(ArenaMesh::ChairLeg, arena.addMesh(_chairLegs.lod.getLevel(level)));
+		setLevelRange(ArenaMesh::Trunk, arena.addMesh(_trunks.lod.getLevel(level)));
+	}
+}
+
+GeometryArena::MeshRange SceneResources::addSphere(GeometryArena& arena, const Sphere& sphere)
+{
+	// Sphere vertices are position (x, y, z) and tex coord (s, t)
+	const auto& sphereVertices = sphere.GetVertices();
+	std::vector<GeometryArena::Vertex> vertices(sphereVertices.size() / 5);
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const auto vertex = sphereVertices.data() + i * 5;
+		vertices[i].position = glm::vec3(vertex[0], vertex[1], vertex[2]);
+		vertices[i].normal = glm::normalize(vertices[i].position);
+		vertices[i].texCoord = glm::vec2(vertex[3], vertex[4]);
+	}
+
+	const auto& sphereIndices = sphere.GetIndices();
+	const std::vector<GLuint> indices(sphereIndices.begin(), sphereIndices.end());
+	return arena.addMesh(vertices, indices);
+}
+
+SceneResources::InstancedLod SceneResources::createInstances(static_meshes_3D::MeshLod<static_meshes_3D::Cylinder> lod,
+	const std::vector<glm::vec3>& positions)
+{
+	std::vector<glm::mat4> modelMatrices;
+	for (const auto& position : positions) {
+		modelMatrices.push_back(glm::translate(position));
+	}
+
+	InstancedLod result;
+	for (int level = 0; level < lod.getNumLevels(); level++)
+	{
+		result.levels.push_back(std::make_unique<static_meshes_3D::InstancedMesh>(lod.getSharedLevel(level)));
+		result.levels.back()->setInstances(modelMatrices);
+	}
+
+	result.lod = std::move(lod);
+	return result;
+}
+
+void SceneResources::deleteMesh(MeshHandle& mesh)
+{
+	GpuObjectCounter::deleteVertexArrays(1, &mesh.vao);
+	GpuObjectCounter::deleteBuffers(1, &mesh.vbo);
+	mesh = MeshHandle();
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+// STL
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Project
+#include "meshRegistry.h"
+#include "common/assetPack.h"
+#include "common/geometryArena.h"
+#include "common/indirectDrawList.h"
+#include "common/instancedMesh.h"
+#include "common/meshLod.h"
+
+/**
+	Owns the static scene geometry (plane, shed, roof, pyramid and the parametric meshes) on the GPU.
+	All VAOs / VBOs are built once at startup and released at shutdown,
+	the render loop only binds the handles.
+	Parametric meshes come in levels of detail of NUM_LOD_LEVELS slice counts, selected per object by screen size.
+*/
+class SceneResources
+{
+public:
+	/**
+	* Handle of one static triangle mesh (position, normal, texture coordinate per vertex).
+	*/
+	struct MeshHandle
+	{
+		GLuint vao = 0; // Vertex array object
+		GLuint vbo = 0; // Vertex buffer object holding interleaved vertex data
+		GLsizei numVertices = 0; // Number of vertices to draw with GL_TRIANGLES
+	};
+
+	/**
+	* Meshes of the scene packed in the geometry arena.
+	*/
+	enum class ArenaMesh
+	{
+		Plane,
+		Shed,
+		Roof,
+		Pyramid,
+		Firepit,
+		FirepitRim,
+		Knob,
+		ChairPost,
+		ChairLeg,
+		Trunk,
+
+		Count
+	};
+
+	static const int NUM_LOD_LEVELS = 4; // Levels of detail of parametric meshes (40, 20, 10 and 5 slices)
+
+	/**
+	* Instances of one prop, with instanced mesh of every level of detail (all levels hold the same instances).
+	*/
+	struct InstancedLod
+	{
+		static_meshes_3D::MeshLod<static_meshes_3D::Cylinder> lod; // Levels of detail of the prop
+		std::vector<std::unique_ptr<static_meshes_3D::InstancedMesh>> levels; // Instances of every level
+
+		/** \brief  Gets instances drawn with given level of detail (clamped to the existing levels). */
+		const static_meshes_3D::InstancedMesh& getLevel(int level) const;
+
+		/** \brief  Gets model matrices of all instances. */
+		const std::vector<glm::mat4>& getModelMatrices() const;
+	};
+
+	~SceneResources();
+
+	/** \brief  Creates and uploads all static meshes of the scene.
+	*   \param  assetPack   Pack with baked geometry arena, uploaded straight from its mapped pages (built at runtime if missing)
+	*   \param  shareMeshes Share parametric meshes with identical geometry (disabled only to measure what sharing saves)
+	*   \return True if successful or false otherwise.
+	*/
+	bool create(const AssetPack* assetPack = nullptr, bool shareMeshes = true);
+
+	/** \brief  Builds geometry arena content of created scene into asset pack entries.
+	*   \param  entries Receives the arena entries
+	*/
+	void bake(std::vector<AssetPack::EntryData>& entries) const;
+
+	/** \brief  Deletes all OpenGL objects owned by the scene. */
+	void destroy();
+
+	const MeshHandle& getPlane() const;
+	const MeshHandle& getShed() const;
+	const MeshHandle& getRoof() const;
+	const MeshHandle& getPyramid() const;
+
+	const InstancedLod& getBlueChairPosts() const;
+	const InstancedLod& getRedChairPosts() const;
+	const InstancedLod& getChairLegs() const;
+	const InstancedLod& getTrunks() const;
+	const static_meshes_3D::MeshLod<static_meshes_3D::CylinderIndexed>& getFirepit() const;
+	const static_meshes_3D::MeshLod<static_meshes_3D::TubeIndexed>& getFirepitRim() const;
+	const static_meshes_3D::MeshLod<Sphere>& getKnob() const;
+	const static_meshes_3D::MeshLod<Sphere>& getMoon() const;
+
+	/** \brief  Gets arena holding all static meshes in one vertex and index buffer. */
+	const GeometryArena& getArena() const;
+
+	/** \brief  Gets range of a mesh in the geometry arena.
+	*   \param  mesh  Mesh of the scene
+	*   \param  level Level of detail (meshes without levels have the same range at every level)
+	*/
+	const GeometryArena::MeshRange& getArenaMesh(ArenaMesh mesh, int level = 0) const;
+
+	/** \brief  Gets all levels of detail of a mesh in the geometry arena, with their selector (single level for meshes without levels). */
+	IndirectDrawList::LodMesh getArenaLod(ArenaMesh mesh) const;
+
+	/** \brief  Gets registry holding the parametric meshes (for hit / miss statistics). */
+	const static_meshes_3D::MeshRegistry& getMeshRegistry() const;
+
+	/** \brief  Gets number of OpenGL objects (VAOs + VBOs) of the static meshes currently owned.
+	*   \return Number of live OpenGL objects.
+	*/
+	int getGpuObjectCount() const;
+
+private:
+	MeshHandle _plane;
+	MeshHandle _shed;
+	MeshHandle _roof;
+	MeshHandle _pyramid;
+
+	static_meshes_3D::MeshRegistry _meshRegistry; // Shares parametric meshes with identical geometry
+	InstancedLod _blueChairPosts; // Back posts of the blue chair
+	InstancedLod _redChairPosts; // Back posts of the red chair
+	InstancedLod _chairLegs; // Legs of both chairs
+	InstancedLod _trunks; // Tree trunks
+	static_meshes_3D::MeshLod<static_meshes_3D::CylinderIndexed> _firepit; // Drawn alone, indexed so that it's one draw call
+	static_meshes_3D::MeshLod<static_meshes_3D::TubeIndexed> _firepitRim;
+	static_meshes_3D::MeshLod<Sphere> _knob;
+	static_meshes_3D::MeshLod<Sphere> _moon;
+
+	using ArenaMeshLevels = GeometryArena::MeshRange[NUM_LOD_LEVELS];
+	GeometryArena _arena; // All static meshes in shared buffers, for multi-draw rendering
+	ArenaMeshLevels _arenaMeshes[static_cast<int>(ArenaMesh::Count)]; // Ranges of every level of meshes in the arena
+
+	bool _isCreated = false;
+
+	/** \brief  Uploads geometry arena from asset pack, or packs all static meshes into it and uploads it. */
+	bool createArena(const AssetPack* assetPack);
+
+	/** \brief  Adds all static meshes to geometry arena (not uploaded yet).
+	*   \param  arena  Arena to add the meshes to
+	*   \param  ranges Receives ranges of every level of every ArenaMesh
+	*/
+	void addArenaMeshes(GeometryArena& arena, ArenaMeshLevels* ranges) const;
+
+	/** \brief  Adds sphere to the geometry arena (its normals point away from the center). */
+	static GeometryArena::MeshRange addSphere(GeometryArena& arena, const Sphere& sphere);
+
+	/** \brief  Uploads interleaved vertex data into a new VAO / VBO pair. */
+	static MeshHandle createMesh(const GLfloat* vertices, GLsizeiptr byteSize);
+
+	/** \brief  Creates instanced meshes of every level with instances placed at given positions. */
+	static InstancedLod createInstances(static_meshes_3D::MeshLod<static_meshes_3D::Cylinder> lod, const std::vector<glm::vec3>& positions);
+
+	/** \brief  Deletes VAO / VBO pair of a mesh. */
+	static void deleteMesh(MeshHandle& mesh);
+};
@@ -0,0 +1,91 @@
+// STL
+#include <iostream>
+#include <vector>
+
+// Project
+#include "common/shaderProgram.h"
+
+namespace {
+
+// Names of known uniforms, in the same order as ShaderUniform enum
+const char* const KNOWN_UNIFORM_NAMES[] = {
+	"model",
+	"normalMatrix",
+	"instanced",
+	"uvScale",
+	"shininess",
+	"light.color",
+	"textureLayer",
+};
+
+static_assert(sizeof(KNOWN_UNIFORM_NAMES) / sizeof(KNOWN_UNIFORM_NAMES[0]) == static_cast<size_t>(ShaderUniform::Count),
+	"Every known uniform needs its name");
+
+} // namespace
+
+ShaderProgram::ShaderProgram()
+{
+	for (auto& location : _knownLocations) {
+		location = -1;
+	}
+}
+
+void ShaderProgram::reflectProgram(GLuint programId)
+{
+	_programID = programId;
+	_uniformLocations.clear();
+
+	GLint numUniforms = 0;
+	GLint maxNameLength = 0;
+	glGetProgramInterfaceiv(programId, GL_UNIFORM, GL_ACTIVE_RESOURCES, &numUniforms);
+	glGetProgramInterfaceiv(programId, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+
+	std::vector<GLchar> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+	const GLenum locationProperty = GL_LOCATION;
+	for (GLint i = 0; i < numUniforms; i++)
+	{
+		// Uniforms living in uniform blocks don't have locations
+		GLint location = -1;
+		glGetProgramResourceiv(programId, GL_UNIFORM, i, 1, &locationProperty, 1, nullptr, &location);
+		if (location < 0) {
+			continue;
+		}
+
+		GLsizei nameLength = 0;
+		glGetProgramResourceName(programId, GL_UNIFORM, i, GLsizei(nameBuffer.size()), &nameLength, nameBuffer.data());
+		std::string name(nameBuffer.data(), nameLength);
+		_uniformLocations[name] = location;
+
+		// Arrays are reported as "name[0]", make them reachable by their base name too
+		if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+			_uniformLocations[name.substr(0, name.size() - 3)] = location;
+		}
+	}
+
+	for (int i = 0; i < static_cast<int>(ShaderUniform::Count); i++) {
+		_knownLocations[i] = getUniformLocation(KNOWN_UNIFORM_NAMES[i]);
+	}
+
+	std::cout << "Reflected shader program with ID " << _programID << ", found " << _uniformLocations.size() << " active uniforms" << std::endl;
+}
+
+GLuint ShaderProgram::getProgramID() const
+{
+	return _programID;
+}
+
+GLint ShaderProgram::getUniformLocation(const std::string& name) const
+{
+	const auto it = _uniformLocations.find(name);
+	return it != _uniformLocations.end() ? it->second : -1;
+}
+
+int ShaderProgram::getNumActiveUniforms() const
+{
+	return static_cast<int>(_uniformLocations.size());
+}
+
+const char* ShaderProgram::getUniformName(ShaderUniform uniform)
+{
+	return KNOWN_UNIFORM_NAMES[static_cast<int>(uniform)];
+}
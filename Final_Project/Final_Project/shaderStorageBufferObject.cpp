@@ -0,0 +1,97 @@
+// STL
+#include <iostream>
+
+// Project
+#include "common/shaderStorageBufferObject.h"
+#include "common/gpuObjectCounter.h"
+
+void ShaderStorageBufferObject::createSSBO(size_t byteSize, GLenum usageHint)
+{
+	if (_isBufferCreated)
+	{
+		std::cerr << "This shader storage buffer is already created! You need to delete it before re-creating it!" << std::endl;
+		return;
+	}
+
+	GpuObjectCounter::genBuffers(1, &_bufferID);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, byteSize, nullptr, usageHint);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	_bufferSize = byteSize;
+	_usageHint = usageHint;
+
+	std::cout << "Created shader storage buffer object with ID " << _bufferID << " and size " << _bufferSize << " bytes" << std::endl;
+	_isBufferCreated = true;
+}
+
+bool ShaderStorageBufferObject::reserve(size_t byteSize)
+{
+	if (!_isBufferCreated)
+	{
+		std::cerr << "This shader storage buffer is not created yet! Call createSSBO before reserving its storage!" << std::endl;
+		return false;
+	}
+
+	if (byteSize <= _bufferSize) {
+		return false;
+	}
+
+	// Grow geometrically, so that adding items one by one doesn't reallocate every time
+	auto newSize = _bufferSize * 2;
+	if (newSize < byteSize) {
+		newSize = byteSize;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, newSize, nullptr, _usageHint);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	_bufferSize = newSize;
+	return true;
+}
+
+void ShaderStorageBufferObject::setData(const void* ptrData, size_t dataSizeBytes, size_t offsetBytes)
+{
+	if (!_isBufferCreated)
+	{
+		std::cerr << "This shader storage buffer is not created yet! Call createSSBO before setting its data!" << std::endl;
+		return;
+	}
+
+	if (offsetBytes + dataSizeBytes > _bufferSize)
+	{
+		std::cerr << "Shader storage buffer data (" << offsetBytes + dataSizeBytes << " bytes) don't fit into buffer of size " << _bufferSize << " bytes!" << std::endl;
+		return;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, _bufferID);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, offsetBytes, dataSizeBytes, ptrData);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void ShaderStorageBufferObject::bindBufferBase(GLuint bindingPoint) const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingPoint, _bufferID);
+}
+
+GLuint ShaderStorageBufferObject::getBufferID() const
+{
+	return _bufferID;
+}
+
+size_t ShaderStorageBufferObject::getBufferSize() const
+{
+	return _bufferSize;
+}
+
+void ShaderStorageBufferObject::deleteSSBO()
+{
+	if (!_isBufferCreated) {
+		return;
+	}
+
+	std::cout << "Deleting shader storage buffer object with ID " << _bufferID << "..." << std::endl;
+	GpuObjectCounter::deleteBuffers(1, &_bufferID);
+	_bufferID = 0;
+	_bufferSize = 0;
+	_isBufferCreated = false;
+}
@@ -2,6 +2,7 @@
 
 // Project
 #include "common/staticMesh3D.h"
+#include "common/gpuObjectCounter.h"
 #include <glm/glm.hpp>
 
 
@@ -11,10 +12,11 @@ const int StaticMesh3D::POSITION_ATTRIBUTE_INDEX           = 0;
 const int StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX = 1;
 const int StaticMesh3D::NORMAL_ATTRIBUTE_INDEX             = 2;
 
-StaticMesh3D::StaticMesh3D(bool withPositions, bool withTextureCoordinates, bool withNormals)
+StaticMesh3D::StaticMesh3D(bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout, const VertexEncoding& encoding)
     : _hasPositions(withPositions)
     , _hasTextureCoordinates(withTextureCoordinates)
-    , _hasNormals(withNormals) {}
+    , _hasNormals(withNormals)
+    , _vertexFormat(withPositions, withTextureCoordinates, withNormals, layout, encoding) {}
 
 StaticMesh3D::~StaticMesh3D()
 {
@@ -27,7 +29,7 @@ void StaticMesh3D::deleteMesh()
         return;
     }
 
-    glDeleteVertexArrays(1, &_vao);
+    GpuObjectCounter::deleteVertexArrays(1, &_vao);
     _vbo.deleteVBO();
 
     _isInitialized = false;
@@ -48,48 +50,55 @@ bool StaticMesh3D::hasNormals() const
     return _hasNormals;
 }
 
+GLuint StaticMesh3D::getVAO() const
+{
+    return _vao;
+}
+
 int StaticMesh3D::getVertexByteSize() const
 {
-    int result = 0;
-    if (hasPositions()) {
-        result += sizeof(glm::vec3);
-    }
-    if (hasTextureCoordinates()) {
-        result += sizeof(glm::vec2);
-    }
-    if (hasNormals()) {
-        result += sizeof(glm::vec3);
-    }
+    return _vertexFormat.getVertexByteSize();
+}
 
-    return result;
+const VertexFormat& StaticMesh3D::getVertexFormat() const
+{
+    return _vertexFormat;
 }
 
 void StaticMesh3D::setVertexAttributesPointers(int numVertices)
 {
-    uint64_t offset = 0;
-    if (hasPositions())
-    {
-        glEnableVertexAttribArray(POSITION_ATTRIBUTE_INDEX);
-        glVertexAttribPointer(POSITION_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), reinterpret_cast<void*>(offset));
+    _numVBOVertices = numVertices;
+    setupVertexAttributes();
+}
 
-        offset += sizeof(glm::vec3)*numVertices;
-    }
+void StaticMesh3D::uploadVertexData(int numVertices, const std::vector<glm::vec3>& positions, const std::vector<glm::vec2>& texCoords, const std::vector<glm::vec3>& normals)
+{
+    // Packed vertices are taken over by the VBO, so they are not copied once more before the upload
+    _vbo.adoptData(_vertexFormat.packVertices(numVertices, positions.data(), texCoords.data(), normals.data()));
+    _vbo.bindVBO();
+    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
+    setVertexAttributesPointers(numVertices);
+}
 
-    if (hasTextureCoordinates())
+void StaticMesh3D::readVertexData(std::vector<glm::vec3>& positions, std::vector<glm::vec2>& texCoords, std::vector<glm::vec3>& normals) const
+{
+    // Whole buffer is read at once, vertex format then picks the attributes out of it in any layout
+    const auto numVertices = _numVBOVertices;
+    std::vector<unsigned char> data(size_t(getVertexByteSize()) * numVertices);
+    if (!data.empty())
     {
-        glEnableVertexAttribArray(TEXTURE_COORDINATE_ATTRIBUTE_INDEX);
-        glVertexAttribPointer(TEXTURE_COORDINATE_ATTRIBUTE_INDEX, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), reinterpret_cast<void*>(offset));
-
-        offset += sizeof(glm::vec2)*numVertices;
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo.getBufferID());
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, data.size(), data.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
-    if (hasNormals())
-    {
-        glEnableVertexAttribArray(NORMAL_ATTRIBUTE_INDEX);
-        glVertexAttribPointer(NORMAL_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), reinterpret_cast<void*>(offset));
+    _vertexFormat.unpackVertices(data.data(), numVertices, positions, texCoords, normals);
+}
 
-        offset += sizeof(glm::vec3)*numVertices;
-    }
+void StaticMesh3D::setupVertexAttributes() const
+{
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo.getBufferID());
+    _vertexFormat.setupAttributePointers(_numVBOVertices);
 }
 
 } // namespace static_meshes_3D
\ No newline at end of file
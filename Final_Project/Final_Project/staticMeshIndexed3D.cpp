@@ -3,8 +3,9 @@
 
 namespace static_meshes_3D {
 
-StaticMeshIndexed3D::StaticMeshIndexed3D(bool withPositions, bool withTextureCoordinates, bool withNormals)
-    : StaticMesh3D(withPositions, withTextureCoordinates, withNormals) {}
+StaticMeshIndexed3D::StaticMeshIndexed3D(bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout,
+    const VertexEncoding& encoding)
+    : StaticMesh3D(withPositions, withTextureCoordinates, withNormals, layout, encoding) {}
 
 StaticMeshIndexed3D::~StaticMeshIndexed3D()
 {
@@ -14,6 +15,140 @@ StaticMeshIndexed3D::~StaticMeshIndexed3D()
     }
 }
 
+void StaticMeshIndexed3D::render() const
+{
+    if (!_isInitialized) {
+        return;
+    }
+
+    // Whole mesh is one draw call, restart index ends current strip and starts a new one
+    glBindVertexArray(_vao);
+    glEnable(GL_PRIMITIVE_RESTART);
+    glPrimitiveRestartIndex(_primitiveRestartIndex);
+    glDrawElements(_primitiveType, _numIndices, GL_UNSIGNED_INT, nullptr);
+    glDisable(GL_PRIMITIVE_RESTART);
+}
+
+void StaticMeshIndexed3D::renderPoints() const
+{
+    if (!_isInitialized) {
+        return;
+    }
+
+    // Every vertex is stored only once, so all of them can be rendered without indices
+    glBindVertexArray(_vao);
+    glDrawArrays(GL_POINTS, 0, _numVertices);
+}
+
+void StaticMeshIndexed3D::renderInstanced(GLsizei numInstances) const
+{
+    if (!_isInitialized) {
+        return;
+    }
+
+    glEnable(GL_PRIMITIVE_RESTART);
+    glPrimitiveRestartIndex(_primitiveRestartIndex);
+    glDrawElementsInstanced(_primitiveType, _numIndices, GL_UNSIGNED_INT, nullptr, numInstances);
+    glDisable(GL_PRIMITIVE_RESTART);
+}
+
+void StaticMeshIndexed3D::readIndexData(std::vector<GLuint>& indices) const
+{
+    // Copy read target is used, because element array binding would change currently bound VAO
+    indices.resize(_numIndices);
+    if (!indices.empty())
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, _indicesVBO.getBufferID());
+        glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(GLuint) * indices.size(), indices.data());
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+}
+
+void StaticMeshIndexed3D::readTriangleIndices(std::vector<GLuint>& indices) const
+{
+    std::vector<GLuint> meshIndices;
+    readIndexData(meshIndices);
+    if (_primitiveType != GL_TRIANGLE_STRIP)
+    {
+        indices.swap(meshIndices);
+        return;
+    }
+
+    // Every strip starts after restart index, winding alternates from its own start
+    const auto restartIndex = getPrimitiveRestartIndex();
+    indices.clear();
+    size_t stripStart = 0;
+    for (size_t i = 0; i < meshIndices.size(); i++)
+    {
+        if (meshIndices[i] == restartIndex)
+        {
+            stripStart = i + 1;
+            continue;
+        }
+
+        const auto stripPosition = i - stripStart;
+        if (stripPosition < 2) {
+            continue;
+        }
+
+        if (stripPosition % 2 == 0) {
+            indices.insert(indices.end(), { meshIndices[i - 2], meshIndices[i - 1], meshIndices[i] });
+        }
+        else {
+            indices.insert(indices.end(), { meshIndices[i - 1], meshIndices[i - 2], meshIndices[i] });
+        }
+    }
+}
+
+bool StaticMeshIndexed3D::optimize(bool reduceOverdraw, MeshOptimizer::VertexCacheStatistics* before, MeshOptimizer::VertexCacheStatistics* after)
+{
+    if (!_isInitialized || (_primitiveType != GL_TRIANGLES && _primitiveType != GL_TRIANGLE_STRIP)) {
+        return false;
+    }
+
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> texCoords;
+    readVertexData(positions, texCoords, normals);
+    std::vector<GLuint> indices;
+    readTriangleIndices(indices);
+
+    const auto statisticsBefore = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), _numVertices);
+    MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), _numVertices);
+    if (reduceOverdraw) {
+        MeshOptimizer::optimizeOverdraw(indices.data(), indices.size(), positions.data(), _numVertices);
+    }
+    const auto statisticsAfter = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), _numVertices);
+
+    if (before != nullptr) {
+        *before = statisticsBefore;
+    }
+    if (after != nullptr) {
+        *after = statisticsAfter;
+    }
+
+    // Strips reuse vertices well on their own, triangle list with 3 indices per triangle pays off only with fewer transforms
+    if (_primitiveType == GL_TRIANGLE_STRIP && statisticsAfter.numTransformedVertices >= statisticsBefore.numTransformedVertices) {
+        return false;
+    }
+
+    const auto remap = MeshOptimizer::optimizeVertexFetch(indices.data(), indices.size(), _numVertices);
+    MeshOptimizer::remapVertices(positions, remap);
+    MeshOptimizer::remapVertices(texCoords, remap);
+    MeshOptimizer::remapVertices(normals, remap);
+
+    glBindVertexArray(_vao);
+    uploadVertexData(_numVertices, positions, texCoords, normals);
+    uploadIndexData(GL_TRIANGLES, std::move(indices));
+    return true;
+}
+
+void StaticMeshIndexed3D::setupVertexAttributes() const
+{
+    // Index buffer binding is part of VAO state, so VAOs sharing this mesh need it as well
+    StaticMesh3D::setupVertexAttributes();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indicesVBO.getBufferID());
+}
+
 void StaticMeshIndexed3D::deleteMesh()
 {
     if (_isInitialized) {
@@ -22,4 +157,37 @@ void StaticMeshIndexed3D::deleteMesh()
     }
 }
 
+GLenum StaticMeshIndexed3D::getPrimitiveType() const
+{
+    return _primitiveType;
+}
+
+GLuint StaticMeshIndexed3D::getPrimitiveRestartIndex() const
+{
+    return GLuint(_primitiveRestartIndex);
+}
+
+int StaticMeshIndexed3D::getNumVertices() const
+{
+    return _numVertices;
+}
+
+int StaticMeshIndexed3D::getNumIndices() const
+{
+    return _numIndices;
+}
+
+void StaticMeshIndexed3D::uploadIndexData(GLenum primitiveType, std::vector<GLuint>&& indices)
+{
+    _primitiveType = primitiveType;
+    _numIndices = static_cast<int>(indices.size());
+
+    if (!_isInitialized) {
+        _indicesVBO.createVBO();
+    }
+    _indicesVBO.bindVBO(GL_ELEMENT_ARRAY_BUFFER);
+    _indicesVBO.adoptData(std::move(indices));
+    _indicesVBO.uploadDataToGPU(GL_STATIC_DRAW);
+}
+
 } // namespace static_meshes_3D
\ No newline at end of file
@@ -212,6 +212,11 @@ RECENT REVISION HISTORY:
 // you have issues compiling it, you can disable it entirely by
 // defining STBI_NO_SIMD.
 //
+// On x86 with SSE2, the JPEG IDCT, upsampling and color conversion also have
+// AVX2 versions, used when a run-time test finds AVX2; define STBI_NO_AVX2 to
+// leave them out. STBI_JPEG_FAST_BITS sets the size of the Huffman lookup
+// tables (default 10 bits, at most 15).
+//
 // ===========================================================================
 //
 // HDR image support   (disable by defining STBI_NO_HDR)
@@ -354,11 +359,32 @@ extern "C" {
 
 	STBIDEF stbi_uc *stbi_load_from_memory(stbi_uc           const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels);
 	STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *channels_in_file, int desired_channels);
+	// stbi_load_into for an image in memory
+	STBIDEF int stbi_load_into_from_memory(stbi_uc const *buffer, int len, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int desired_channels, int flip_vertically);
+
+	// runs job(job_data, index) for every index in [0, count), possibly on several threads at once, and returns once
+	// all of them have finished; the calling thread should run jobs too, as decoding may itself run on a pool thread
+	typedef void stbi_parallel_for(void *pool, void(*job)(void *job_data, int index), void *job_data, int count);
+
+	// as stbi_load_from_memory / stbi_load_into_from_memory, but JPEGs are decoded by jobs of parallel_for: entropy
+	// decoding is split at restart markers when the image has them, inverse DCT, upsampling and color conversion run
+	// in parallel in any case. Output is identical to the serial decoder's, other formats are decoded as usual
+	STBIDEF stbi_uc *stbi_load_from_memory_parallel(stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels, stbi_parallel_for *parallel_for, void *pool);
+	STBIDEF int stbi_load_into_from_memory_parallel(stbi_uc const *buffer, int len, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int desired_channels, int flip_vertically, stbi_parallel_for *parallel_for, void *pool);
 
 #ifndef STBI_NO_STDIO
 	STBIDEF stbi_uc *stbi_load(char const *filename, int *x, int *y, int *channels_in_file, int desired_channels);
 	STBIDEF stbi_uc *stbi_load_from_file(FILE *f, int *x, int *y, int *channels_in_file, int desired_channels);
 	// for stbi_load_from_file, file pointer is left pointing immediately after image
+
+	// decodes into caller memory of dest_x * dest_y pixels with rows dest_stride bytes apart, fails if the
+	// image has other size (check it with stbi_info first); rows are written bottom-up when flip_vertically
+	// is set. JPEGs are decoded in place, other formats are decoded as usual and copied. Returns 1 on success.
+	STBIDEF int stbi_load_into(char const *filename, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int desired_channels, int flip_vertically);
+
+	// stbi_load and stbi_load_into decoding with stbi_parallel_for, the whole file is read into memory first
+	STBIDEF stbi_uc *stbi_load_parallel(char const *filename, int *x, int *y, int *channels_in_file, int desired_channels, stbi_parallel_for *parallel_for, void *pool);
+	STBIDEF int stbi_load_into_parallel(char const *filename, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int desired_channels, int flip_vertically, stbi_parallel_for *parallel_for, void *pool);
 #endif
 
 #ifndef STBI_NO_GIF
@@ -446,6 +472,10 @@ extern "C" {
 	// or just pass them through "as-is"
 	STBIDEF void stbi_convert_iphone_png_to_rgb(int flag_true_if_should_convert);
 
+	// PNG and zlib decoding use a multi-symbol inflate loop and SSE2 unfiltering by default;
+	// clear this flag to fall back to the plain byte-wise code, e.g. to compare their throughput
+	STBIDEF void stbi_set_png_fast_paths(int flag_true_if_should_use_fast_paths);
+
 	// flip the image vertically, so the first pixel in the output array is the bottom left
 	STBIDEF void stbi_set_flip_vertically_on_load(int flag_true_if_should_flip);
 
@@ -567,12 +597,14 @@ typedef unsigned short stbi__uint16;
 typedef   signed short stbi__int16;
 typedef unsigned int   stbi__uint32;
 typedef   signed int   stbi__int32;
+typedef unsigned __int64 stbi__uint64;
 #else
 #include <stdint.h>
 typedef uint16_t stbi__uint16;
 typedef int16_t  stbi__int16;
 typedef uint32_t stbi__uint32;
 typedef int32_t  stbi__int32;
+typedef uint64_t stbi__uint64;
 #endif
 
 // should produce compiler error if size is wrong
@@ -674,7 +706,7 @@ static int stbi__cpuid3(void)
 
 #define STBI_SIMD_ALIGN(type, name) __declspec(align(16)) type name
 
-#if !defined(STBI_NO_JPEG) && defined(STBI_SSE2)
+#if (!defined(STBI_NO_JPEG) || !defined(STBI_NO_PNG)) && defined(STBI_SSE2)
 static int stbi__sse2_available(void)
 {
 	int info3 = stbi__cpuid3();
@@ -685,7 +717,7 @@ static int stbi__sse2_available(void)
 #else // assume GCC-style if not VC++
 #define STBI_SIMD_ALIGN(type, name) type name __attribute__((aligned(16)))
 
-#if !defined(STBI_NO_JPEG) && defined(STBI_SSE2)
+#if (!defined(STBI_NO_JPEG) || !defined(STBI_NO_PNG)) && defined(STBI_SSE2)
 static int stbi__sse2_available(void)
 {
 	// If we're even attempting to compile this on GCC/Clang, that means
@@ -698,6 +730,43 @@ static int stbi__sse2_available(void)
 #endif
 #endif
 
+// AVX2 kernels are compiled next to the SSE2 ones, with per-function target attributes
+// on GCC/Clang, and picked at runtime; define STBI_NO_AVX2 to leave them out.
+#if defined(STBI_SSE2) && !defined(STBI_NO_AVX2) && !defined(STBI_NO_JPEG) && (!defined(_MSC_VER) || defined(__clang__) || _MSC_VER >= 1800)
+#define STBI_AVX2
+#include <immintrin.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define STBI__AVX2_TARGET
+static int stbi__avx2_available(void)
+{
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return 0;
+	// OSXSAVE and AVX, and the OS has to save YMM registers on context switches
+	__cpuid(info, 1);
+	if ((info[2] & (3 << 27)) != (3 << 27) || (_xgetbv(0) & 6) != 6) return 0;
+	__cpuidex(info, 7, 0);
+	return (info[1] >> 5) & 1;
+}
+#else
+#include <cpuid.h>
+#define STBI__AVX2_TARGET __attribute__((target("avx2")))
+static int stbi__avx2_available(void)
+{
+	unsigned int a, b, c, d, xcr0, xcr0_hi;
+	if (__get_cpuid_max(0, 0) < 7) return 0;
+	// OSXSAVE and AVX, and the OS has to save YMM registers on context switches
+	__cpuid(1, a, b, c, d);
+	if ((c & (3u << 27)) != (3u << 27)) return 0;
+	__asm__ ("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+	if ((xcr0 & 6) != 6) return 0;
+	__cpuid_count(7, 0, a, b, c, d);
+	return (b >> 5) & 1;
+}
+#endif
+#endif
+
 // ARM NEON
 #if defined(STBI_NO_SIMD) && defined(STBI_NEON)
 #undef STBI_NEON
@@ -733,6 +802,10 @@ typedef struct
 
 	stbi_uc *img_buffer, *img_buffer_end;
 	stbi_uc *img_buffer_original, *img_buffer_original_end;
+
+	// splits decoding across threads when not NULL, set only for memory contexts
+	stbi_parallel_for *parallel_for;
+	void *parallel_pool;
 } stbi__context;
 
 
@@ -743,6 +816,8 @@ static void stbi__start_mem(stbi__context *s, stbi_uc const *buffer, int len)
 {
 	s->io.read = NULL;
 	s->read_from_callbacks = 0;
+	s->parallel_for = NULL;
+	s->parallel_pool = NULL;
 	s->img_buffer = s->img_buffer_original = (stbi_uc *)buffer;
 	s->img_buffer_end = s->img_buffer_original_end = (stbi_uc *)buffer + len;
 }
@@ -754,6 +829,8 @@ static void stbi__start_callbacks(stbi__context *s, stbi_io_callbacks *c, void *
 	s->io_user_data = user;
 	s->buflen = sizeof(s->buffer_start);
 	s->read_from_callbacks = 1;
+	s->parallel_for = NULL;
+	s->parallel_pool = NULL;
 	s->img_buffer_original = s->buffer_start;
 	stbi__refill_buffer(s);
 	s->img_buffer_original_end = s->img_buffer_end;
@@ -1314,6 +1391,15 @@ STBIDEF stbi_uc *stbi_load_from_memory(stbi_uc const *buffer, int len, int *x, i
 	return stbi__load_and_postprocess_8bit(&s, x, y, comp, req_comp);
 }
 
+STBIDEF stbi_uc *stbi_load_from_memory_parallel(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp, stbi_parallel_for *parallel_for, void *pool)
+{
+	stbi__context s;
+	stbi__start_mem(&s, buffer, len);
+	s.parallel_for = parallel_for;
+	s.parallel_pool = pool;
+	return stbi__load_and_postprocess_8bit(&s, x, y, comp, req_comp);
+}
+
 STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
 {
 	stbi__context s;
@@ -1813,7 +1899,10 @@ static stbi_uc *stbi__hdr_to_ldr(float   *data, int x, int y, int comp)
 #ifndef STBI_NO_JPEG
 
 // huffman decoding acceleration
-#define FAST_BITS   9  // larger handles more cases; smaller stomps less cache
+#ifndef STBI_JPEG_FAST_BITS
+#define STBI_JPEG_FAST_BITS 10 // larger handles more cases; smaller stomps less cache (at most 15)
+#endif
+#define FAST_BITS   STBI_JPEG_FAST_BITS
 
 typedef struct
 {
@@ -1878,6 +1967,12 @@ typedef struct
 	void(*idct_block_kernel)(stbi_uc *out, int out_stride, short data[64]);
 	void(*YCbCr_to_RGB_kernel)(stbi_uc *out, const stbi_uc *y, const stbi_uc *pcb, const stbi_uc *pcr, int count, int step);
 	stbi_uc *(*resample_row_hv_2_kernel)(stbi_uc *out, stbi_uc *in_near, stbi_uc *in_far, int w, int hs);
+	stbi_uc *(*resample_row_h_2_kernel)(stbi_uc *out, stbi_uc *in_near, stbi_uc *in_far, int w, int hs);
+
+	// caller-provided output (stbi_load_into), NULL to allocate it
+	stbi_uc *dest;
+	int dest_x, dest_y, dest_stride;
+	int dest_flip;
 } stbi__jpeg;
 
 static int stbi__build_huffman(stbi__huffman *h, int *count)
@@ -2579,6 +2674,184 @@ static void stbi__idct_simd(stbi_uc *out, int out_stride, short data[64])
 #undef dct_pass
 }
 
+#ifdef STBI_AVX2
+
+// same transform as stbi__idct_simd, but every row is one register of eight 32-bit columns,
+// so both halves of a row go through one multiply-add, and the 16-bit pairs the multiply-adds
+// take are blended within lanes rather than shuffled. Results are identical to the SSE2 ones.
+STBI__AVX2_TARGET static void stbi__idct_avx2(stbi_uc *out, int out_stride, short data[64])
+{
+	__m256i row0, row1, row2, row3, row4, row5, row6, row7;
+
+	// dot product constant: even elems=x, odd elems=y
+#define dct_const(x,y)  _mm256_setr_epi16((x),(y),(x),(y),(x),(y),(x),(y),(x),(y),(x),(y),(x),(y),(x),(y))
+
+// low 16 bits of x and y as pairs (wrapping, like 16-bit adds in stbi__idct_simd)
+#define dct_pair(x,y) _mm256_blend_epi16((x), _mm256_slli_epi32((y), 16), 0xaa)
+
+// out0 = c0[even]*x + c0[odd]*y, out1 = c1[even]*x + c1[odd]*y
+#define dct_rot(out0,out1, x,y,c0,c1) \
+      __m256i c0##xy = dct_pair(x, y); \
+      __m256i out0 = _mm256_madd_epi16(c0##xy, c0); \
+      __m256i out1 = _mm256_madd_epi16(c0##xy, c1)
+
+   // out = (16-bit) in << 12
+#define dct_widen(out, in) \
+      __m256i out = _mm256_srai_epi32(_mm256_slli_epi32((in), 16), 4)
+
+   // butterfly a/b, add bias, then shift by "s"
+#define dct_bfly32o(out0, out1, a,b,bias,s) \
+      { \
+         __m256i abiased = _mm256_add_epi32(a, bias); \
+         out0 = _mm256_srai_epi32(_mm256_add_epi32(abiased, b), s); \
+         out1 = _mm256_srai_epi32(_mm256_sub_epi32(abiased, b), s); \
+      }
+
+#define dct_pass(bias,shift) \
+      { \
+         /* even part */ \
+         dct_rot(t2e,t3e, row2,row6, rot0_0,rot0_1); \
+         dct_widen(t0e, _mm256_add_epi32(row0, row4)); \
+         dct_widen(t1e, _mm256_sub_epi32(row0, row4)); \
+         __m256i x0 = _mm256_add_epi32(t0e, t3e); \
+         __m256i x3 = _mm256_sub_epi32(t0e, t3e); \
+         __m256i x1 = _mm256_add_epi32(t1e, t2e); \
+         __m256i x2 = _mm256_sub_epi32(t1e, t2e); \
+         /* odd part */ \
+         dct_rot(y0o,y2o, row7,row3, rot2_0,rot2_1); \
+         dct_rot(y1o,y3o, row5,row1, rot3_0,rot3_1); \
+         __m256i sum17 = _mm256_add_epi32(row1, row7); \
+         __m256i sum35 = _mm256_add_epi32(row3, row5); \
+         dct_rot(y4o,y5o, sum17,sum35, rot1_0,rot1_1); \
+         __m256i x4 = _mm256_add_epi32(y0o, y4o); \
+         __m256i x5 = _mm256_add_epi32(y1o, y5o); \
+         __m256i x6 = _mm256_add_epi32(y2o, y5o); \
+         __m256i x7 = _mm256_add_epi32(y3o, y4o); \
+         dct_bfly32o(row0,row7, x0,x7,bias,shift); \
+         dct_bfly32o(row1,row6, x1,x6,bias,shift); \
+         dct_bfly32o(row2,row5, x2,x5,bias,shift); \
+         dct_bfly32o(row3,row4, x3,x4,bias,shift); \
+      }
+
+   // saturate to 16 bits, like the packs between the passes of stbi__idct_simd
+#define dct_saturate16(x) \
+      x = _mm256_max_epi32(_mm256_min_epi32(x, max16), min16)
+
+   // 32-bit interleave step (for transposes)
+#define dct_interleave(a, b, lo, hi) \
+      { \
+         __m256i tmp = a; \
+         a = lo(a, b); \
+         b = hi(tmp, b); \
+      }
+
+	__m256i rot0_0 = dct_const(stbi__f2f(0.5411961f), stbi__f2f(0.5411961f) + stbi__f2f(-1.847759065f));
+	__m256i rot0_1 = dct_const(stbi__f2f(0.5411961f) + stbi__f2f(0.765366865f), stbi__f2f(0.5411961f));
+	__m256i rot1_0 = dct_const(stbi__f2f(1.175875602f) + stbi__f2f(-0.899976223f), stbi__f2f(1.175875602f));
+	__m256i rot1_1 = dct_const(stbi__f2f(1.175875602f), stbi__f2f(1.175875602f) + stbi__f2f(-2.562915447f));
+	__m256i rot2_0 = dct_const(stbi__f2f(-1.961570560f) + stbi__f2f(0.298631336f), stbi__f2f(-1.961570560f));
+	__m256i rot2_1 = dct_const(stbi__f2f(-1.961570560f), stbi__f2f(-1.961570560f) + stbi__f2f(3.072711026f));
+	__m256i rot3_0 = dct_const(stbi__f2f(-0.390180644f) + stbi__f2f(2.053119869f), stbi__f2f(-0.390180644f));
+	__m256i rot3_1 = dct_const(stbi__f2f(-0.390180644f), stbi__f2f(-0.390180644f) + stbi__f2f(1.501321110f));
+	__m256i max16 = _mm256_set1_epi32(32767);
+	__m256i min16 = _mm256_set1_epi32(-32768);
+
+	// rounding biases in column/row passes, see stbi__idct_block for explanation.
+	__m256i bias_0 = _mm256_set1_epi32(512);
+	__m256i bias_1 = _mm256_set1_epi32(65536 + (128 << 17));
+
+	// load and widen
+	row0 = _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *) (data + 0 * 8)));
+	row1 = _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *) (data + 1 * 8)));
+	row2 = _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *) (data + 2 * 8)));
+	row3 = _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *) (data + 3 * 8)));
+	row4 = _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *) (data + 4 * 8)));
+	row5 = _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *) (data + 5 * 8)));
+	row6 = _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *) (data + 6 * 8)));
+	row7 = _mm256_cvtepi16_epi32(_mm_load_si128((const __m128i *) (data + 7 * 8)));
+
+	// column pass
+	dct_pass(bias_0, 10);
+
+	{
+		dct_saturate16(row0);
+		dct_saturate16(row1);
+		dct_saturate16(row2);
+		dct_saturate16(row3);
+		dct_saturate16(row4);
+		dct_saturate16(row5);
+		dct_saturate16(row6);
+		dct_saturate16(row7);
+
+		// 32bit 8x8 transpose: pairs, then quads within lanes, then lanes
+		dct_interleave(row0, row1, _mm256_unpacklo_epi32, _mm256_unpackhi_epi32);
+		dct_interleave(row2, row3, _mm256_unpacklo_epi32, _mm256_unpackhi_epi32);
+		dct_interleave(row4, row5, _mm256_unpacklo_epi32, _mm256_unpackhi_epi32);
+		dct_interleave(row6, row7, _mm256_unpacklo_epi32, _mm256_unpackhi_epi32);
+
+		dct_interleave(row0, row2, _mm256_unpacklo_epi64, _mm256_unpackhi_epi64);
+		dct_interleave(row1, row3, _mm256_unpacklo_epi64, _mm256_unpackhi_epi64);
+		dct_interleave(row4, row6, _mm256_unpacklo_epi64, _mm256_unpackhi_epi64);
+		dct_interleave(row5, row7, _mm256_unpacklo_epi64, _mm256_unpackhi_epi64);
+
+		{
+			__m256i c0 = _mm256_permute2x128_si256(row0, row4, 0x20);
+			__m256i c1 = _mm256_permute2x128_si256(row2, row6, 0x20);
+			__m256i c2 = _mm256_permute2x128_si256(row1, row5, 0x20);
+			__m256i c3 = _mm256_permute2x128_si256(row3, row7, 0x20);
+			__m256i c4 = _mm256_permute2x128_si256(row0, row4, 0x31);
+			__m256i c5 = _mm256_permute2x128_si256(row2, row6, 0x31);
+			__m256i c6 = _mm256_permute2x128_si256(row1, row5, 0x31);
+			__m256i c7 = _mm256_permute2x128_si256(row3, row7, 0x31);
+			row0 = c0; row1 = c1; row2 = c2; row3 = c3;
+			row4 = c4; row5 = c5; row6 = c6; row7 = c7;
+		}
+	}
+
+	// row pass
+	dct_pass(bias_1, 17);
+
+	{
+		// pack to bytes, saturating like stbi__idct_simd; each lane then holds a 4x4 block
+		// stored column by column (lane 0: rows 0-3, lane 1: rows 4-7)
+		__m256i transpose4x4 = _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+		                                        0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+		__m256i p0 = _mm256_packus_epi16(_mm256_packs_epi32(row0, row1), _mm256_packs_epi32(row2, row3));
+		__m256i p1 = _mm256_packus_epi16(_mm256_packs_epi32(row4, row5), _mm256_packs_epi32(row6, row7));
+		p0 = _mm256_shuffle_epi8(p0, transpose4x4);
+		p1 = _mm256_shuffle_epi8(p1, transpose4x4);
+
+		{
+			// rows 0, 1 and 4, 5, then rows 2, 3 and 6, 7
+			__m256i r01 = _mm256_unpacklo_epi32(p0, p1);
+			__m256i r23 = _mm256_unpackhi_epi32(p0, p1);
+			__m128i r45 = _mm256_extracti128_si256(r01, 1);
+			__m128i r67 = _mm256_extracti128_si256(r23, 1);
+
+			// store
+			_mm_storel_epi64((__m128i *) out, _mm256_castsi256_si128(r01)); out += out_stride;
+			_mm_storeh_pd((double *) out, _mm_castsi128_pd(_mm256_castsi256_si128(r01))); out += out_stride;
+			_mm_storel_epi64((__m128i *) out, _mm256_castsi256_si128(r23)); out += out_stride;
+			_mm_storeh_pd((double *) out, _mm_castsi128_pd(_mm256_castsi256_si128(r23))); out += out_stride;
+			_mm_storel_epi64((__m128i *) out, r45); out += out_stride;
+			_mm_storeh_pd((double *) out, _mm_castsi128_pd(r45)); out += out_stride;
+			_mm_storel_epi64((__m128i *) out, r67); out += out_stride;
+			_mm_storeh_pd((double *) out, _mm_castsi128_pd(r67));
+		}
+	}
+
+#undef dct_const
+#undef dct_pair
+#undef dct_rot
+#undef dct_widen
+#undef dct_bfly32o
+#undef dct_pass
+#undef dct_saturate16
+#undef dct_interleave
+}
+
+#endif // STBI_AVX2
+
 #endif // STBI_SSE2
 
 #ifdef STBI_NEON
@@ -2823,10 +3096,273 @@ static void stbi__jpeg_reset(stbi__jpeg *j)
 	// since we don't even allow 1<<30 pixels
 }
 
+// parallel decoding of baseline scans (stbi_load_parallel); blocks are decoded in the
+// same order as the serial decoder, so the output is the same too
+#define STBI__JPEG_JOB_BLOCKS   512  // 8x8 blocks per job (64 KB of coefficients)
+#define STBI__JPEG_BATCH_JOBS   8    // transform jobs per batch of decoded MCUs
+#define STBI__JPEG_JOB_PIXELS   65536 // output pixels per resample and color conversion job
+
+// MCUs of one row of the scan, an MCU is a single block in non-interleaved scans
+static int stbi__jpeg_mcus_per_row(stbi__jpeg *z)
+{
+	return z->scan_n == 1 ? (z->img_comp[z->order[0]].x + 7) >> 3 : z->img_mcu_x;
+}
+
+static int stbi__jpeg_num_mcus(stbi__jpeg *z)
+{
+	return z->scan_n == 1 ? stbi__jpeg_mcus_per_row(z) * ((z->img_comp[z->order[0]].y + 7) >> 3) : z->img_mcu_x * z->img_mcu_y;
+}
+
+static int stbi__jpeg_blocks_per_mcu(stbi__jpeg *z)
+{
+	int k, blocks = 0;
+	if (z->scan_n == 1) return 1;
+	for (k = 0; k < z->scan_n; ++k)
+		blocks += z->img_comp[z->order[k]].h * z->img_comp[z->order[k]].v;
+	return blocks;
+}
+
+// decodes MCU number m of a baseline scan; its blocks are transformed right away when coeff is NULL,
+// otherwise they are left dequantized in coeff, in the order of decoding
+static int stbi__jpeg_decode_mcu(stbi__jpeg *z, int m, int mcus_per_row, short *coeff)
+{
+	STBI_SIMD_ALIGN(short, data[64]);
+	int k, x, y;
+	for (k = 0; k < z->scan_n; ++k) {
+		int n = z->order[k];
+		int ha = z->img_comp[n].ha;
+		int h = z->scan_n == 1 ? 1 : z->img_comp[n].h;
+		int v = z->scan_n == 1 ? 1 : z->img_comp[n].v;
+		for (y = 0; y < v; ++y) {
+			for (x = 0; x < h; ++x) {
+				short *block = coeff ? coeff : data;
+				if (!stbi__jpeg_decode_block(z, block, z->huff_dc + z->img_comp[n].hd, z->huff_ac + ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
+				if (coeff)
+					coeff += 64;
+				else {
+					int x2 = ((m % mcus_per_row) * h + x) * 8;
+					int y2 = ((m / mcus_per_row) * v + y) * 8;
+					z->idct_block_kernel(z->img_comp[n].data + z->img_comp[n].w2*y2 + x2, z->img_comp[n].w2, data);
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+// transforms blocks of MCUs [m, m_end) left in coeff by stbi__jpeg_decode_mcu
+static void stbi__jpeg_idct_mcus(stbi__jpeg *z, int m, int m_end, int mcus_per_row, short *coeff)
+{
+	int k, x, y;
+	for (; m < m_end; ++m) {
+		for (k = 0; k < z->scan_n; ++k) {
+			int n = z->order[k];
+			int h = z->scan_n == 1 ? 1 : z->img_comp[n].h;
+			int v = z->scan_n == 1 ? 1 : z->img_comp[n].v;
+			for (y = 0; y < v; ++y) {
+				for (x = 0; x < h; ++x, coeff += 64) {
+					int x2 = ((m % mcus_per_row) * h + x) * 8;
+					int y2 = ((m / mcus_per_row) * v + y) * 8;
+					z->idct_block_kernel(z->img_comp[n].data + z->img_comp[n].w2*y2 + x2, z->img_comp[n].w2, coeff);
+				}
+			}
+		}
+	}
+}
+
+typedef struct
+{
+	stbi__jpeg *z;
+	stbi_uc **starts; // entropy-coded data of every restart interval, followed by the end of the scan
+	int num_intervals, intervals_per_job;
+	int num_mcus, mcus_per_row;
+	stbi_uc *status; // result of every job: 1 when decoded, 0 on bad data, 2 when an interval has junk after its MCUs
+} stbi__jpeg_interval_jobs;
+
+static void stbi__jpeg_decode_intervals(void *job_data, int index)
+{
+	stbi__jpeg_interval_jobs *jobs = (stbi__jpeg_interval_jobs *)job_data;
+	int k = index * jobs->intervals_per_job;
+	int k_end = k + jobs->intervals_per_job < jobs->num_intervals ? k + jobs->intervals_per_job : jobs->num_intervals;
+	stbi__context s;
+	// every job has its own entropy decoder, reading only its intervals
+	stbi__jpeg *z = (stbi__jpeg *)stbi__malloc(sizeof(stbi__jpeg));
+	jobs->status[index] = 0;
+	if (!z) return;
+	memcpy(z, jobs->z, sizeof(stbi__jpeg));
+	stbi__start_mem(&s, jobs->starts[k], (int)(jobs->starts[k_end] - jobs->starts[k]));
+	z->s = &s;
+	for (; k < k_end; ++k) {
+		int m = k * z->restart_interval;
+		int m_end = m + z->restart_interval < jobs->num_mcus ? m + z->restart_interval : jobs->num_mcus;
+		s.img_buffer = jobs->starts[k];
+		stbi__jpeg_reset(z);
+		for (; m < m_end; ++m)
+			if (!stbi__jpeg_decode_mcu(z, m, jobs->mcus_per_row, NULL)) { STBI_FREE(z); return; }
+		// the serial decoder bails out when the interval doesn't end at its marker
+		if (k + 1 < jobs->num_intervals) {
+			if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
+			if (!STBI__RESTART(z->marker)) { STBI_FREE(z); jobs->status[index] = 2; return; }
+		}
+	}
+	STBI_FREE(z);
+	jobs->status[index] = 1;
+}
+
+// splits the scan at its restart markers and decodes the intervals in parallel;
+// returns -1 if the markers don't match the restart interval, so that the scan is decoded as usual
+static int stbi__jpeg_parse_restart_intervals(stbi__jpeg *z, int num_mcus, int mcus_per_row, int blocks_per_mcu)
+{
+	stbi__jpeg_interval_jobs jobs;
+	stbi_uc *p = z->s->img_buffer, *end = z->s->img_buffer_end, *scan_end = end;
+	int k = 1, num_jobs, result = 1;
+	int marker = STBI__MARKER_none;
+
+	jobs.num_intervals = (num_mcus + z->restart_interval - 1) / z->restart_interval;
+	jobs.intervals_per_job = z->restart_interval * blocks_per_mcu < STBI__JPEG_JOB_BLOCKS ? STBI__JPEG_JOB_BLOCKS / (z->restart_interval * blocks_per_mcu) : 1;
+	num_jobs = (jobs.num_intervals + jobs.intervals_per_job - 1) / jobs.intervals_per_job;
+	if (num_jobs < 2) return -1;
+	jobs.starts = (stbi_uc **)stbi__malloc_mad2(jobs.num_intervals + 1, sizeof(stbi_uc *), 0);
+	if (!jobs.starts) return -1;
+
+	// find the markers, 0xff 0x00 is a stuffed 0xff byte and markers may be preceded by 0xff fill bytes
+	jobs.starts[0] = p;
+	while (p < end) {
+		stbi_uc *q = (stbi_uc *)memchr(p, 0xff, (size_t)(end - p));
+		if (!q) { p = end; break; }
+		p = q + 1;
+		while (p < end && *p == 0xff) ++p;
+		if (p == end) break;
+		if (*p == 0) { ++p; continue; }
+		if (!STBI__RESTART(*p)) { marker = *p++; scan_end = q; break; }
+		if (k == jobs.num_intervals) { k = -1; break; }
+		jobs.starts[k++] = ++p;
+	}
+	if (k != jobs.num_intervals) { STBI_FREE(jobs.starts); return -1; }
+	jobs.starts[jobs.num_intervals] = scan_end;
+
+	jobs.z = z;
+	jobs.num_mcus = num_mcus;
+	jobs.mcus_per_row = mcus_per_row;
+	jobs.status = (stbi_uc *)stbi__malloc(num_jobs);
+	if (!jobs.status) { STBI_FREE(jobs.starts); return -1; }
+	z->s->parallel_for(z->s->parallel_pool, stbi__jpeg_decode_intervals, &jobs, num_jobs);
+	for (k = 0; k < num_jobs && result; ++k) {
+		if (jobs.status[k] == 0) result = stbi__err("bad huffman code", "Corrupt JPEG");
+		if (jobs.status[k] == 2) result = stbi__err("bad restart interval", "Corrupt JPEG");
+	}
+
+	// continue after the scan, as if the serial decoder had read up to its marker
+	z->s->img_buffer = p;
+	z->marker = (unsigned char)marker;
+	z->nomore = 1;
+	STBI_FREE(jobs.status);
+	STBI_FREE(jobs.starts);
+	return result;
+}
+
+typedef struct
+{
+	stbi__jpeg *z;
+	short *coeff[2]; // two batches of MCUs, one decoded while the other one is transformed
+	int first_mcu[2], end_mcu[2];
+	int decode, transform; // batch being decoded (-1 when there's none) and transformed
+	int num_mcus, mcus_per_row, blocks_per_mcu, mcus_per_job;
+	int status; // 0 on error, 2 when the scan ended early
+} stbi__jpeg_pipeline;
+
+// entropy decodes the next batch, counting down the restart interval like the serial decoder
+static void stbi__jpeg_pipeline_decode(stbi__jpeg_pipeline *p)
+{
+	stbi__jpeg *z = p->z;
+	int b = p->decode, m;
+	short *coeff = p->coeff[b];
+	for (m = p->first_mcu[b]; m < p->end_mcu[b]; ++m, coeff += 64 * p->blocks_per_mcu) {
+		if (!stbi__jpeg_decode_mcu(z, m, p->mcus_per_row, coeff)) { p->end_mcu[b] = m; p->status = 0; return; }
+		if (--z->todo <= 0) {
+			if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
+			// if it's NOT a restart, then just bail, so we get corrupt data
+			// rather than no data
+			if (!STBI__RESTART(z->marker)) { p->end_mcu[b] = m + 1; p->status = 2; return; }
+			stbi__jpeg_reset(z);
+		}
+	}
+}
+
+// job 0 decodes the next batch, the others transform parts of the previous one
+static void stbi__jpeg_pipeline_job(void *job_data, int index)
+{
+	stbi__jpeg_pipeline *p = (stbi__jpeg_pipeline *)job_data;
+	int b = p->transform, m, m_end;
+	if (index == 0) {
+		if (p->decode >= 0) stbi__jpeg_pipeline_decode(p);
+		return;
+	}
+	m = p->first_mcu[b] + (index - 1) * p->mcus_per_job;
+	m_end = m + p->mcus_per_job < p->end_mcu[b] ? m + p->mcus_per_job : p->end_mcu[b];
+	stbi__jpeg_idct_mcus(p->z, m, m_end, p->mcus_per_row, p->coeff[b] + (size_t)(m - p->first_mcu[b]) * p->blocks_per_mcu * 64);
+}
+
+// entropy decoding is serial without restart markers, transforms of every batch of MCUs
+// run in parallel while the next batch is being decoded
+static int stbi__jpeg_parse_pipelined(stbi__jpeg *z, int num_mcus, int mcus_per_row, int blocks_per_mcu)
+{
+	stbi__jpeg_pipeline p;
+	int batch_mcus;
+	void *raw_coeff;
+
+	p.mcus_per_job = blocks_per_mcu < STBI__JPEG_JOB_BLOCKS ? STBI__JPEG_JOB_BLOCKS / blocks_per_mcu : 1;
+	if (num_mcus <= 2 * p.mcus_per_job) return -1; // not worth it
+	batch_mcus = p.mcus_per_job * STBI__JPEG_BATCH_JOBS;
+	raw_coeff = stbi__malloc_mad3(2 * batch_mcus, blocks_per_mcu, 64 * sizeof(short), 15);
+	if (!raw_coeff) return -1;
+	p.coeff[0] = (short *)(((size_t)raw_coeff + 15) & ~15);
+	p.coeff[1] = p.coeff[0] + (size_t)batch_mcus * blocks_per_mcu * 64;
+
+	p.z = z;
+	p.num_mcus = num_mcus;
+	p.mcus_per_row = mcus_per_row;
+	p.blocks_per_mcu = blocks_per_mcu;
+	p.status = 1;
+	p.decode = 0;
+	p.first_mcu[0] = 0;
+	p.end_mcu[0] = batch_mcus < num_mcus ? batch_mcus : num_mcus;
+	stbi__jpeg_pipeline_decode(&p);
+	while (p.status) {
+		int next = p.end_mcu[p.decode];
+		p.transform = p.decode;
+		p.decode = p.status == 1 && next < num_mcus ? 1 - p.transform : -1;
+		if (p.decode >= 0) {
+			p.first_mcu[p.decode] = next;
+			p.end_mcu[p.decode] = next + batch_mcus < num_mcus ? next + batch_mcus : num_mcus;
+		}
+		z->s->parallel_for(z->s->parallel_pool, stbi__jpeg_pipeline_job, &p,
+			1 + (p.end_mcu[p.transform] - p.first_mcu[p.transform] + p.mcus_per_job - 1) / p.mcus_per_job);
+		if (p.decode < 0) break;
+	}
+	STBI_FREE(raw_coeff);
+	return p.status ? 1 : stbi__err("bad huffman code", "Corrupt JPEG");
+}
+
+// returns -1 when the scan is better decoded serially
+static int stbi__parse_entropy_coded_data_parallel(stbi__jpeg *z)
+{
+	int num_mcus = stbi__jpeg_num_mcus(z);
+	int mcus_per_row = stbi__jpeg_mcus_per_row(z);
+	int blocks_per_mcu = stbi__jpeg_blocks_per_mcu(z);
+	if (z->restart_interval) {
+		int result = stbi__jpeg_parse_restart_intervals(z, num_mcus, mcus_per_row, blocks_per_mcu);
+		if (result >= 0) return result;
+	}
+	return stbi__jpeg_parse_pipelined(z, num_mcus, mcus_per_row, blocks_per_mcu);
+}
+
 static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
 {
 	stbi__jpeg_reset(z);
 	if (!z->progressive) {
+		int result = z->s->parallel_for ? stbi__parse_entropy_coded_data_parallel(z) : -1;
+		if (result >= 0) return result;
 		if (z->scan_n == 1) {
 			int i, j;
 			STBI_SIMD_ALIGN(short, data[64]);
@@ -2958,21 +3494,50 @@ static void stbi__jpeg_dequantize(short *data, stbi__uint16 *dequant)
 		data[i] *= dequant[i];
 }
 
+// dequantize and idct rows [j, j_end) of blocks of component n
+static void stbi__jpeg_finish_rows(stbi__jpeg *z, int n, int j, int j_end)
+{
+	int i, w = (z->img_comp[n].x + 7) >> 3;
+	for (; j < j_end; ++j) {
+		for (i = 0; i < w; ++i) {
+			short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
+			stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
+			z->idct_block_kernel(z->img_comp[n].data + z->img_comp[n].w2*j * 8 + i * 8, z->img_comp[n].w2, data);
+		}
+	}
+}
+
+typedef struct
+{
+	stbi__jpeg *z;
+	int n, h, rows_per_job;
+} stbi__jpeg_finish_jobs;
+
+static void stbi__jpeg_finish_job(void *job_data, int index)
+{
+	stbi__jpeg_finish_jobs *jobs = (stbi__jpeg_finish_jobs *)job_data;
+	int j = index * jobs->rows_per_job;
+	stbi__jpeg_finish_rows(jobs->z, jobs->n, j, j + jobs->rows_per_job < jobs->h ? j + jobs->rows_per_job : jobs->h);
+}
+
 static void stbi__jpeg_finish(stbi__jpeg *z)
 {
 	if (z->progressive) {
 		// dequantize and idct the data
-		int i, j, n;
+		int n;
 		for (n = 0; n < z->s->img_n; ++n) {
 			int w = (z->img_comp[n].x + 7) >> 3;
 			int h = (z->img_comp[n].y + 7) >> 3;
-			for (j = 0; j < h; ++j) {
-				for (i = 0; i < w; ++i) {
-					short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
-					stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
-					z->idct_block_kernel(z->img_comp[n].data + z->img_comp[n].w2*j * 8 + i * 8, z->img_comp[n].w2, data);
-				}
+			if (z->s->parallel_for && w * h > 2 * STBI__JPEG_JOB_BLOCKS) {
+				stbi__jpeg_finish_jobs jobs;
+				jobs.z = z;
+				jobs.n = n;
+				jobs.h = h;
+				jobs.rows_per_job = w < STBI__JPEG_JOB_BLOCKS ? STBI__JPEG_JOB_BLOCKS / w : 1;
+				z->s->parallel_for(z->s->parallel_pool, stbi__jpeg_finish_job, &jobs, (h + jobs.rows_per_job - 1) / jobs.rows_per_job);
 			}
+			else
+				stbi__jpeg_finish_rows(z, n, 0, h);
 		}
 	}
 }
@@ -3500,6 +4065,108 @@ static stbi_uc *stbi__resample_row_hv_2_simd(stbi_uc *out, stbi_uc *in_near, stb
 }
 #endif
 
+#ifdef STBI_AVX2
+STBI__AVX2_TARGET static stbi_uc *stbi__resample_row_h_2_avx2(stbi_uc *out, stbi_uc *in_near, stbi_uc *in_far, int w, int hs)
+{
+	// same filter as stbi__resample_row_h_2, 16 input pixels at a time
+	int i;
+	stbi_uc *input = in_near;
+
+	if (w == 1) {
+		out[0] = out[1] = input[0];
+		return out;
+	}
+
+	out[0] = input[0];
+	out[1] = stbi__div4(input[0] * 3 + input[1] + 2);
+	// the last pixel of the row has no right neighbour, it's left to the scalar loop
+	for (i = 1; i + 16 < w; i += 16) {
+		__m256i prev = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (input + i - 1)));
+		__m256i curr = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (input + i)));
+		__m256i next = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (input + i + 1)));
+
+		// even pixels = (3*cur + prev + 2) / 4, odd pixels = (3*cur + next + 2) / 4
+		__m256i curb = _mm256_add_epi16(_mm256_add_epi16(_mm256_slli_epi16(curr, 1), curr), _mm256_set1_epi16(2));
+		__m256i even = _mm256_srli_epi16(_mm256_add_epi16(curb, prev), 2);
+		__m256i odd = _mm256_srli_epi16(_mm256_add_epi16(curb, next), 2);
+
+		// interleave within lanes, so that each lane packs to 8 consecutive output pairs
+		__m256i int0 = _mm256_unpacklo_epi16(even, odd);
+		__m256i int1 = _mm256_unpackhi_epi16(even, odd);
+		_mm256_storeu_si256((__m256i *) (out + i * 2), _mm256_packus_epi16(int0, int1));
+	}
+	for (; i < w - 1; ++i) {
+		int n = 3 * input[i] + 2;
+		out[i * 2 + 0] = stbi__div4(n + input[i - 1]);
+		out[i * 2 + 1] = stbi__div4(n + input[i + 1]);
+	}
+	out[i * 2 + 0] = stbi__div4(input[w - 2] * 3 + input[w - 1] + 2);
+	out[i * 2 + 1] = input[w - 1];
+
+	STBI_NOTUSED(in_far);
+	STBI_NOTUSED(hs);
+
+	return out;
+}
+
+STBI__AVX2_TARGET static stbi_uc *stbi__resample_row_hv_2_avx2(stbi_uc *out, stbi_uc *in_near, stbi_uc *in_far, int w, int hs)
+{
+	// same filter as stbi__resample_row_hv_2_simd, 16 input pixels at a time
+	int i = 0, t0, t1;
+
+	if (w == 1) {
+		out[0] = out[1] = stbi__div4(3 * in_near[0] + in_far[0] + 2);
+		return out;
+	}
+
+	t1 = 3 * in_near[0] + in_far[0];
+	// the last pixel of the row needs the filter boundary conditions, it's left to the scalar loop
+	for (; i < ((w - 1) & ~15); i += 16) {
+		// vertical pass, 3*x + y = 4*x + (y - x)
+		__m256i farw = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (in_far + i)));
+		__m256i nearw = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (in_near + i)));
+		__m256i curr = _mm256_add_epi16(_mm256_slli_epi16(nearw, 2), _mm256_sub_epi16(farw, nearw));
+
+		// "prev" is current row shifted right by 1 pixel, with the previous pixel (t1) inserted,
+		// "next" is shifted left by 1 pixel, with first pixel of the next block added in;
+		// the shifts cross the 128-bit lanes, so each lane takes the edge of the other one
+		__m256i prv0 = _mm256_alignr_epi8(curr, _mm256_permute2x128_si256(curr, curr, 0x08), 14);
+		__m256i nxt0 = _mm256_alignr_epi8(_mm256_permute2x128_si256(curr, curr, 0x81), curr, 2);
+		__m256i prev = _mm256_insert_epi16(prv0, t1, 0);
+		__m256i next = _mm256_insert_epi16(nxt0, 3 * in_near[i + 16] + in_far[i + 16], 15);
+
+		// horizontal pass, polyphase: even = cur*4 + (prev - cur), odd = cur*4 + (next - cur)
+		__m256i curb = _mm256_add_epi16(_mm256_slli_epi16(curr, 2), _mm256_set1_epi16(8));
+		__m256i even = _mm256_add_epi16(_mm256_sub_epi16(prev, curr), curb);
+		__m256i odd = _mm256_add_epi16(_mm256_sub_epi16(next, curr), curb);
+
+		// interleave even and odd pixels within lanes, undo scaling, pack and write output
+		__m256i de0 = _mm256_srli_epi16(_mm256_unpacklo_epi16(even, odd), 4);
+		__m256i de1 = _mm256_srli_epi16(_mm256_unpackhi_epi16(even, odd), 4);
+		_mm256_storeu_si256((__m256i *) (out + i * 2), _mm256_packus_epi16(de0, de1));
+
+		// "previous" value for next iter
+		t1 = 3 * in_near[i + 15] + in_far[i + 15];
+	}
+
+	t0 = t1;
+	t1 = 3 * in_near[i] + in_far[i];
+	out[i * 2] = stbi__div16(3 * t1 + t0 + 8);
+
+	for (++i; i < w; ++i) {
+		t0 = t1;
+		t1 = 3 * in_near[i] + in_far[i];
+		out[i * 2 - 1] = stbi__div16(3 * t0 + t1 + 8);
+		out[i * 2] = stbi__div16(3 * t1 + t0 + 8);
+	}
+	out[w * 2 - 1] = stbi__div4(t1 + 2);
+
+	STBI_NOTUSED(hs);
+
+	return out;
+}
+#endif
+
 static stbi_uc *stbi__resample_row_generic(stbi_uc *out, stbi_uc *in_near, stbi_uc *in_far, int w, int hs)
 {
 	// resample with nearest-neighbor
@@ -3674,12 +4341,78 @@ static void stbi__YCbCr_to_RGB_simd(stbi_uc *out, stbi_uc const *y, stbi_uc cons
 }
 #endif
 
+#ifdef STBI_AVX2
+STBI__AVX2_TARGET static void stbi__YCbCr_to_RGB_avx2(stbi_uc *out, stbi_uc const *y, stbi_uc const *pcb, stbi_uc const *pcr, int count, int step)
+{
+	int i = 0;
+
+	// same arithmetic as stbi__YCbCr_to_RGB_simd, 16 pixels at a time; the remainder
+	// and step == 3 are handed over to it
+	if (step == 4) {
+		__m128i signflip = _mm_set1_epi8(-0x80);
+		__m256i cr_const0 = _mm256_set1_epi16((short)(1.40200f*4096.0f + 0.5f));
+		__m256i cr_const1 = _mm256_set1_epi16(-(short)(0.71414f*4096.0f + 0.5f));
+		__m256i cb_const0 = _mm256_set1_epi16(-(short)(0.34414f*4096.0f + 0.5f));
+		__m256i cb_const1 = _mm256_set1_epi16((short)(1.77200f*4096.0f + 0.5f));
+		__m256i y_bias = _mm256_set1_epi16(128);
+		__m256i xw = _mm256_set1_epi16(255); // alpha channel
+
+		for (; i + 15 < count; i += 16) {
+			// load
+			__m128i y_bytes = _mm_loadu_si128((__m128i *) (y + i));
+			__m128i cr_biased = _mm_xor_si128(_mm_loadu_si128((__m128i *) (pcr + i)), signflip); // -128
+			__m128i cb_biased = _mm_xor_si128(_mm_loadu_si128((__m128i *) (pcb + i)), signflip); // -128
+
+			// widen to short, left-shifted by 8 (y gets the same low byte bias as in SSE2)
+			__m256i yw = _mm256_or_si256(_mm256_slli_epi16(_mm256_cvtepu8_epi16(y_bytes), 8), y_bias);
+			__m256i crw = _mm256_slli_epi16(_mm256_cvtepu8_epi16(cr_biased), 8);
+			__m256i cbw = _mm256_slli_epi16(_mm256_cvtepu8_epi16(cb_biased), 8);
+
+			// color transform
+			__m256i yws = _mm256_srli_epi16(yw, 4);
+			__m256i cr0 = _mm256_mulhi_epi16(cr_const0, crw);
+			__m256i cb0 = _mm256_mulhi_epi16(cb_const0, cbw);
+			__m256i cb1 = _mm256_mulhi_epi16(cbw, cb_const1);
+			__m256i cr1 = _mm256_mulhi_epi16(crw, cr_const1);
+			__m256i rws = _mm256_add_epi16(cr0, yws);
+			__m256i gwt = _mm256_add_epi16(cb0, yws);
+			__m256i bws = _mm256_add_epi16(yws, cb1);
+			__m256i gws = _mm256_add_epi16(gwt, cr1);
+
+			// descale
+			__m256i rw = _mm256_srai_epi16(rws, 4);
+			__m256i bw = _mm256_srai_epi16(bws, 4);
+			__m256i gw = _mm256_srai_epi16(gws, 4);
+
+			// back to byte, transpose to interleave channels; every lane holds 8 pixels,
+			// o0 gets pixels 0-3 and 8-11, o1 pixels 4-7 and 12-15
+			__m256i brb = _mm256_packus_epi16(rw, bw);
+			__m256i gxb = _mm256_packus_epi16(gw, xw);
+			__m256i t0 = _mm256_unpacklo_epi8(brb, gxb);
+			__m256i t1 = _mm256_unpackhi_epi8(brb, gxb);
+			__m256i o0 = _mm256_unpacklo_epi16(t0, t1);
+			__m256i o1 = _mm256_unpackhi_epi16(t0, t1);
+
+			// store
+			_mm256_storeu_si256((__m256i *) (out + 0), _mm256_permute2x128_si256(o0, o1, 0x20));
+			_mm256_storeu_si256((__m256i *) (out + 32), _mm256_permute2x128_si256(o0, o1, 0x31));
+			out += 64;
+		}
+	}
+
+	stbi__YCbCr_to_RGB_simd(out, y + i, pcb + i, pcr + i, count - i, step);
+}
+#endif
+
 // set up the kernels
 static void stbi__setup_jpeg(stbi__jpeg *j)
 {
 	j->idct_block_kernel = stbi__idct_block;
 	j->YCbCr_to_RGB_kernel = stbi__YCbCr_to_RGB_row;
 	j->resample_row_hv_2_kernel = stbi__resample_row_hv_2;
+	j->resample_row_h_2_kernel = stbi__resample_row_h_2;
+	j->dest = NULL;
+	j->dest_flip = 0;
 
 #ifdef STBI_SSE2
 	if (stbi__sse2_available()) {
@@ -3689,6 +4422,15 @@ static void stbi__setup_jpeg(stbi__jpeg *j)
 	}
 #endif
 
+#ifdef STBI_AVX2
+	if (stbi__avx2_available()) {
+		j->idct_block_kernel = stbi__idct_avx2;
+		j->YCbCr_to_RGB_kernel = stbi__YCbCr_to_RGB_avx2;
+		j->resample_row_hv_2_kernel = stbi__resample_row_hv_2_avx2;
+		j->resample_row_h_2_kernel = stbi__resample_row_h_2_avx2;
+	}
+#endif
+
 #ifdef STBI_NEON
 	j->idct_block_kernel = stbi__idct_simd;
 	j->YCbCr_to_RGB_kernel = stbi__YCbCr_to_RGB_simd;
@@ -3719,6 +4461,169 @@ static stbi_uc stbi__blinn_8x8(stbi_uc x, stbi_uc y)
 	return (stbi_uc)((t + (t >> 8)) >> 8);
 }
 
+// resamples and color-converts output rows [j, j_end); res_comp holds the resampling state at row j
+// and is advanced along. 3-channel rows are written with 4 bytes per pixel, so they overrun the next
+// row by a byte; rows are converted in rowbuf (n * img_x + 1 bytes) and copied, when that's not safe
+static void stbi__jpeg_output_rows(stbi__jpeg *z, stbi__resample *res_comp, stbi_uc **linebuf, stbi_uc *rowbuf, stbi_uc *output, int n, int decode_n, int is_rgb, unsigned int j, unsigned int j_end)
+{
+	int k;
+	unsigned int i;
+	stbi_uc *coutput[4] = { NULL, NULL, NULL, NULL };
+	for (; j < j_end; ++j) {
+		stbi_uc *out, *row;
+		if (z->dest)
+			row = output + (size_t)z->dest_stride * (z->dest_flip ? z->s->img_y - 1 - j : j);
+		else
+			row = output + n * z->s->img_x * j;
+		out = rowbuf ? rowbuf : row;
+		for (k = 0; k < decode_n; ++k) {
+			stbi__resample *r = &res_comp[k];
+			int y_bot = r->ystep >= (r->vs >> 1);
+			coutput[k] = r->resample(linebuf[k],
+				y_bot ? r->line1 : r->line0,
+				y_bot ? r->line0 : r->line1,
+				r->w_lores, r->hs);
+			if (++r->ystep >= r->vs) {
+				r->ystep = 0;
+				r->line0 = r->line1;
+				if (++r->ypos < z->img_comp[k].y)
+					r->line1 += z->img_comp[k].w2;
+			}
+		}
+		if (n >= 3) {
+			stbi_uc *y = coutput[0];
+			if (z->s->img_n == 3) {
+				if (is_rgb) {
+					for (i = 0; i < z->s->img_x; ++i) {
+						out[0] = y[i];
+						out[1] = coutput[1][i];
+						out[2] = coutput[2][i];
+						out[3] = 255;
+						out += n;
+					}
+				}
+				else {
+					z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+				}
+			}
+			else if (z->s->img_n == 4) {
+				if (z->app14_color_transform == 0) { // CMYK
+					for (i = 0; i < z->s->img_x; ++i) {
+						stbi_uc m = coutput[3][i];
+						out[0] = stbi__blinn_8x8(coutput[0][i], m);
+						out[1] = stbi__blinn_8x8(coutput[1][i], m);
+						out[2] = stbi__blinn_8x8(coutput[2][i], m);
+						out[3] = 255;
+						out += n;
+					}
+				}
+				else if (z->app14_color_transform == 2) { // YCCK
+					z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+					for (i = 0; i < z->s->img_x; ++i) {
+						stbi_uc m = coutput[3][i];
+						out[0] = stbi__blinn_8x8(255 - out[0], m);
+						out[1] = stbi__blinn_8x8(255 - out[1], m);
+						out[2] = stbi__blinn_8x8(255 - out[2], m);
+						out += n;
+					}
+				}
+				else { // YCbCr + alpha?  Ignore the fourth channel for now
+					z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+				}
+			}
+			else
+				for (i = 0; i < z->s->img_x; ++i) {
+					out[0] = out[1] = out[2] = y[i];
+					out[3] = 255; // not used if n==3
+					out += n;
+				}
+		}
+		else {
+			if (is_rgb) {
+				if (n == 1)
+					for (i = 0; i < z->s->img_x; ++i)
+						*out++ = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
+				else {
+					for (i = 0; i < z->s->img_x; ++i, out += 2) {
+						out[0] = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
+						out[1] = 255;
+					}
+				}
+			}
+			else if (z->s->img_n == 4 && z->app14_color_transform == 0) {
+				for (i = 0; i < z->s->img_x; ++i) {
+					stbi_uc m = coutput[3][i];
+					stbi_uc r = stbi__blinn_8x8(coutput[0][i], m);
+					stbi_uc g = stbi__blinn_8x8(coutput[1][i], m);
+					stbi_uc b = stbi__blinn_8x8(coutput[2][i], m);
+					out[0] = stbi__compute_y(r, g, b);
+					out[1] = 255;
+					out += n;
+				}
+			}
+			else if (z->s->img_n == 4 && z->app14_color_transform == 2) {
+				for (i = 0; i < z->s->img_x; ++i) {
+					out[0] = stbi__blinn_8x8(255 - coutput[0][i], coutput[3][i]);
+					out[1] = 255;
+					out += n;
+				}
+			}
+			else {
+				stbi_uc *y = coutput[0];
+				if (n == 1)
+					for (i = 0; i < z->s->img_x; ++i) out[i] = y[i];
+				else
+					for (i = 0; i < z->s->img_x; ++i) { *out++ = y[i]; *out++ = 255; }
+			}
+		}
+		if (rowbuf) memcpy(row, rowbuf, (size_t)n * z->s->img_x);
+	}
+}
+
+// sets resampling state of component k to that of output row j, as if the rows before it had been resampled
+static void stbi__jpeg_resample_seek(stbi__jpeg *z, stbi__resample *r, int k, unsigned int j)
+{
+	int rows = (r->vs >> 1) + (int)j;
+	int last = z->img_comp[k].y - 1;
+	r->ystep = rows % r->vs;
+	r->ypos = rows / r->vs;
+	r->line1 = z->img_comp[k].data + (size_t)z->img_comp[k].w2 * (r->ypos < last ? r->ypos : last);
+	r->line0 = r->ypos == 0 ? z->img_comp[k].data : z->img_comp[k].data + (size_t)z->img_comp[k].w2 * (r->ypos - 1 < last ? r->ypos - 1 : last);
+}
+
+typedef struct
+{
+	stbi__jpeg *z;
+	stbi__resample *res_comp;
+	stbi_uc *output;
+	int n, decode_n, is_rgb;
+	unsigned int rows_per_job;
+	stbi_uc *ok; // result of every job
+} stbi__jpeg_output_jobs;
+
+static void stbi__jpeg_output_job(void *job_data, int index)
+{
+	stbi__jpeg_output_jobs *jobs = (stbi__jpeg_output_jobs *)job_data;
+	stbi__jpeg *z = jobs->z;
+	stbi__resample res_comp[4];
+	stbi_uc *linebuf[4];
+	unsigned int j = (unsigned int)index * jobs->rows_per_job;
+	unsigned int j_end = j + jobs->rows_per_job < z->s->img_y ? j + jobs->rows_per_job : z->s->img_y;
+	int k;
+	// every job has its own line buffers, and a row buffer for 3-channel rows (jobs finish in any order)
+	stbi_uc *buffer = (stbi_uc *)stbi__malloc_mad2(jobs->decode_n + 4, z->s->img_x + 3, 0);
+	jobs->ok[index] = buffer != NULL;
+	if (!buffer) return;
+	for (k = 0; k < jobs->decode_n; ++k) {
+		res_comp[k] = jobs->res_comp[k];
+		stbi__jpeg_resample_seek(z, &res_comp[k], k, j);
+		linebuf[k] = buffer + (size_t)k * (z->s->img_x + 3);
+	}
+	stbi__jpeg_output_rows(z, res_comp, linebuf, jobs->n == 3 ? buffer + (size_t)jobs->decode_n * (z->s->img_x + 3) : NULL,
+		jobs->output, jobs->n, jobs->decode_n, jobs->is_rgb, j, j_end);
+	STBI_FREE(buffer);
+}
+
 static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp, int req_comp)
 {
 	int n, decode_n, is_rgb;
@@ -3743,10 +4648,8 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
 	// resample and color-convert
 	{
 		int k;
-		unsigned int i, j;
+		unsigned int rows_per_job;
 		stbi_uc *output;
-		stbi_uc *coutput[4] = { NULL, NULL, NULL, NULL };
-
 		stbi__resample res_comp[4];
 
 		for (k = 0; k < decode_n; ++k) {
@@ -3766,118 +4669,53 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
 
 			if (r->hs == 1 && r->vs == 1) r->resample = resample_row_1;
 			else if (r->hs == 1 && r->vs == 2) r->resample = stbi__resample_row_v_2;
-			else if (r->hs == 2 && r->vs == 1) r->resample = stbi__resample_row_h_2;
+			else if (r->hs == 2 && r->vs == 1) r->resample = z->resample_row_h_2_kernel;
 			else if (r->hs == 2 && r->vs == 2) r->resample = z->resample_row_hv_2_kernel;
 			else                               r->resample = stbi__resample_row_generic;
 		}
 
-		// can't error after this so, this is safe
-		output = (stbi_uc *)stbi__malloc_mad3(n, z->s->img_x, z->s->img_y, 1);
-		if (!output) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
+		if (z->dest) {
+			if (z->dest_x != (int)z->s->img_x || z->dest_y != (int)z->s->img_y) { stbi__cleanup_jpeg(z); return stbi__errpuc("bad size", "Image size differs from destination"); }
+			output = z->dest;
+		}
+		else {
+			output = (stbi_uc *)stbi__malloc_mad3(n, z->s->img_x, z->s->img_y, 1);
+			if (!output) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
+		}
 
 		// now go ahead and resample
-		for (j = 0; j < z->s->img_y; ++j) {
-			stbi_uc *out = output + n * z->s->img_x * j;
-			for (k = 0; k < decode_n; ++k) {
-				stbi__resample *r = &res_comp[k];
-				int y_bot = r->ystep >= (r->vs >> 1);
-				coutput[k] = r->resample(z->img_comp[k].linebuf,
-					y_bot ? r->line1 : r->line0,
-					y_bot ? r->line0 : r->line1,
-					r->w_lores, r->hs);
-				if (++r->ystep >= r->vs) {
-					r->ystep = 0;
-					r->line0 = r->line1;
-					if (++r->ypos < z->img_comp[k].y)
-						r->line1 += z->img_comp[k].w2;
-				}
-			}
-			if (n >= 3) {
-				stbi_uc *y = coutput[0];
-				if (z->s->img_n == 3) {
-					if (is_rgb) {
-						for (i = 0; i < z->s->img_x; ++i) {
-							out[0] = y[i];
-							out[1] = coutput[1][i];
-							out[2] = coutput[2][i];
-							out[3] = 255;
-							out += n;
-						}
-					}
-					else {
-						z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
-					}
-				}
-				else if (z->s->img_n == 4) {
-					if (z->app14_color_transform == 0) { // CMYK
-						for (i = 0; i < z->s->img_x; ++i) {
-							stbi_uc m = coutput[3][i];
-							out[0] = stbi__blinn_8x8(coutput[0][i], m);
-							out[1] = stbi__blinn_8x8(coutput[1][i], m);
-							out[2] = stbi__blinn_8x8(coutput[2][i], m);
-							out[3] = 255;
-							out += n;
-						}
-					}
-					else if (z->app14_color_transform == 2) { // YCCK
-						z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
-						for (i = 0; i < z->s->img_x; ++i) {
-							stbi_uc m = coutput[3][i];
-							out[0] = stbi__blinn_8x8(255 - out[0], m);
-							out[1] = stbi__blinn_8x8(255 - out[1], m);
-							out[2] = stbi__blinn_8x8(255 - out[2], m);
-							out += n;
-						}
-					}
-					else { // YCbCr + alpha?  Ignore the fourth channel for now
-						z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
-					}
-				}
-				else
-					for (i = 0; i < z->s->img_x; ++i) {
-						out[0] = out[1] = out[2] = y[i];
-						out[3] = 255; // not used if n==3
-						out += n;
-					}
+		rows_per_job = z->s->img_x < STBI__JPEG_JOB_PIXELS ? STBI__JPEG_JOB_PIXELS / z->s->img_x : 1;
+		if (z->s->parallel_for && z->s->img_y > 2 * rows_per_job) {
+			stbi__jpeg_output_jobs jobs;
+			int num_jobs = (int)((z->s->img_y + rows_per_job - 1) / rows_per_job);
+			jobs.z = z;
+			jobs.res_comp = res_comp;
+			jobs.output = output;
+			jobs.n = n;
+			jobs.decode_n = decode_n;
+			jobs.is_rgb = is_rgb;
+			jobs.rows_per_job = rows_per_job;
+			jobs.ok = (stbi_uc *)stbi__malloc(num_jobs);
+			if (jobs.ok) {
+				z->s->parallel_for(z->s->parallel_pool, stbi__jpeg_output_job, &jobs, num_jobs);
+				for (k = 0; k < num_jobs; ++k)
+					if (!jobs.ok[k]) break;
 			}
-			else {
-				if (is_rgb) {
-					if (n == 1)
-						for (i = 0; i < z->s->img_x; ++i)
-							*out++ = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
-					else {
-						for (i = 0; i < z->s->img_x; ++i, out += 2) {
-							out[0] = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
-							out[1] = 255;
-						}
-					}
-				}
-				else if (z->s->img_n == 4 && z->app14_color_transform == 0) {
-					for (i = 0; i < z->s->img_x; ++i) {
-						stbi_uc m = coutput[3][i];
-						stbi_uc r = stbi__blinn_8x8(coutput[0][i], m);
-						stbi_uc g = stbi__blinn_8x8(coutput[1][i], m);
-						stbi_uc b = stbi__blinn_8x8(coutput[2][i], m);
-						out[0] = stbi__compute_y(r, g, b);
-						out[1] = 255;
-						out += n;
-					}
-				}
-				else if (z->s->img_n == 4 && z->app14_color_transform == 2) {
-					for (i = 0; i < z->s->img_x; ++i) {
-						out[0] = stbi__blinn_8x8(255 - coutput[0][i], coutput[3][i]);
-						out[1] = 255;
-						out += n;
-					}
-				}
-				else {
-					stbi_uc *y = coutput[0];
-					if (n == 1)
-						for (i = 0; i < z->s->img_x; ++i) out[i] = y[i];
-					else
-						for (i = 0; i < z->s->img_x; ++i) { *out++ = y[i]; *out++ = 255; }
-				}
+			if (!jobs.ok || k < num_jobs) {
+				STBI_FREE(jobs.ok);
+				if (!z->dest) STBI_FREE(output);
+				stbi__cleanup_jpeg(z);
+				return stbi__errpuc("outofmem", "Out of memory");
 			}
+			STBI_FREE(jobs.ok);
+		}
+		else {
+			// caller's rows may be flipped or end the destination, so that they can't be overrun
+			stbi_uc *linebuf[4], *rowbuf = z->dest && n == 3 ? (stbi_uc *)stbi__malloc_mad2(n, z->s->img_x, 1) : NULL;
+			if (z->dest && n == 3 && !rowbuf) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
+			for (k = 0; k < decode_n; ++k) linebuf[k] = z->img_comp[k].linebuf;
+			stbi__jpeg_output_rows(z, res_comp, linebuf, rowbuf, output, n, decode_n, is_rgb, 0, z->s->img_y);
+			STBI_FREE(rowbuf);
 		}
 		stbi__cleanup_jpeg(z);
 		*out_x = z->s->img_x;
@@ -3943,10 +4781,30 @@ static int stbi__jpeg_info(stbi__context *s, int *x, int *y, int *comp)
 
 #ifndef STBI_NO_ZLIB
 
+static int stbi__png_fast_paths = 1;
+
+STBIDEF void stbi_set_png_fast_paths(int flag_true_if_should_use_fast_paths)
+{
+	stbi__png_fast_paths = flag_true_if_should_use_fast_paths;
+}
+
 // fast-way is faster to check than jpeg huffman, but slow way is slower
 #define STBI__ZFAST_BITS  9 // accelerate all cases in default tables
 #define STBI__ZFAST_MASK  ((1 << STBI__ZFAST_BITS) - 1)
 
+// multi-symbol table for literal/length codes: one lookup of the low STBI__ZMULTI_BITS
+// bits resolves up to two literals, or a length together with its extra bits.
+// entry layout: bits 0-7 = bits to consume, 8-10 = kind, 11-15 = length extra bits
+// still to read, 16-31 = literals (first in the low byte) or length
+#define STBI__ZMULTI_BITS  11
+#define STBI__ZMULTI_MASK  ((1 << STBI__ZMULTI_BITS) - 1)
+
+#define STBI__ZMULTI_SLOW      0 // code longer than the table, or symbol not allowed in compressed data
+#define STBI__ZMULTI_LITERAL   1
+#define STBI__ZMULTI_LITERALS2 2
+#define STBI__ZMULTI_LENGTH    3
+#define STBI__ZMULTI_EOB       4
+
 // zlib-style huffman encoding
 // (jpegs packs from left, zlib from right, so can't share code)
 typedef struct
@@ -4039,8 +4897,10 @@ typedef struct
 	char *zout_start;
 	char *zout_end;
 	int   z_expandable;
+	int   z_fast; // use stbi__parse_huffman_block_fast, which needs z_length_multi
 
 	stbi__zhuffman z_length, z_distance;
+	stbi__uint32 z_length_multi[1 << STBI__ZMULTI_BITS];
 } stbi__zbuf;
 
 stbi_inline static stbi_uc stbi__zget8(stbi__zbuf *z)
@@ -4068,22 +4928,31 @@ stbi_inline static unsigned int stbi__zreceive(stbi__zbuf *z, int n)
 	return k;
 }
 
-static int stbi__zhuffman_decode_slowpath(stbi__zbuf *a, stbi__zhuffman *z)
+// decodes a code not resolved by the fast table from the low 16 bits of 'code';
+// returns symbol | (code length << 16), or -1 for invalid codes
+static int stbi__zhuffman_decode_long(stbi__zhuffman *z, unsigned int code)
 {
 	int b, s, k;
 	// not resolved by fast table, so compute it the slow way
 	// use jpeg approach, which requires MSbits at top
-	k = stbi__bit_reverse(a->code_buffer, 16);
+	k = stbi__bit_reverse(code & 0xffff, 16);
 	for (s = STBI__ZFAST_BITS + 1; ; ++s)
 		if (k < z->maxcode[s])
 			break;
 	if (s == 16) return -1; // invalid code!
 	// code size is s, so:
 	b = (k >> (16 - s)) - z->firstcode[s] + z->firstsymbol[s];
-	STBI_ASSERT(z->size[b] == s);
-	a->code_buffer >>= s;
-	a->num_bits -= s;
-	return z->value[b];
+	if (b < 0 || b >= 288 || z->size[b] != s) return -1; // incomplete code sets leave holes
+	return z->value[b] | (s << 16);
+}
+
+static int stbi__zhuffman_decode_slowpath(stbi__zbuf *a, stbi__zhuffman *z)
+{
+	int b = stbi__zhuffman_decode_long(z, a->code_buffer);
+	if (b < 0) return -1;
+	a->code_buffer >>= b >> 16;
+	a->num_bits -= b >> 16;
+	return b & 0xffff;
 }
 
 stbi_inline static int stbi__zhuffman_decode(stbi__zbuf *a, stbi__zhuffman *z)
@@ -4103,13 +4972,16 @@ stbi_inline static int stbi__zhuffman_decode(stbi__zbuf *a, stbi__zhuffman *z)
 static int stbi__zexpand(stbi__zbuf *z, char *zout, int n)  // need to make room for n bytes
 {
 	char *q;
-	int cur, limit, old_limit;
+	unsigned int cur, limit, old_limit;
 	z->zout = zout;
 	if (!z->z_expandable) return stbi__err("output buffer limit", "Corrupt PNG");
-	cur = (int)(z->zout - z->zout_start);
-	limit = old_limit = (int)(z->zout_end - z->zout_start);
-	while (cur + n > limit)
+	cur = (unsigned int)(z->zout - z->zout_start);
+	limit = old_limit = (unsigned int)(z->zout_end - z->zout_start);
+	if (UINT_MAX - cur < (unsigned int)n) return stbi__err("outofmem", "Out of memory");
+	while (cur + n > limit) {
+		if (limit > UINT_MAX / 2) return stbi__err("outofmem", "Out of memory");
 		limit *= 2;
+	}
 	q = (char *)STBI_REALLOC_SIZED(z->zout_start, old_limit, limit);
 	STBI_NOTUSED(old_limit);
 	if (q == NULL) return stbi__err("outofmem", "Out of memory");
@@ -4133,9 +5005,211 @@ static const int stbi__zdist_base[32] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129
 static const int stbi__zdist_extra[32] =
 { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
 
-static int stbi__parse_huffman_block(stbi__zbuf *a)
+static void stbi__zbuild_multi(stbi__uint32 *multi, const stbi_uc *sizelist, int num)
+{
+	stbi__uint16 single[1 << STBI__ZMULTI_BITS]; // (symbol << 4) | code length, 0 if no code fits
+	int i, code, next_code[16], sizes[16];
+
+	// same code assignment as stbi__zbuild_huffman, which has already validated the sizes
+	memset(sizes, 0, sizeof(sizes));
+	memset(single, 0, sizeof(single));
+	for (i = 0; i < num; ++i)
+		++sizes[sizelist[i]];
+	sizes[0] = 0;
+	code = 0;
+	for (i = 1; i < 16; ++i) {
+		next_code[i] = code;
+		code = (code + sizes[i]) << 1;
+	}
+	for (i = 0; i < num; ++i) {
+		int s = sizelist[i];
+		if (s) {
+			if (s <= STBI__ZMULTI_BITS) {
+				int j = stbi__bit_reverse(next_code[s], s);
+				while (j < (1 << STBI__ZMULTI_BITS)) {
+					single[j] = (stbi__uint16)((i << 4) | s);
+					j += (1 << s);
+				}
+			}
+			++next_code[s];
+		}
+	}
+
+	for (i = 0; i < (1 << STBI__ZMULTI_BITS); ++i) {
+		int len = single[i] & 15, sym = single[i] >> 4;
+		stbi__uint32 e = STBI__ZMULTI_SLOW;
+		if (!len) {
+			// leave to the slow path
+		}
+		else if (sym < 256) {
+			// the second code only sees the bits left after the first one, so it must fit in them
+			int len2 = single[i >> len] & 15, sym2 = single[i >> len] >> 4;
+			if (len2 && sym2 < 256 && len + len2 <= STBI__ZMULTI_BITS)
+				e = (len + len2) | (STBI__ZMULTI_LITERALS2 << 8) | ((stbi__uint32)(sym | (sym2 << 8)) << 16);
+			else
+				e = len | (STBI__ZMULTI_LITERAL << 8) | ((stbi__uint32)sym << 16);
+		}
+		else if (sym == 256) {
+			e = len | (STBI__ZMULTI_EOB << 8);
+		}
+		else if (sym < 286) {
+			int base = stbi__zlength_base[sym - 257], extra = stbi__zlength_extra[sym - 257];
+			if (len + extra <= STBI__ZMULTI_BITS)
+				e = (len + extra) | (STBI__ZMULTI_LENGTH << 8) | ((stbi__uint32)(base + ((i >> len) & ((1 << extra) - 1))) << 16);
+			else
+				e = len | (STBI__ZMULTI_LENGTH << 8) | (extra << 11) | ((stbi__uint32)base << 16);
+		}
+		multi[i] = e;
+	}
+}
+
+// decodes a literal/length or distance code from the low bits of a 64-bit bit buffer;
+// returns symbol | (code length << 16), or -1 for invalid codes
+stbi_inline static int stbi__zhuffman_decode64(stbi__zhuffman *z, stbi__uint64 bits)
+{
+	int b = z->fast[bits & STBI__ZFAST_MASK];
+	if (b)
+		return (b & 511) | ((b >> 9) << 16);
+	return stbi__zhuffman_decode_long(z, (unsigned int)bits);
+}
+
+stbi_inline static stbi__uint64 stbi__zload64(const stbi_uc *p)
+{
+#if defined(STBI__X86_TARGET) || defined(STBI__X64_TARGET)
+	stbi__uint64 v;
+	memcpy(&v, p, 8); // little-endian, unaligned loads are fine
+	return v;
+#else
+	return (stbi__uint64)p[0] | ((stbi__uint64)p[1] << 8) | ((stbi__uint64)p[2] << 16) | ((stbi__uint64)p[3] << 24)
+		| ((stbi__uint64)p[4] << 32) | ((stbi__uint64)p[5] << 40) | ((stbi__uint64)p[6] << 48) | ((stbi__uint64)p[7] << 56);
+#endif
+}
+
+// room the fast loop keeps at the end of the output: the longest match, plus the slack of its 8-byte copies
+#define STBI__ZFAST_OUT_MARGIN  (258 + 16)
+
+// decodes the bulk of a huffman block with a 64-bit bit buffer, refilled once per symbol without
+// branching, and the multi-symbol table. it stops short of the end of the input and output buffers
+// and returns 2 then, leaving the rest to the byte-wise loop; returns 1 at the end of the block or 0 on error
+static int stbi__parse_huffman_block_fast(stbi__zbuf *a)
 {
+	const stbi_uc *in = a->zbuffer;
 	char *zout = a->zout;
+	stbi__uint64 bits = a->code_buffer;
+	int num_bits = a->num_bits;
+	int result = 2;
+
+	// each symbol takes at most 48 bits (15 + 5 for the length, 15 + 13 for the distance),
+	// while the refill leaves 56 to 63 bits in the buffer
+	while (a->zbuffer_end - in >= 8 && a->zout_end - zout >= STBI__ZFAST_OUT_MARGIN) {
+		stbi__uint32 e;
+		int kind, len, extra, dist, z;
+		char *p;
+
+		bits |= stbi__zload64(in) << num_bits;
+		in += (63 - num_bits) >> 3;
+		num_bits |= 56;
+
+		e = a->z_length_multi[bits & STBI__ZMULTI_MASK];
+		kind = (e >> 8) & 7;
+		bits >>= e & 255;
+		num_bits -= e & 255;
+		if (kind == STBI__ZMULTI_LITERALS2) {
+			zout[0] = (char)(e >> 16);
+			zout[1] = (char)(e >> 24);
+			zout += 2;
+			continue;
+		}
+		if (kind == STBI__ZMULTI_LITERAL) {
+			*zout++ = (char)(e >> 16);
+			continue;
+		}
+		if (kind == STBI__ZMULTI_EOB) {
+			result = 1;
+			break;
+		}
+		if (kind == STBI__ZMULTI_LENGTH) {
+			len = e >> 16;
+			extra = (e >> 11) & 31;
+		}
+		else {
+			z = stbi__zhuffman_decode64(&a->z_length, bits);
+			if (z < 0) return stbi__err("bad huffman code", "Corrupt PNG");
+			bits >>= z >> 16;
+			num_bits -= z >> 16;
+			z &= 0xffff;
+			if (z < 256) {
+				*zout++ = (char)z;
+				continue;
+			}
+			if (z == 256) {
+				result = 1;
+				break;
+			}
+			z -= 257;
+			if (z >= 29) return stbi__err("bad huffman code", "Corrupt PNG"); // length codes 286 and 287 must not appear
+			len = stbi__zlength_base[z];
+			extra = stbi__zlength_extra[z];
+		}
+		if (extra) {
+			len += (int)(bits & ((1u << extra) - 1));
+			bits >>= extra;
+			num_bits -= extra;
+		}
+
+		z = stbi__zhuffman_decode64(&a->z_distance, bits);
+		if (z < 0) return stbi__err("bad huffman code", "Corrupt PNG");
+		bits >>= z >> 16;
+		num_bits -= z >> 16;
+		z &= 0xffff;
+		if (z >= 30) return stbi__err("bad huffman code", "Corrupt PNG"); // distance codes 30 and 31 must not appear
+		dist = stbi__zdist_base[z];
+		if (stbi__zdist_extra[z]) {
+			dist += (int)(bits & ((1u << stbi__zdist_extra[z]) - 1));
+			bits >>= stbi__zdist_extra[z];
+			num_bits -= stbi__zdist_extra[z];
+		}
+		if (zout - a->zout_start < dist) return stbi__err("bad dist", "Corrupt PNG");
+
+		p = zout - dist;
+		if (dist >= 8) {
+			// 8-byte copies may run up to 7 bytes past the match, which the margin covers;
+			// every source chunk is complete before it's read, as it lies at least 8 bytes behind
+			char *end = zout + len;
+			do {
+				memcpy(zout, p, 8);
+				zout += 8;
+				p += 8;
+			} while (zout < end);
+			zout = end;
+		}
+		else if (dist == 1) { // run of one byte; common in images.
+			memset(zout, *p, len);
+			zout += len;
+		}
+		else {
+			do *zout++ = *p++; while (--len);
+		}
+	}
+
+	// hand the whole bytes still in the bit buffer back to the byte-wise reader
+	in -= num_bits >> 3;
+	num_bits &= 7;
+	a->zbuffer = (stbi_uc *)in;
+	a->code_buffer = (stbi__uint32)bits & ((1u << num_bits) - 1);
+	a->num_bits = num_bits;
+	a->zout = zout;
+	return result;
+}
+
+static int stbi__parse_huffman_block(stbi__zbuf *a)
+{
+	char *zout;
+	if (a->z_fast) {
+		int result = stbi__parse_huffman_block_fast(a);
+		if (result != 2) return result;
+	}
+	zout = a->zout;
 	for (;;) {
 		int z = stbi__zhuffman_decode(a, &a->z_length);
 		if (z < 256) {
@@ -4154,10 +5228,11 @@ static int stbi__parse_huffman_block(stbi__zbuf *a)
 				return 1;
 			}
 			z -= 257;
+			if (z >= 29) return stbi__err("bad huffman code", "Corrupt PNG"); // length codes 286 and 287 must not appear
 			len = stbi__zlength_base[z];
 			if (stbi__zlength_extra[z]) len += stbi__zreceive(a, stbi__zlength_extra[z]);
 			z = stbi__zhuffman_decode(a, &a->z_distance);
-			if (z < 0) return stbi__err("bad huffman code", "Corrupt PNG");
+			if (z < 0 || z >= 30) return stbi__err("bad huffman code", "Corrupt PNG"); // distance codes 30 and 31 must not appear
 			dist = stbi__zdist_base[z];
 			if (stbi__zdist_extra[z]) dist += stbi__zreceive(a, stbi__zdist_extra[z]);
 			if (zout - a->zout_start < dist) return stbi__err("bad dist", "Corrupt PNG");
@@ -4224,6 +5299,7 @@ static int stbi__compute_huffman_codes(stbi__zbuf *a)
 	if (n != ntot) return stbi__err("bad codelengths", "Corrupt PNG");
 	if (!stbi__zbuild_huffman(&a->z_length, lencodes, hlit)) return 0;
 	if (!stbi__zbuild_huffman(&a->z_distance, lencodes + hlit, hdist)) return 0;
+	if (a->z_fast) stbi__zbuild_multi(a->z_length_multi, lencodes, hlit);
 	return 1;
 }
 
@@ -4318,6 +5394,7 @@ static int stbi__parse_zlib(stbi__zbuf *a, int parse_header)
 				// use fixed code lengths
 				if (!stbi__zbuild_huffman(&a->z_length, stbi__zdefault_length, 288)) return 0;
 				if (!stbi__zbuild_huffman(&a->z_distance, stbi__zdefault_distance, 32)) return 0;
+				if (a->z_fast) stbi__zbuild_multi(a->z_length_multi, stbi__zdefault_length, 288);
 			}
 			else {
 				if (!stbi__compute_huffman_codes(a)) return 0;
@@ -4334,6 +5411,7 @@ static int stbi__do_zlib(stbi__zbuf *a, char *obuf, int olen, int exp, int parse
 	a->zout = obuf;
 	a->zout_end = obuf + olen;
 	a->z_expandable = exp;
+	a->z_fast = stbi__png_fast_paths;
 
 	return stbi__parse_zlib(a, parse_header);
 }
@@ -4492,6 +5570,108 @@ static int stbi__paeth(int a, int b, int c)
 
 static const stbi_uc stbi__depth_scale_table[9] = { 0, 0xff, 0x55, 0, 0x11, 0,0,0, 0x01 };
 
+#ifdef STBI_SSE2
+stbi_inline static __m128i stbi__png_load32(const stbi_uc *p)
+{
+	int v;
+	memcpy(&v, p, 4);
+	return _mm_cvtsi32_si128(v);
+}
+
+stbi_inline static void stbi__png_store32(stbi_uc *p, __m128i v)
+{
+	int x = _mm_cvtsi128_si32(v);
+	memcpy(p, &x, 4);
+}
+
+// unfilters the rest of an 8-bit scanline after its first pixel ('cur' points past it), nk bytes in all;
+// returns 0 for the cases left to the scalar loops. pixels are reconstructed one at a time with 4-byte
+// loads and stores, so 3-byte pixels write one byte ahead, which the next pixel overwrites; the last pixel
+// of such rows is done by the scalar tail, so nothing past the row is touched
+static int stbi__png_unfilter_sse2(int filter, stbi_uc *cur, const stbi_uc *raw, const stbi_uc *prior, int nk, int bpp)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i a, b, c, x;
+	int k = 0;
+
+	if (filter == STBI__F_up) {
+		for (; k + 16 <= nk; k += 16)
+			_mm_storeu_si128((__m128i *)(cur + k), _mm_add_epi8(_mm_loadu_si128((const __m128i *)(raw + k)), _mm_loadu_si128((const __m128i *)(prior + k))));
+		for (; k < nk; ++k)
+			cur[k] = STBI__BYTECAST(raw[k] + prior[k]);
+		return 1;
+	}
+	if ((bpp != 3 && bpp != 4) || nk < 4) // the first load of the previous pixel reaches 4 bytes into the row
+		return 0;
+
+	switch (filter) {
+	case STBI__F_sub:
+	case STBI__F_paeth_first: // paeth(a, 0, 0) is always a
+		a = stbi__png_load32(cur - bpp);
+		if (bpp == 4) {
+			// prefix sum of four pixels at once
+			a = _mm_shuffle_epi32(a, 0x00);
+			for (; k + 16 <= nk; k += 16) {
+				x = _mm_loadu_si128((const __m128i *)(raw + k));
+				x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+				x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+				x = _mm_add_epi8(x, a);
+				_mm_storeu_si128((__m128i *)(cur + k), x);
+				a = _mm_shuffle_epi32(x, 0xff);
+			}
+		}
+		for (; k + 4 <= nk; k += bpp) {
+			a = _mm_add_epi8(stbi__png_load32(raw + k), a);
+			stbi__png_store32(cur + k, a);
+		}
+		for (; k < nk; ++k)
+			cur[k] = STBI__BYTECAST(raw[k] + cur[k - bpp]);
+		return 1;
+
+	case STBI__F_avg:
+		a = stbi__png_load32(cur - bpp);
+		for (; k + 4 <= nk; k += bpp) {
+			// floor((a + b) / 2), from the rounding-up average
+			b = stbi__png_load32(prior + k);
+			x = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+			a = _mm_add_epi8(stbi__png_load32(raw + k), x);
+			stbi__png_store32(cur + k, a);
+		}
+		for (; k < nk; ++k)
+			cur[k] = STBI__BYTECAST(raw[k] + ((prior[k] + cur[k - bpp]) >> 1));
+		return 1;
+
+	case STBI__F_paeth:
+		// in 16-bit lanes: pa = |b - c|, pb = |a - c|, pc = |a + b - 2c|, picking a, then b, then c on ties
+		a = _mm_unpacklo_epi8(stbi__png_load32(cur - bpp), zero);
+		c = _mm_unpacklo_epi8(stbi__png_load32(prior - bpp), zero);
+		for (; k + 4 <= nk; k += bpp) {
+			__m128i pa, pb, pc, smallest, pred;
+			b = _mm_unpacklo_epi8(stbi__png_load32(prior + k), zero);
+			pa = _mm_sub_epi16(b, c);
+			pb = _mm_sub_epi16(a, c);
+			pc = _mm_add_epi16(pa, pb);
+			pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+			pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+			pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+			smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+			x = _mm_cmpeq_epi16(smallest, pb);
+			pred = _mm_or_si128(_mm_and_si128(x, b), _mm_andnot_si128(x, c));
+			x = _mm_cmpeq_epi16(smallest, pa);
+			pred = _mm_or_si128(_mm_and_si128(x, a), _mm_andnot_si128(x, pred));
+			x = _mm_add_epi8(stbi__png_load32(raw + k), _mm_packus_epi16(pred, zero));
+			stbi__png_store32(cur + k, x);
+			a = _mm_unpacklo_epi8(x, zero);
+			c = b;
+		}
+		for (; k < nk; ++k)
+			cur[k] = STBI__BYTECAST(raw[k] + stbi__paeth(cur[k - bpp], prior[k], prior[k - bpp]));
+		return 1;
+	}
+	return 0;
+}
+#endif // STBI_SSE2
+
 // create the png data from post-deflated data
 static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 raw_len, int out_n, stbi__uint32 x, stbi__uint32 y, int depth, int color)
 {
@@ -4505,6 +5685,9 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
 	int output_bytes = out_n * bytes;
 	int filter_bytes = img_n * bytes;
 	int width = x;
+#ifdef STBI_SSE2
+	int use_sse2 = stbi__png_fast_paths && depth == 8 && stbi__sse2_available();
+#endif
 
 	STBI_ASSERT(out_n == s->img_n || out_n == s->img_n + 1);
 	a->out = (stbi_uc *)stbi__malloc_mad3(x, y, output_bytes, 0); // extra bytes to write off the end into
@@ -4579,6 +5762,11 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
 #define STBI__CASE(f) \
              case f:     \
                 for (k=0; k < nk; ++k)
+#ifdef STBI_SSE2
+			if (use_sse2 && stbi__png_unfilter_sse2(filter, cur, raw, prior, nk, filter_bytes)) {
+				// already done
+			} else
+#endif
 			switch (filter) {
 				// "none" filter turns into a memcpy here; make that explicit.
 			case STBI__F_none:         memcpy(cur, raw, nk); break;
@@ -7440,6 +8628,61 @@ static int stbi__is_16_main(stbi__context *s)
 	return 0;
 }
 
+static int stbi__load_into_main(stbi__context *s, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int req_comp, int flip_vertically)
+{
+	int x, y, comp, j, result = 0;
+	stbi_uc *image;
+
+	if (req_comp < 1 || req_comp > 4) return stbi__err("bad req_comp", "Internal error");
+	if (dest_stride < dest_x * req_comp) return stbi__err("bad stride", "Destination rows overlap");
+
+#ifndef STBI_NO_JPEG
+	// JPEG writes its rows straight into the destination, no intermediate image and no extra flip pass
+	if (stbi__jpeg_test(s)) {
+		stbi__jpeg* jpeg = (stbi__jpeg*)stbi__malloc(sizeof(stbi__jpeg));
+		if (!jpeg) return stbi__err("outofmem", "Out of memory");
+		jpeg->s = s;
+		stbi__setup_jpeg(jpeg);
+		jpeg->dest = dest;
+		jpeg->dest_x = dest_x;
+		jpeg->dest_y = dest_y;
+		jpeg->dest_stride = dest_stride;
+		jpeg->dest_flip = flip_vertically;
+		result = load_jpeg_image(jpeg, &x, &y, &comp, req_comp) != NULL;
+		STBI_FREE(jpeg);
+		return result;
+	}
+#endif
+
+	image = stbi__load_and_postprocess_8bit(s, &x, &y, &comp, req_comp);
+	if (!image) return 0;
+	if (x == dest_x && y == dest_y) {
+		for (j = 0; j < y; ++j)
+			memcpy(dest + (size_t)dest_stride * (flip_vertically ? y - 1 - j : j), image + (size_t)x * req_comp * j, (size_t)x * req_comp);
+		result = 1;
+	}
+	else
+		stbi__err("bad size", "Image size differs from destination");
+	STBI_FREE(image);
+	return result;
+}
+
+STBIDEF int stbi_load_into_from_memory(stbi_uc const *buffer, int len, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int req_comp, int flip_vertically)
+{
+	stbi__context s;
+	stbi__start_mem(&s, buffer, len);
+	return stbi__load_into_main(&s, dest, dest_x, dest_y, dest_stride, req_comp, flip_vertically);
+}
+
+STBIDEF int stbi_load_into_from_memory_parallel(stbi_uc const *buffer, int len, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int req_comp, int flip_vertically, stbi_parallel_for *parallel_for, void *pool)
+{
+	stbi__context s;
+	stbi__start_mem(&s, buffer, len);
+	s.parallel_for = parallel_for;
+	s.parallel_pool = pool;
+	return stbi__load_into_main(&s, dest, dest_x, dest_y, dest_stride, req_comp, flip_vertically);
+}
+
 #ifndef STBI_NO_STDIO
 STBIDEF int stbi_info(char const *filename, int *x, int *y, int *comp)
 {
@@ -7482,6 +8725,60 @@ STBIDEF int stbi_is_16_bit_from_file(FILE *f)
 	fseek(f, pos, SEEK_SET);
 	return r;
 }
+
+STBIDEF int stbi_load_into(char const *filename, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int req_comp, int flip_vertically)
+{
+	FILE *f;
+	stbi__context s;
+	int result;
+
+	f = stbi__fopen(filename, "rb");
+	if (!f) return stbi__err("can't fopen", "Unable to open file");
+	stbi__start_file(&s, f);
+	result = stbi__load_into_main(&s, dest, dest_x, dest_y, dest_stride, req_comp, flip_vertically);
+	fclose(f);
+	return result;
+}
+
+// parallel decoders split the data of memory contexts, so files are read whole
+static stbi_uc *stbi__read_whole_file(char const *filename, int *len)
+{
+	FILE *f = stbi__fopen(filename, "rb");
+	stbi_uc *buffer = NULL;
+	long size;
+	if (!f) return stbi__errpuc("can't fopen", "Unable to open file");
+	if (fseek(f, 0, SEEK_END) == 0 && (size = ftell(f)) >= 0 && size < INT_MAX && fseek(f, 0, SEEK_SET) == 0) {
+		buffer = (stbi_uc *)stbi__malloc(size ? (size_t)size : 1);
+		if (buffer && fread(buffer, 1, (size_t)size, f) != (size_t)size) {
+			STBI_FREE(buffer);
+			buffer = NULL;
+		}
+		*len = (int)size;
+	}
+	fclose(f);
+	if (!buffer) stbi__err("can't read", "Unable to read file");
+	return buffer;
+}
+
+STBIDEF stbi_uc *stbi_load_parallel(char const *filename, int *x, int *y, int *comp, int req_comp, stbi_parallel_for *parallel_for, void *pool)
+{
+	int len;
+	stbi_uc *result, *buffer = stbi__read_whole_file(filename, &len);
+	if (!buffer) return NULL;
+	result = stbi_load_from_memory_parallel(buffer, len, x, y, comp, req_comp, parallel_for, pool);
+	STBI_FREE(buffer);
+	return result;
+}
+
+STBIDEF int stbi_load_into_parallel(char const *filename, stbi_uc *dest, int dest_x, int dest_y, int dest_stride, int req_comp, int flip_vertically, stbi_parallel_for *parallel_for, void *pool)
+{
+	int len, result;
+	stbi_uc *buffer = stbi__read_whole_file(filename, &len);
+	if (!buffer) return 0;
+	result = stbi_load_into_from_memory_parallel(buffer, len, dest, dest_x, dest_y, dest_stride, req_comp, flip_vertically, parallel_for, pool);
+	STBI_FREE(buffer);
+	return result;
+}
 #endif // !STBI_NO_STDIO
 
 STBIDEF int stbi_info_from_memory(stbi_uc const *buffer, int len, int *x, int *y, int *comp)
@@ -0,0 +1,349 @@
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// stb_image
+#include "stb_image.h"
+
+// Project
+#include "common/textureArray.h"
+#include "common/blockCompressor.h"
+#include "common/gpuObjectCounter.h"
+
+// S3TC is an extension, not every loader defines its formats
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+namespace {
+
+const int NUM_CHANNELS = 4;
+
+// OpenGL internal format of texture format
+GLenum internalFormat(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default: return GL_RGBA8;
+	}
+}
+
+// Size of mipmap level, which is half of the previous one, but at least 1 pixel
+GLsizei levelSize(GLsizei size, GLsizei level)
+{
+	return std::max(size >> level, 1);
+}
+
+// Range of source pixels [first, last) covered by destination pixel, at least one pixel wide
+void sourceRange(int destinationIndex, int destinationSize, int sourceSize, int& first, int& last)
+{
+	first = static_cast<int>(static_cast<long long>(destinationIndex) * sourceSize / destinationSize);
+	last = static_cast<int>(static_cast<long long>(destinationIndex + 1) * sourceSize / destinationSize);
+	last = std::max(last, first + 1);
+}
+
+} // namespace
+
+bool TextureArray::create(GLsizei width, GLsizei height, GLsizei numLayers, TextureFormat format)
+{
+	if (_isCreated)
+	{
+		std::cerr << "This texture array is already created! You need to destroy it before re-creating it!" << std::endl;
+		return false;
+	}
+
+	if (width <= 0 || height <= 0 || numLayers <= 0)
+	{
+		std::cerr << "Texture array needs positive size and number of layers!" << std::endl;
+		return false;
+	}
+
+	GLint maxLayers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+	if (numLayers > maxLayers)
+	{
+		std::cerr << "Texture array can have at most " << maxLayers << " layers!" << std::endl;
+		return false;
+	}
+
+	// Full mipmap chain down to 1x1
+	GLsizei numLevels = 1;
+	for (auto size = std::max(width, height); size > 1; size /= 2) {
+		numLevels++;
+	}
+
+	GpuObjectCounter::genTextures(1, &_textureID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, _textureID);
+	glTexStorage3D(GL_TEXTURE_2D_ARRAY, numLevels, internalFormat(format), width, height, numLayers);
+
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	_width = width;
+	_height = height;
+	_numLevels = numLevels;
+	_format = format;
+	_maxLayers = numLayers;
+	_numLayers = 0;
+
+	std::cout << "Created texture array with ID " << _textureID << ", " << numLayers << " layers of " << width << "x" << height << " pixels" << std::endl;
+	_isCreated = true;
+	return true;
+}
+
+int TextureArray::addLayer(const unsigned char* pixels, int width, int height)
+{
+	const auto layer = reserveLayers(1);
+	if (layer < 0) {
+		return -1;
+	}
+
+	std::vector<unsigned char> layerPixels(static_cast<size_t>(_width) * _height * NUM_CHANNELS);
+	resampleFlipped(pixels, width, height, layerPixels.data(), _width, _height);
+	std::vector<unsigned char> layerData(getLayerDataSize());
+	encodeLayer(layerPixels.data(), layerData.data());
+	uploadLayer(layer, layerData.data());
+	return layer;
+}
+
+int TextureArray::addLayerFromFile(const char* filename)
+{
+	int width, height, channels;
+	unsigned char* image = stbi_load(filename, &width, &height, &channels, NUM_CHANNELS);
+	if (image == nullptr)
+	{
+		std::cerr << "Failed to load image " << filename << "!" << std::endl;
+		return -1;
+	}
+
+	const auto layer = addLayer(image, width, height);
+	stbi_image_free(image);
+	return layer;
+}
+
+int TextureArray::reserveLayers(int count)
+{
+	if (!_isCreated)
+	{
+		std::cerr << "This texture array is not created yet! Call create before adding layers!" << std::endl;
+		return -1;
+	}
+
+	if (count > _maxLayers - _numLayers)
+	{
+		std::cerr << "Texture array is full, it has only " << _maxLayers << " layers!" << std::endl;
+		return -1;
+	}
+
+	const auto firstLayer = _numLayers;
+	_numLayers += count;
+	return firstLayer;
+}
+
+void TextureArray::encodeLayer(const unsigned char* layerPixels, unsigned char* layerData) const
+{
+	if (_format == TextureFormat::RGBA8)
+	{
+		if (layerData != layerPixels) {
+			std::memcpy(layerData, layerPixels, getLayerDataSize());
+		}
+		return;
+	}
+
+	// Every level is box-filtered from the previous one, then compressed behind it
+	std::vector<unsigned char> levelPixels(layerPixels, layerPixels + static_cast<size_t>(_width) * _height * NUM_CHANNELS);
+	std::vector<unsigned char> nextLevelPixels;
+	for (GLsizei level = 0; level < _numLevels; level++)
+	{
+		const auto width = levelSize(_width, level);
+		const auto height = levelSize(_height, level);
+		if (level > 0)
+		{
+			const auto previousWidth = levelSize(_width, level - 1);
+			const auto previousHeight = levelSize(_height, level - 1);
+			nextLevelPixels.resize(static_cast<size_t>(width) * height * NUM_CHANNELS);
+			BlockCompressor::downsample(levelPixels.data(), previousWidth, previousHeight, nextLevelPixels.data(), width, height);
+			levelPixels.swap(nextLevelPixels);
+		}
+
+		if (_format == TextureFormat::BC1) {
+			BlockCompressor::compressBC1(levelPixels.data(), width, height, layerData);
+		}
+		else {
+			BlockCompressor::compressBC7(levelPixels.data(), width, height, layerData);
+		}
+		layerData += getLevelDataSize(_format, width, height);
+	}
+}
+
+void TextureArray::uploadLayer(int layer, const unsigned char* layerData) const
+{
+	glBindTexture(GL_TEXTURE_2D_ARRAY, _textureID);
+	if (_format == TextureFormat::RGBA8) {
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, _width, _height, 1, GL_RGBA, GL_UNSIGNED_BYTE, layerData);
+	}
+	else
+	{
+		// Layer data may be an offset into pixel unpack buffer, so the levels are addressed by integer offsets
+		auto levelOffset = reinterpret_cast<uintptr_t>(layerData);
+		for (GLsizei level = 0; level < _numLevels; level++)
+		{
+			const auto width = levelSize(_width, level);
+			const auto height = levelSize(_height, level);
+			const auto dataSize = getLevelDataSize(_format, width, height);
+			glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, 1, internalFormat(_format),
+				static_cast<GLsizei>(dataSize), reinterpret_cast<const void*>(levelOffset));
+			levelOffset += dataSize;
+		}
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::generateMipmaps() const
+{
+	if (_format != TextureFormat::RGBA8) {
+		return;
+	}
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, _textureID);
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::generateLayerMipmaps(int layer) const
+{
+	if (_format != TextureFormat::RGBA8) {
+		return;
+	}
+
+	// glGenerateMipmap works on whole texture, view of the single layer limits it to that layer
+	GLuint layerView = 0;
+	GpuObjectCounter::genTextures(1, &layerView);
+	glTextureView(layerView, GL_TEXTURE_2D, _textureID, GL_RGBA8, 0, _numLevels, layer, 1);
+	glBindTexture(GL_TEXTURE_2D, layerView);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	GpuObjectCounter::deleteTextures(1, &layerView);
+}
+
+void TextureArray::bind(GLenum textureUnit) const
+{
+	glActiveTexture(textureUnit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, _textureID);
+}
+
+GLuint TextureArray::getTextureID() const
+{
+	return _textureID;
+}
+
+GLsizei TextureArray::getWidth() const
+{
+	return _width;
+}
+
+GLsizei TextureArray::getHeight() const
+{
+	return _height;
+}
+
+GLsizei TextureArray::getNumLevels() const
+{
+	return _numLevels;
+}
+
+TextureFormat TextureArray::getFormat() const
+{
+	return _format;
+}
+
+size_t TextureArray::getLayerDataSize() const
+{
+	if (_format == TextureFormat::RGBA8) {
+		return getLevelDataSize(_format, _width, _height);
+	}
+
+	size_t dataSize = 0;
+	for (GLsizei level = 0; level < _numLevels; level++) {
+		dataSize += getLevelDataSize(_format, levelSize(_width, level), levelSize(_height, level));
+	}
+	return dataSize;
+}
+
+size_t TextureArray::getLevelDataSize(TextureFormat format, GLsizei width, GLsizei height)
+{
+	if (format == TextureFormat::RGBA8) {
+		return static_cast<size_t>(width) * height * NUM_CHANNELS;
+	}
+
+	// Blocks of 4x4 pixels, partial blocks at the edges are whole blocks too
+	const size_t numBlocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+	return numBlocks * (format == TextureFormat::BC1 ? BlockCompressor::BC1_BLOCK_SIZE : BlockCompressor::BC7_BLOCK_SIZE);
+}
+
+int TextureArray::getNumLayers() const
+{
+	return _numLayers;
+}
+
+void TextureArray::destroy()
+{
+	if (!_isCreated) {
+		return;
+	}
+
+	GpuObjectCounter::deleteTextures(1, &_textureID);
+	_textureID = 0;
+	_width = _height = 0;
+	_numLevels = 0;
+	_maxLayers = _numLayers = 0;
+	_isCreated = false;
+}
+
+void TextureArray::resampleFlipped(const unsigned char* source, int sourceWidth, int sourceHeight,
+	unsigned char* destination, int destinationWidth, int destinationHeight)
+{
+	// Source columns covered by every destination column are the same for all rows
+	std::vector<int> firstColumns(destinationWidth), lastColumns(destinationWidth);
+	for (auto x = 0; x < destinationWidth; x++) {
+		sourceRange(x, destinationWidth, sourceWidth, firstColumns[x], lastColumns[x]);
+	}
+
+	for (auto y = 0; y < destinationHeight; y++)
+	{
+		// Destination row y counts from the bottom, source rows from the top
+		int firstRow, lastRow;
+		sourceRange(destinationHeight - 1 - y, destinationHeight, sourceHeight, firstRow, lastRow);
+
+		auto destinationPixel = destination + static_cast<size_t>(y) * destinationWidth * NUM_CHANNELS;
+		for (auto x = 0; x < destinationWidth; x++)
+		{
+			unsigned int sums[NUM_CHANNELS] = {};
+			for (auto sourceY = firstRow; sourceY < lastRow; sourceY++)
+			{
+				auto sourcePixel = source + (static_cast<size_t>(sourceY) * sourceWidth + firstColumns[x]) * NUM_CHANNELS;
+				for (auto sourceX = firstColumns[x]; sourceX < lastColumns[x]; sourceX++)
+				{
+					for (auto c = 0; c < NUM_CHANNELS; c++) {
+						sums[c] += sourcePixel[c];
+					}
+					sourcePixel += NUM_CHANNELS;
+				}
+			}
+
+			const auto numPixels = static_cast<unsigned int>((lastRow - firstRow) * (lastColumns[x] - firstColumns[x]));
+			for (auto c = 0; c < NUM_CHANNELS; c++) {
+				destinationPixel[c] = static_cast<unsigned char>((sums[c] + numPixels / 2) / numPixels);
+			}
+			destinationPixel += NUM_CHANNELS;
+		}
+	}
+}
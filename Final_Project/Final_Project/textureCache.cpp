@@ -0,0 +1,147 @@
+// STL
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Project
+#include "common/textureCache.h"
+
+namespace {
+
+const char CACHE_MAGIC[4] = { 'B', 'C', 'T', 'X' };
+const uint32_t CACHE_VERSION = 1; //! Bump when the encoders change, so old cache files are rebuilt
+
+// Header at the beginning of cache file, followed by the layer data
+struct CacheHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint64_t imageHash;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t numLevels;
+	uint64_t dataSize;
+};
+
+CacheHeader makeHeader(uint64_t imageHash, const TextureArray& textureArray)
+{
+	CacheHeader header = {};
+	std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version = CACHE_VERSION;
+	header.imageHash = imageHash;
+	header.format = static_cast<uint32_t>(textureArray.getFormat());
+	header.width = static_cast<uint32_t>(textureArray.getWidth());
+	header.height = static_cast<uint32_t>(textureArray.getHeight());
+	header.numLevels = static_cast<uint32_t>(textureArray.getNumLevels());
+	header.dataSize = textureArray.getLayerDataSize();
+	return header;
+}
+
+// Opens cache file and reads its header, returns true if it matches the expected one
+bool openCacheFile(std::ifstream& file, const std::string& imageFilename, uint64_t imageHash, const TextureArray& textureArray)
+{
+	file.open(TextureCache::getCacheFilename(imageFilename, textureArray.getFormat()), std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	// Any difference, including an older version, means the cache file is stale
+	CacheHeader header;
+	const auto expectedHeader = makeHeader(imageHash, textureArray);
+	return file.read(reinterpret_cast<char*>(&header), sizeof(header)) && std::memcmp(&header, &expectedHeader, sizeof(header)) == 0;
+}
+
+} // namespace
+
+bool TextureCache::hashFile(const std::string& filename, uint64_t& hash)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	hash = 14695981039346656037ULL;
+	std::vector<char> chunk(1 << 16);
+	while (file)
+	{
+		file.read(chunk.data(), chunk.size());
+		const auto numRead = static_cast<size_t>(file.gcount());
+		for (size_t i = 0; i < numRead; i++)
+		{
+			hash ^= static_cast<unsigned char>(chunk[i]);
+			hash *= 1099511628211ULL;
+		}
+	}
+	return file.eof();
+}
+
+std::string TextureCache::getCacheFilename(const std::string& imageFilename, TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::BC1: return imageFilename + ".bc1";
+	case TextureFormat::BC7: return imageFilename + ".bc7";
+	default: return imageFilename + ".rgba";
+	}
+}
+
+bool TextureCache::contains(const std::string& imageFilename, uint64_t imageHash, const TextureArray& textureArray)
+{
+	std::ifstream file;
+	if (!openCacheFile(file, imageFilename, imageHash, textureArray)) {
+		return false;
+	}
+
+	// Truncated file, e.g. from a full disk, would fail only when reading the data
+	const auto dataStart = file.tellg();
+	file.seekg(0, std::ios::end);
+	return static_cast<uint64_t>(file.tellg() - dataStart) == textureArray.getLayerDataSize();
+}
+
+bool TextureCache::load(const std::string& imageFilename, uint64_t imageHash, const TextureArray& textureArray, unsigned char* layerData)
+{
+	std::ifstream file;
+	if (!openCacheFile(file, imageFilename, imageHash, textureArray)) {
+		return false;
+	}
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(layerData), textureArray.getLayerDataSize()));
+}
+
+bool TextureCache::save(const std::string& imageFilename, uint64_t imageHash, const TextureArray& textureArray, const unsigned char* layerData)
+{
+	// Empty layer (e.g. of destroyed texture array) would replace a good cache file with a useless one
+	if (layerData == nullptr || textureArray.getWidth() <= 0 || textureArray.getHeight() <= 0 || textureArray.getLayerDataSize() == 0)
+	{
+		std::cerr << "Refusing to write empty layer to texture cache of " << imageFilename << "!" << std::endl;
+		return false;
+	}
+
+	// Written under a temporary name and renamed, so that a crash or a concurrent startup never sees half of the file
+	const auto cacheFilename = getCacheFilename(imageFilename, textureArray.getFormat());
+	const auto temporaryFilename = cacheFilename + ".tmp";
+	{
+		std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+		const auto header = makeHeader(imageHash, textureArray);
+		if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header))
+			|| !file.write(reinterpret_cast<const char*>(layerData), header.dataSize))
+		{
+			std::cerr << "Failed to write texture cache file " << temporaryFilename << "!" << std::endl;
+			file.close();
+			std::remove(temporaryFilename.c_str());
+			return false;
+		}
+	}
+
+	// Windows can't rename over an existing file
+	std::remove(cacheFilename.c_str());
+	if (std::rename(temporaryFilename.c_str(), cacheFilename.c_str()) != 0)
+	{
+		std::cerr << "Failed to replace texture cache file " << cacheFilename << "!" << std::endl;
+		std::remove(temporaryFilename.c_str());
+		return false;
+	}
+	return true;
+}
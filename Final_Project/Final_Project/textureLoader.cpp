@@ -0,0 +1,393 @@
+// STL
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+
+// stb_image
+#include "stb_image.h"
+
+// Project
+#include "common/textureLoader.h"
+#include "common/textureCache.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Image decoded by worker thread, waiting for upload
+struct DecodedImage
+{
+	size_t index = 0;
+	std::vector<unsigned char> layerData; //! Only for synchronous load, streamed layers live in staging buffers
+	std::string error;
+	bool isCacheHit = false;
+	double decodeMilliseconds = 0.0;
+	double resampleMilliseconds = 0.0;
+	double compressMilliseconds = 0.0;
+};
+
+// Runs decoding jobs of stb_image on the loader's threads, so that one large image doesn't keep a single thread busy
+void parallelFor(void* threadPool, void (*job)(void* jobData, int index), void* jobData, int count)
+{
+	static_cast<ThreadPool*>(threadPool)->parallelFor(static_cast<size_t>(count), [job, jobData](size_t index) { job(jobData, static_cast<int>(index)); });
+}
+
+// Decodes image file into layer-sized memory given by acquireDestination, flipped to OpenGL's row order.
+// Images of the layer size are decoded straight into the destination, others are decoded and resampled into it.
+// Returns the destination, or nullptr if the image couldn't be loaded or there's no destination.
+unsigned char* decodeLayer(const std::string& filename, GLsizei layerWidth, GLsizei layerHeight,
+	const std::function<unsigned char*()>& acquireDestination, DecodedImage& decoded, ThreadPool& threadPool)
+{
+	const auto decodeStart = Clock::now();
+	int width, height, channels;
+	if (!stbi_info(filename.c_str(), &width, &height, &channels))
+	{
+		decoded.error = stbi_failure_reason();
+		return nullptr;
+	}
+
+	if (width == layerWidth && height == layerHeight)
+	{
+		auto destination = acquireDestination();
+		if (destination != nullptr && !stbi_load_into_parallel(filename.c_str(), destination, layerWidth, layerHeight, layerWidth * 4, 4, 1, parallelFor, &threadPool)) {
+			decoded.error = stbi_failure_reason();
+		}
+		decoded.decodeMilliseconds = millisecondsSince(decodeStart);
+		return destination;
+	}
+
+	unsigned char* image = stbi_load_parallel(filename.c_str(), &width, &height, &channels, 4, parallelFor, &threadPool);
+	decoded.decodeMilliseconds = millisecondsSince(decodeStart);
+	if (image == nullptr)
+	{
+		decoded.error = stbi_failure_reason();
+		return nullptr;
+	}
+
+	const auto resampleStart = Clock::now();
+	auto destination = acquireDestination();
+	if (destination != nullptr) {
+		TextureArray::resampleFlipped(image, width, height, destination, layerWidth, layerHeight);
+	}
+	stbi_image_free(image);
+	decoded.resampleMilliseconds = millisecondsSince(resampleStart);
+	return destination;
+}
+
+// Decodes image file, compresses it to the format of texture array and writes the cache file.
+// Returns true if successful or false otherwise (error is in decoded).
+bool compressLayer(const std::string& filename, uint64_t imageHash, const TextureArray& textureArray,
+	std::vector<unsigned char>& layerData, DecodedImage& decoded, ThreadPool& threadPool)
+{
+	const auto layerWidth = textureArray.getWidth();
+	const auto layerHeight = textureArray.getHeight();
+	std::vector<unsigned char> layerPixels;
+	decodeLayer(filename, layerWidth, layerHeight, [&layerPixels, layerWidth, layerHeight]()
+	{
+		layerPixels.resize(static_cast<size_t>(layerWidth) * layerHeight * 4);
+		return layerPixels.data();
+	}, decoded, threadPool);
+	if (!decoded.error.empty()) {
+		return false;
+	}
+
+	const auto compressStart = Clock::now();
+	layerData.resize(textureArray.getLayerDataSize());
+	textureArray.encodeLayer(layerPixels.data(), layerData.data());
+	decoded.compressMilliseconds = millisecondsSince(compressStart);
+
+	// Failing to write the cache only costs the next startup its speed, the layer is fine
+	TextureCache::save(filename, imageHash, textureArray, layerData.data());
+	return true;
+}
+
+// Loads layer data of image file in the format of texture array into memory given by acquireDestination.
+// Block-compressed layers are read from the cache, when it matches the image. Otherwise the image is decoded
+// and compressed before acquiring the destination, so that slow compression doesn't hold a staging buffer.
+// Returns the destination, or nullptr if the image couldn't be loaded before acquiring it or there's no destination.
+unsigned char* loadLayerData(const std::string& filename, const TextureArray& textureArray,
+	const std::function<unsigned char*()>& acquireDestination, DecodedImage& decoded, ThreadPool& threadPool)
+{
+	if (textureArray.getFormat() == TextureFormat::RGBA8) {
+		return decodeLayer(filename, textureArray.getWidth(), textureArray.getHeight(), acquireDestination, decoded, threadPool);
+	}
+
+	// Hashing reads the whole file, which is still a small fraction of decoding it
+	const auto hashStart = Clock::now();
+	uint64_t imageHash;
+	if (!TextureCache::hashFile(filename, imageHash))
+	{
+		decoded.error = "can't read file";
+		return nullptr;
+	}
+
+	std::vector<unsigned char> layerData;
+	if (TextureCache::contains(filename, imageHash, textureArray))
+	{
+		auto destination = acquireDestination();
+		if (destination == nullptr || TextureCache::load(filename, imageHash, textureArray, destination))
+		{
+			decoded.isCacheHit = destination != nullptr;
+			decoded.decodeMilliseconds = millisecondsSince(hashStart);
+			return destination;
+		}
+
+		// Cache file has changed since the check, the destination is already held, so it's filled from the image
+		if (compressLayer(filename, imageHash, textureArray, layerData, decoded, threadPool)) {
+			std::memcpy(destination, layerData.data(), layerData.size());
+		}
+		return destination;
+	}
+
+	const auto hashMilliseconds = millisecondsSince(hashStart);
+	if (!compressLayer(filename, imageHash, textureArray, layerData, decoded, threadPool)) {
+		return nullptr;
+	}
+	decoded.decodeMilliseconds += hashMilliseconds;
+
+	auto destination = acquireDestination();
+	if (destination != nullptr) {
+		std::memcpy(destination, layerData.data(), layerData.size());
+	}
+	return destination;
+}
+
+} // namespace
+
+TextureLoader::TextureLoader(unsigned int numThreads)
+	: _threadPool(numThreads)
+{
+}
+
+bool TextureLoader::loadLayers(TextureArray& textureArray, const std::vector<std::string>& filenames, std::vector<int>& layers)
+{
+	const auto loadStart = Clock::now();
+	Timings timings;
+	timings.numThreads = _threadPool.getNumThreads();
+	layers.assign(filenames.size(), -1);
+
+	const auto firstLayer = textureArray.reserveLayers(static_cast<int>(filenames.size()));
+	if (firstLayer < 0) {
+		return false;
+	}
+
+	// Workers push decoded images here, the calling thread uploads them in the order they come
+	std::mutex mutex;
+	std::condition_variable imageDecoded;
+	std::deque<DecodedImage> decodedImages;
+
+	for (size_t i = 0; i < filenames.size(); i++)
+	{
+		const auto& filename = filenames[i];
+		_threadPool.enqueue([&, i]()
+		{
+			DecodedImage decoded;
+			decoded.index = i;
+			loadLayerData(filename, textureArray, [&decoded, &textureArray]()
+			{
+				decoded.layerData.resize(textureArray.getLayerDataSize());
+				return decoded.layerData.data();
+			}, decoded, _threadPool);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				decodedImages.push_back(std::move(decoded));
+			}
+			imageDecoded.notify_one();
+		});
+	}
+
+	auto success = true;
+	for (size_t numUploaded = 0; numUploaded < filenames.size(); numUploaded++)
+	{
+		const auto waitStart = Clock::now();
+		DecodedImage decoded;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			imageDecoded.wait(lock, [&decodedImages]() { return !decodedImages.empty(); });
+			decoded = std::move(decodedImages.front());
+			decodedImages.pop_front();
+		}
+		timings.waitMilliseconds += millisecondsSince(waitStart);
+		timings.decodeMilliseconds += decoded.decodeMilliseconds;
+		timings.resampleMilliseconds += decoded.resampleMilliseconds;
+		timings.compressMilliseconds += decoded.compressMilliseconds;
+		timings.numCacheHits += decoded.isCacheHit ? 1 : 0;
+
+		if (!decoded.error.empty())
+		{
+			std::cerr << "Failed to load image " << filenames[decoded.index] << ": " << decoded.error << "!" << std::endl;
+			timings.numFailedImages++;
+			success = false;
+			continue;
+		}
+
+		const auto uploadStart = Clock::now();
+		const auto layer = firstLayer + static_cast<int>(decoded.index);
+		textureArray.uploadLayer(layer, decoded.layerData.data());
+		layers[decoded.index] = layer;
+		timings.uploadMilliseconds += millisecondsSince(uploadStart);
+		timings.numImages++;
+	}
+
+	// Workers may still be leaving the jobs, which reference local synchronization objects
+	_threadPool.waitIdle();
+
+	timings.totalMilliseconds = millisecondsSince(loadStart);
+	{
+		std::lock_guard<std::mutex> lock(_timingsMutex);
+		_timings = timings;
+	}
+	std::cout << "Loaded " << timings.numImages << " of " << filenames.size() << " textures in " << timings.totalMilliseconds << " ms on "
+		<< timings.numThreads << " threads (decode " << timings.decodeMilliseconds << " ms, resample " << timings.resampleMilliseconds
+		<< " ms, compress " << timings.compressMilliseconds << " ms summed over threads, " << timings.numCacheHits
+		<< " from cache; upload " << timings.uploadMilliseconds << " ms, waiting " << timings.waitMilliseconds << " ms on main thread)" << std::endl;
+	return success;
+}
+
+bool TextureLoader::loadLayersAsync(TextureArray& textureArray, const std::vector<std::string>& filenames, std::vector<int>& layers, TextureStreamer& streamer)
+{
+	const auto loadStart = Clock::now();
+	layers.assign(filenames.size(), -1);
+
+	const auto firstLayer = textureArray.reserveLayers(static_cast<int>(filenames.size()));
+	if (firstLayer < 0) {
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_timingsMutex);
+		_timings = Timings();
+		_timings.numThreads = _threadPool.getNumThreads();
+		_numLoadingImages += static_cast<int>(filenames.size());
+		_streamer = &streamer;
+	}
+
+	for (size_t i = 0; i < filenames.size(); i++)
+	{
+		const auto layer = firstLayer + static_cast<int>(i);
+		layers[i] = layer;
+
+		// Jobs outlive this call, so they get their own copy of the file name
+		_threadPool.enqueue([this, &textureArray, &streamer, filename = filenames[i], i, layer, loadStart]()
+		{
+			// Uncompressed and cached layers are written straight into mapped staging memory
+			DecodedImage decoded;
+			decoded.index = i;
+			const auto stagingBuffer = loadLayerData(filename, textureArray, [&streamer]() { return streamer.acquireStagingBuffer(); }, decoded, _threadPool);
+			if (stagingBuffer == nullptr && decoded.error.empty()) {
+				decoded.error = _isCancelling ? "loading is cancelled" : "texture streamer is destroyed";
+			}
+
+			if (decoded.error.empty()) {
+				streamer.queueStagedLayer(textureArray, layer, stagingBuffer);
+			}
+			else
+			{
+				if (stagingBuffer != nullptr) {
+					streamer.releaseStagingBuffer(stagingBuffer);
+				}
+				if (!_isCancelling) {
+					std::cerr << "Failed to load image " << filename << ": " << decoded.error << "!" << std::endl;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(_timingsMutex);
+			_timings.decodeMilliseconds += decoded.decodeMilliseconds;
+			_timings.resampleMilliseconds += decoded.resampleMilliseconds;
+			_timings.compressMilliseconds += decoded.compressMilliseconds;
+			_timings.numCacheHits += decoded.isCacheHit ? 1 : 0;
+			if (decoded.error.empty()) {
+				_timings.numImages++;
+			}
+			else {
+				_timings.numFailedImages++;
+			}
+			_timings.totalMilliseconds = millisecondsSince(loadStart);
+			_numLoadingImages--;
+		});
+	}
+
+	return true;
+}
+
+void TextureLoader::cancel()
+{
+	_isCancelling = true;
+	{
+		std::lock_guard<std::mutex> lock(_timingsMutex);
+		if (_streamer != nullptr) {
+			_streamer->cancelAcquires();
+		}
+	}
+
+	const auto numDropped = _threadPool.cancel();
+	{
+		std::lock_guard<std::mutex> lock(_timingsMutex);
+		_numLoadingImages = 0;
+		_streamer = nullptr;
+	}
+	_isCancelling = false;
+
+	if (numDropped > 0) {
+		std::cout << "Cancelled texture loading, " << numDropped << " queued jobs dropped" << std::endl;
+	}
+}
+
+bool TextureLoader::encodeLayers(const TextureArray& textureArray, const std::vector<std::string>& filenames, std::vector<std::vector<unsigned char>>& layerData)
+{
+	layerData.assign(filenames.size(), std::vector<unsigned char>());
+	std::vector<std::string> errors(filenames.size());
+	for (size_t i = 0; i < filenames.size(); i++)
+	{
+		// Every job fills only its own slots, so no locking is needed
+		_threadPool.enqueue([this, &textureArray, &filenames, &layerData, &errors, i]()
+		{
+			DecodedImage decoded;
+			decoded.index = i;
+			loadLayerData(filenames[i], textureArray, [&decoded, &textureArray]()
+			{
+				decoded.layerData.resize(textureArray.getLayerDataSize());
+				return decoded.layerData.data();
+			}, decoded, _threadPool);
+
+			errors[i] = decoded.error;
+			if (decoded.error.empty()) {
+				layerData[i] = std::move(decoded.layerData);
+			}
+		});
+	}
+	_threadPool.waitIdle();
+
+	auto success = true;
+	for (size_t i = 0; i < filenames.size(); i++)
+	{
+		if (!errors[i].empty())
+		{
+			std::cerr << "Failed to load image " << filenames[i] << ": " << errors[i] << "!" << std::endl;
+			success = false;
+		}
+	}
+	return success;
+}
+
+bool TextureLoader::isLoading() const
+{
+	std::lock_guard<std::mutex> lock(_timingsMutex);
+	return _numLoadingImages > 0;
+}
+
+TextureLoader::Timings TextureLoader::getLastTimings() const
+{
+	std::lock_guard<std::mutex> lock(_timingsMutex);
+	return _timings;
+}
@@ -0,0 +1,256 @@
+// STL
+#include <chrono>
+#include <iostream>
+
+// Project
+#include "common/textureStreamer.h"
+#include "common/gpuObjectCounter.h"
+
+bool TextureStreamer::create(size_t bufferSize, int numBuffers)
+{
+	if (_isCreated)
+	{
+		std::cerr << "This texture streamer is already created! You need to destroy it before re-creating it!" << std::endl;
+		return false;
+	}
+
+	if (bufferSize == 0 || numBuffers <= 0)
+	{
+		std::cerr << "Texture streamer needs at least one non-empty pixel buffer!" << std::endl;
+		return false;
+	}
+
+	// Coherent mapping makes worker writes visible to uploads issued after them, without flushing
+	const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	std::vector<StagingBuffer> buffers(numBuffers);
+	for (auto& buffer : buffers)
+	{
+		GpuObjectCounter::genBuffers(1, &buffer.bufferID);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.bufferID);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, bufferSize, nullptr, mapFlags);
+		buffer.mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bufferSize, mapFlags));
+		if (buffer.mapped == nullptr)
+		{
+			std::cerr << "Failed to map pixel buffer " << buffer.bufferID << " persistently!" << std::endl;
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			for (auto& createdBuffer : buffers) {
+				GpuObjectCounter::deleteBuffers(1, &createdBuffer.bufferID);
+			}
+			return false;
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_buffers = std::move(buffers);
+		_bufferSize = bufferSize;
+		_statistics = Statistics();
+		_isCreated = true;
+		_isAcquireCancelled = false;
+	}
+
+	std::cout << "Created texture streamer with " << numBuffers << " pixel buffers of " << bufferSize << " bytes" << std::endl;
+	return true;
+}
+
+unsigned char* TextureStreamer::acquireStagingBuffer()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto waited = false;
+	while (_isCreated && !_isAcquireCancelled)
+	{
+		for (auto& buffer : _buffers)
+		{
+			if (buffer.state == BufferState::Free)
+			{
+				buffer.state = BufferState::Writing;
+				_statistics.numStagingWaits += waited ? 1 : 0;
+				return buffer.mapped;
+			}
+		}
+
+		waited = true;
+		_bufferFreed.wait(lock);
+	}
+
+	return nullptr;
+}
+
+void TextureStreamer::cancelAcquires()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_isAcquireCancelled = true;
+	_bufferFreed.notify_all();
+}
+
+void TextureStreamer::queueStagedLayer(TextureArray& textureArray, int layer, unsigned char* stagingBuffer)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto buffer = findBuffer(stagingBuffer);
+		if (buffer == nullptr || buffer->state != BufferState::Writing) {
+			return;
+		}
+
+		buffer->state = BufferState::Queued;
+		buffer->textureArray = &textureArray;
+		buffer->layer = layer;
+		_queuedBuffers.push_back(buffer);
+	}
+
+	// destroy() may be waiting for the writing to finish
+	_bufferFreed.notify_all();
+}
+
+void TextureStreamer::releaseStagingBuffer(unsigned char* stagingBuffer)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto buffer = findBuffer(stagingBuffer);
+		if (buffer == nullptr || buffer->state != BufferState::Writing) {
+			return;
+		}
+		buffer->state = BufferState::Free;
+	}
+	_bufferFreed.notify_all();
+}
+
+void TextureStreamer::update(int maxUploads)
+{
+	if (!_isCreated) {
+		return;
+	}
+
+	const auto updateStart = std::chrono::steady_clock::now();
+	retireFinishedUploads();
+
+	for (; maxUploads > 0; maxUploads--)
+	{
+		StagingBuffer* buffer;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_queuedBuffers.empty()) {
+				break;
+			}
+			buffer = _queuedBuffers.front();
+			_queuedBuffers.pop_front();
+		}
+
+		// With pixel unpack buffer bound, the texture reads from the buffer at offset 0
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->bufferID);
+		buffer->textureArray->uploadLayer(buffer->layer, nullptr);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		buffer->textureArray->generateLayerMipmaps(buffer->layer);
+		const auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		buffer->fence = fence;
+		buffer->state = BufferState::InFlight;
+		_statistics.numUploadedLayers++;
+		_statistics.numUploadedBytes += buffer->textureArray->getLayerDataSize();
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_statistics.updateMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - updateStart).count();
+}
+
+size_t TextureStreamer::getBufferSize() const
+{
+	return _bufferSize;
+}
+
+int TextureStreamer::getNumPendingLayers() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto numPending = 0;
+	for (const auto& buffer : _buffers)
+	{
+		if (buffer.state != BufferState::Free) {
+			numPending++;
+		}
+	}
+	return numPending;
+}
+
+TextureStreamer::Statistics TextureStreamer::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _statistics;
+}
+
+void TextureStreamer::destroy()
+{
+	std::vector<StagingBuffer> buffers;
+	{
+		// Workers waiting for a buffer give up, workers writing to one must finish before it's unmapped
+		std::unique_lock<std::mutex> lock(_mutex);
+		_isCreated = false;
+		_bufferFreed.notify_all();
+		_bufferFreed.wait(lock, [this]()
+		{
+			for (const auto& buffer : _buffers)
+			{
+				if (buffer.state == BufferState::Writing) {
+					return false;
+				}
+			}
+			return true;
+		});
+
+		buffers.swap(_buffers);
+		_queuedBuffers.clear();
+		_bufferSize = 0;
+	}
+
+	for (auto& buffer : buffers)
+	{
+		if (buffer.fence != nullptr) {
+			glDeleteSync(buffer.fence);
+		}
+
+		// Deleting a buffer unmaps it
+		GpuObjectCounter::deleteBuffers(1, &buffer.bufferID);
+	}
+}
+
+TextureStreamer::StagingBuffer* TextureStreamer::findBuffer(const unsigned char* mapped)
+{
+	for (auto& buffer : _buffers)
+	{
+		if (buffer.mapped == mapped) {
+			return &buffer;
+		}
+	}
+	return nullptr;
+}
+
+void TextureStreamer::retireFinishedUploads()
+{
+	auto numFreed = 0;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (auto& buffer : _buffers)
+		{
+			if (buffer.state != BufferState::InFlight) {
+				continue;
+			}
+
+			// Zero timeout only polls the fence, it never blocks the render loop
+			const auto status = glClientWaitSync(buffer.fence, 0, 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+				continue;
+			}
+
+			glDeleteSync(buffer.fence);
+			buffer.fence = nullptr;
+			buffer.state = BufferState::Free;
+			_statistics.numResidentLayers++;
+			numFreed++;
+		}
+	}
+
+	if (numFreed > 0) {
+		_bufferFreed.notify_all();
+	}
+}
@@ -0,0 +1,139 @@
+// STL
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+// Project
+#include "common/threadPool.h"
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+{
+	if (numThreads == 0) {
+		numThreads = std::thread::hardware_concurrency();
+	}
+	if (numThreads == 0) {
+		numThreads = 1;
+	}
+
+	for (unsigned int i = 0; i < numThreads; i++) {
+		_workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_jobQueued.notify_all();
+
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::enqueue(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_isCancelling) {
+			return;
+		}
+		_jobs.push_back(std::move(job));
+	}
+	_jobQueued.notify_one();
+}
+
+void ThreadPool::waitIdle()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_jobFinished.wait(lock, [this]() { return _jobs.empty() && _numBusyWorkers == 0; });
+}
+
+size_t ThreadPool::cancel()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	const auto numDropped = _jobs.size();
+	_jobs.clear();
+	_isCancelling = true;
+	_jobFinished.wait(lock, [this]() { return _numBusyWorkers == 0; });
+	_isCancelling = false;
+
+	// Waiters of waitIdle may be waiting for the dropped jobs
+	_jobFinished.notify_all();
+	return numDropped;
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body)
+{
+	// Shared with helper jobs, which may start only after the loop is over (they find no indices left then)
+	struct Loop
+	{
+		std::function<void(size_t)> body;
+		size_t count = 0;
+		std::atomic<size_t> nextIndex{ 0 };
+		std::atomic<size_t> numFinished{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	const auto loop = std::make_shared<Loop>();
+	loop->body = body;
+	loop->count = count;
+	const auto run = [](Loop& loop)
+	{
+		size_t numFinished = 0;
+		for (auto index = loop.nextIndex++; index < loop.count; index = loop.nextIndex++)
+		{
+			loop.body(index);
+			numFinished++;
+		}
+
+		if (numFinished > 0 && (loop.numFinished += numFinished) == loop.count)
+		{
+			std::lock_guard<std::mutex> lock(loop.mutex);
+			loop.finished.notify_all();
+		}
+	};
+
+	// Waiting for helpers to start would deadlock a job calling this, so the calling thread never waits for them
+	const auto numHelpers = std::min(count > 0 ? count - 1 : 0, _workers.size());
+	for (size_t i = 0; i < numHelpers; i++) {
+		enqueue([loop, run]() { run(*loop); });
+	}
+
+	run(*loop);
+	std::unique_lock<std::mutex> lock(loop->mutex);
+	loop->finished.wait(lock, [&loop]() { return loop->numFinished == loop->count; });
+}
+
+unsigned int ThreadPool::getNumThreads() const
+{
+	return static_cast<unsigned int>(_workers.size());
+}
+
+void ThreadPool::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_jobQueued.wait(lock, [this]() { return _isStopping || !_jobs.empty(); });
+
+		// Queued jobs are finished even when stopping (cancel drops them first, if they must not run)
+		if (_jobs.empty()) {
+			return;
+		}
+
+		auto job = std::move(_jobs.front());
+		_jobs.pop_front();
+		_numBusyWorkers++;
+
+		lock.unlock();
+		job();
+		lock.lock();
+
+		_numBusyWorkers--;
+		_jobFinished.notify_all();
+	}
+}
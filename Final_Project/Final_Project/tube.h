@@ -10,10 +10,13 @@ namespace static_meshes_3D {
 	{
 	public:
 		Tube(float radius, int numSlices, float height,
-			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true);
+			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, VertexLayout layout = VertexLayout::Planar,
+			const VertexEncoding& encoding = VertexEncoding());
 
 		void render() const override;
 		void renderPoints() const override;
+		void renderInstanced(GLsizei numInstances) const override;
+		std::vector<DrawRange> getDrawRanges() const override;
 
 		/**
 		 * Gets cylinder radius.
@@ -35,9 +38,7 @@ namespace static_meshes_3D {
 		int _numSlices; // Number of cylinder slices
 		float _height; // Height of the cylinder
 
-		int _numVerticesSide; // How many vertices to render side of the cylinder
-		int _numVerticesTopBottom; // How many vertices to render top / bottom of the cylinder
-		int _numVerticesTotal; // Just a sum of both numbers above
+		int _numVerticesSide; // How many vertices to render side of the tube (all vertices it has)
 
 		void initializeData() override;
 	};
@@ -0,0 +1,10 @@
+// Project
+#include "tubeIndexed.h"
+
+namespace static_meshes_3D {
+
+	TubeIndexed::TubeIndexed(float radius, int numSlices, float height, bool withPositions, bool withTextureCoordinates, bool withNormals,
+		VertexLayout layout, const VertexEncoding& encoding)
+		: CylinderIndexed(radius, numSlices, height, false, withPositions, withTextureCoordinates, withNormals, layout, encoding) {}
+
+} // namespace static_meshes_3D
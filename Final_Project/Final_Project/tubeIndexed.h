@@ -0,0 +1,18 @@
+#pragma once
+#include "cylinderIndexed.h"
+
+namespace static_meshes_3D {
+
+	/**
+	* Tube static mesh with given radius, number of slices and height, rendered with indices.
+	* It's an indexed cylinder without covers, only its side is generated.
+	*/
+	class TubeIndexed : public CylinderIndexed
+	{
+	public:
+		TubeIndexed(float radius, int numSlices, float height,
+			bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, VertexLayout layout = VertexLayout::Planar,
+			const VertexEncoding& encoding = VertexEncoding());
+	};
+
+} // namespace static_meshes_3D
@@ -1,11 +1,22 @@
 // STL
+#include <algorithm>
 #include <iostream>
 #include <cstring>
 
 // Project
 #include "common/vertexBufferObject.h"
+#include "common/gpuObjectCounter.h"
 #include <glad\glad.h>
 
+namespace {
+
+// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT and its shader storage counterpart are at most 256 bytes,
+// so regions of this alignment can be bound as blocks on any implementation
+const size_t FRAME_REGION_ALIGNMENT = 256;
+const GLuint64 FENCE_WAIT_TIMEOUT_NS = 1000000; //! 1 ms
+
+} // namespace
+
 void VertexBufferObject::createVBO(size_t reserveSizeBytes)
 {
     if (_isBufferCreated)
@@ -14,16 +25,134 @@ void VertexBufferObject::createVBO(size_t reserveSizeBytes)
         return;
     }
 
-    glGenBuffers(1, &_bufferID);
-    _rawData.reserve(reserveSizeBytes > 0 ? reserveSizeBytes : 1024);
+    GpuObjectCounter::genBuffers(1, &_bufferID);
+    reserveRawData(reserveSizeBytes > 0 ? reserveSizeBytes : 1024);
 
     std::cout << "Created vertex buffer object with ID " << _bufferID << " and initial reserved size " << _rawData.capacity() << " bytes" << std::endl;
     _isBufferCreated = true;
 }
 
-//void VertexBufferObject::createVBO(uint32_t reserveSizeBytes)
-//{
-//}
+bool VertexBufferObject::createStreamingVBO(size_t regionSizeBytes, size_t numRegions, GLenum bufferType)
+{
+    if (_isBufferCreated)
+    {
+        std::cerr << "This buffer is already created! You need to delete it before re-creating it!" << std::endl;
+        return false;
+    }
+
+    if (regionSizeBytes == 0 || numRegions == 0)
+    {
+        std::cerr << "Streaming buffer needs at least one non-empty frame region!" << std::endl;
+        return false;
+    }
+
+    _regionSize = (regionSizeBytes + FRAME_REGION_ALIGNMENT - 1) / FRAME_REGION_ALIGNMENT * FRAME_REGION_ALIGNMENT;
+    const auto bufferSize = _regionSize * numRegions;
+
+    // Coherent mapping makes writes visible to the GPU without flushing, fences only keep the CPU from overwriting data being read
+    const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    _bufferType = bufferType;
+    GpuObjectCounter::genBuffers(1, &_bufferID);
+    glBindBuffer(_bufferType, _bufferID);
+    glBufferStorage(_bufferType, bufferSize, nullptr, mapFlags);
+    _streamingData = static_cast<unsigned char*>(glMapBufferRange(_bufferType, 0, bufferSize, mapFlags));
+    if (_streamingData == nullptr)
+    {
+        std::cerr << "Failed to map streaming buffer persistently!" << std::endl;
+        GpuObjectCounter::deleteBuffers(1, &_bufferID);
+        _bufferID = 0;
+        _regionSize = 0;
+        return false;
+    }
+
+    // The first beginFrameRegion moves to region 0
+    _regionFences.assign(numRegions, nullptr);
+    _currentRegion = numRegions - 1;
+    _numFenceWaits = 0;
+    _uploadedDataSize = bufferSize;
+    _isDataUploaded = true;
+    _isBufferCreated = true;
+
+    std::cout << "Created streaming buffer object with ID " << _bufferID << " and " << numRegions << " frame regions of " << _regionSize << " bytes" << std::endl;
+    return true;
+}
+
+void* VertexBufferObject::beginFrameRegion()
+{
+    if (!isStreaming()) {
+        return nullptr;
+    }
+
+    _currentRegion = (_currentRegion + 1) % _regionFences.size();
+    auto& fence = _regionFences[_currentRegion];
+    if (fence != nullptr)
+    {
+        // With enough regions the fence has long been signaled, only polling it then
+        auto waitResult = glClientWaitSync(fence, 0, 0);
+        if (waitResult == GL_TIMEOUT_EXPIRED)
+        {
+            // Flushing makes sure the fence gets to the GPU, otherwise the wait might never end
+            _numFenceWaits++;
+            do {
+                waitResult = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIMEOUT_NS);
+            } while (waitResult == GL_TIMEOUT_EXPIRED);
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    return _streamingData + getFrameRegionOffset();
+}
+
+void VertexBufferObject::endFrameRegion()
+{
+    if (!isStreaming()) {
+        return;
+    }
+
+    auto& fence = _regionFences[_currentRegion];
+    if (fence != nullptr) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void VertexBufferObject::bindFrameRegion(GLuint bindingPoint) const
+{
+    if (!isStreaming())
+    {
+        std::cerr << "This buffer is not streaming! Only frame regions of streaming buffers can be bound!" << std::endl;
+        return;
+    }
+
+    glBindBufferRange(_bufferType, bindingPoint, _bufferID, getFrameRegionOffset(), _regionSize);
+}
+
+size_t VertexBufferObject::getFrameRegionOffset() const
+{
+    return _regionSize * _currentRegion;
+}
+
+size_t VertexBufferObject::getFrameRegionSize() const
+{
+    return _regionSize;
+}
+
+size_t VertexBufferObject::getNumFenceWaits() const
+{
+    return _numFenceWaits;
+}
+
+bool VertexBufferObject::isStreaming() const
+{
+    return _streamingData != nullptr;
+}
+
+void VertexBufferObject::reserveRawData(size_t reserveSizeBytes)
+{
+    _rawData.reserve(reserveSizeBytes);
+}
 
 void VertexBufferObject::bindVBO(GLenum bufferType)
 {
@@ -37,51 +166,83 @@ void VertexBufferObject::bindVBO(GLenum bufferType)
     glBindBuffer(_bufferType, _bufferID);
 }
 
-//void VertexBufferObject::addRawData(const void* ptrData, uint32_t dataSizeBytes, int repeat)
-//{
-//}
-
-void VertexBufferObject::addRawData(const void* ptrData, size_t dataSize, int repeat)
+void VertexBufferObject::addRawData(const void* ptrData, size_t dataSizeBytes, size_t repeat)
 {
-    const auto bytesToAdd = dataSize * repeat;
-    const auto requiredCapacity = _bytesAdded + bytesToAdd;
-    if (requiredCapacity > _rawData.capacity())
-    {
-        auto newCapacity = _rawData.capacity() * 2;
-        while (newCapacity < requiredCapacity) {
-            newCapacity *= 2;
-        }
+    const auto bytesToAdd = dataSizeBytes * repeat;
+    if (bytesToAdd == 0) {
+        return;
+    }
+
+    const auto destination = static_cast<unsigned char*>(appendRawData(bytesToAdd));
+    memcpy(destination, ptrData, dataSizeBytes);
 
-        std::vector<unsigned char> newRawData;
-        newRawData.reserve(newCapacity);
-        memcpy(newRawData.data(), _rawData.data(), _bytesAdded);
-        _rawData = std::move(newRawData);
+    // Repeats are broadcast by doubling the already copied part, so that N repeats take log2(N) copies
+    for (auto bytesCopied = dataSizeBytes; bytesCopied < bytesToAdd; bytesCopied *= 2) {
+        memcpy(destination + bytesCopied, destination, std::min(bytesCopied, bytesToAdd - bytesCopied));
     }
+}
 
-    for (int i = 0; i < repeat; i++)
+void* VertexBufferObject::appendRawData(size_t dataSizeBytes)
+{
+    if (_adoptedDataOwner)
     {
-        memcpy(_rawData.data() + _bytesAdded, ptrData, dataSize);
-        _bytesAdded += dataSize;
+        _rawData.assign(static_cast<const unsigned char*>(_adoptedData), static_cast<const unsigned char*>(_adoptedData) + _adoptedDataSize);
+        _adoptedDataOwner.reset();
+        _adoptedData = nullptr;
+        _adoptedDataSize = 0;
     }
+
+    // Vector grows its capacity geometrically, so appending element by element stays amortized O(1),
+    // appended bytes are left uninitialized for the caller to write
+    const auto offset = _rawData.size();
+    _rawData.resize(offset + dataSizeBytes);
+    return _rawData.data() + offset;
+}
+
+void VertexBufferObject::clearRawData()
+{
+    _rawData.clear();
+    _adoptedDataOwner.reset();
+    _adoptedData = nullptr;
+    _adoptedDataSize = 0;
 }
 
 void* VertexBufferObject::getRawDataPointer()
 {
-    return _rawData.data();
+    return _adoptedDataOwner ? _adoptedData : _rawData.data();
+}
+
+size_t VertexBufferObject::getRawDataSize() const
+{
+    return _adoptedDataOwner ? _adoptedDataSize : _rawData.size();
 }
 
 void VertexBufferObject::uploadDataToGPU(GLenum usageHint)
 {
-    if (!_isBufferCreated)
+    if (!_isBufferCreated || isStreaming())
+    {
+        std::cerr << "This buffer is not created yet or is streaming! Call createVBO before uploading data to GPU!" << std::endl;
+        return;
+    }
+
+    _uploadedDataSize = getRawDataSize();
+    glBufferData(_bufferType, _uploadedDataSize, getRawDataPointer(), usageHint);
+    _isDataUploaded = true;
+    clearRawData();
+}
+
+void VertexBufferObject::uploadDataToGPU(const void* ptrData, size_t dataSize, GLenum usageHint)
+{
+    if (!_isBufferCreated || isStreaming())
     {
-        std::cerr << "This buffer is not created yet! Call createVBO before uploading data to GPU!" << std::endl;
+        std::cerr << "This buffer is not created yet or is streaming! Call createVBO before uploading data to GPU!" << std::endl;
         return;
     }
 
-    glBufferData(_bufferType, _bytesAdded, _rawData.data(), usageHint);
+    glBufferData(_bufferType, dataSize, ptrData, usageHint);
     _isDataUploaded = true;
-    _uploadedDataSize = _bytesAdded;
-    _bytesAdded = 0;
+    _uploadedDataSize = dataSize;
+    clearRawData();
 }
 
 void* VertexBufferObject::mapBufferToMemory(GLenum usageHint) const
@@ -90,21 +251,31 @@ void* VertexBufferObject::mapBufferToMemory(GLenum usageHint) const
         return nullptr;
     }
 
+    if (isStreaming()) {
+        return _streamingData;
+    }
+
     return glMapBuffer(_bufferType, usageHint);
 }
 
 void* VertexBufferObject::mapSubBufferToMemory(GLenum usageHint, size_t offset, size_t length) const
 {
-    if (!_isDataUploaded) {
+    if (!_isDataUploaded || offset + length > _uploadedDataSize) {
         return nullptr;
     }
 
+    if (isStreaming()) {
+        return _streamingData + offset;
+    }
+
     return glMapBufferRange(_bufferType, offset, length, usageHint);
 }
 
 void VertexBufferObject::unmapBuffer() const
 {
-    glUnmapBuffer(_bufferType);
+    if (!isStreaming()) {
+        glUnmapBuffer(_bufferType);
+    }
 }
 
 GLuint VertexBufferObject::getBufferID() const
@@ -112,28 +283,9 @@ GLuint VertexBufferObject::getBufferID() const
     return _bufferID;
 }
 
-void* VertexBufferObject::mapBufferToMemory(GLenum usageHint)
-{
-    return nullptr;
-}
-
-void* VertexBufferObject::mapSubBufferToMemory(GLenum usageHint, uint32_t offset, uint32_t length)
+size_t VertexBufferObject::getBufferSize() const
 {
-    return nullptr;
-}
-
-void VertexBufferObject::unmapBuffer()
-{
-}
-
-GLuint VertexBufferObject::getBufferID()
-{
-    return GLuint();
-}
-
-size_t VertexBufferObject::getBufferSize()
-{
-    return _isDataUploaded ? _uploadedDataSize : _bytesAdded;
+    return _isDataUploaded ? _uploadedDataSize : getRawDataSize();
 }
 
 void VertexBufferObject::deleteVBO()
@@ -143,7 +295,20 @@ void VertexBufferObject::deleteVBO()
     }
 
     std::cout << "Deleting vertex buffer object with ID " << _bufferID << "..." << std::endl;
-    glDeleteBuffers(1, &_bufferID);
+    for (const auto fence : _regionFences)
+    {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+    }
+    _regionFences.clear();
+
+    // Deleting the buffer unmaps its persistent mapping too
+    GpuObjectCounter::deleteBuffers(1, &_bufferID);
+    _streamingData = nullptr;
+    _regionSize = 0;
+    clearRawData();
+    _uploadedDataSize = 0;
     _isDataUploaded = false;
     _isBufferCreated = false;
 }
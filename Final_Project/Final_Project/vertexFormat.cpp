@@ -0,0 +1,323 @@
+// STL
+#include <algorithm>
+#include <cstring>
+
+// GLM
+#include <glm/gtc/packing.hpp>
+#include <glm/gtx/transform.hpp>
+
+// Project
+#include "common/vertexFormat.h"
+#include "common/staticMesh3D.h"
+
+namespace static_meshes_3D {
+
+namespace {
+
+// Writes float components as 16-bit values produced by glm packing function
+template<typename PackFunction>
+void writeShorts(unsigned char* destination, const float* components, int numComponents, PackFunction pack)
+{
+	for (int i = 0; i < numComponents; i++)
+	{
+		const glm::uint16 value = pack(components[i]);
+		memcpy(destination + sizeof(value) * i, &value, sizeof(value));
+	}
+}
+
+// Reads 16-bit values back to float components with glm unpacking function
+template<typename UnpackFunction>
+void readShorts(const unsigned char* source, float* components, int numComponents, UnpackFunction unpack)
+{
+	for (int i = 0; i < numComponents; i++)
+	{
+		glm::uint16 value;
+		memcpy(&value, source + sizeof(value) * i, sizeof(value));
+		components[i] = unpack(value);
+	}
+}
+
+} // namespace
+
+VertexEncoding VertexEncoding::compact()
+{
+	VertexEncoding result;
+	result.positions = PositionEncoding::Snorm16;
+	result.normals = NormalEncoding::Packed;
+	result.texCoords = TexCoordEncoding::Unorm16;
+	return result;
+}
+
+VertexFormat::VertexFormat(bool withPositions, bool withTextureCoordinates, bool withNormals, VertexLayout layout, const VertexEncoding& encoding)
+	: _hasPositions(withPositions)
+	, _hasTextureCoordinates(withTextureCoordinates)
+	, _hasNormals(withNormals)
+	, _layout(layout)
+	, _encoding(encoding)
+{
+	buildAttributes();
+}
+
+void VertexFormat::buildAttributes()
+{
+	_attributes.clear();
+	_vertexByteSize = 0;
+
+	// Attributes of 16-bit components are padded to 4 bytes, so that every attribute starts aligned
+	const auto addAttribute = [this](int index, GLint numComponents, GLenum type, GLboolean normalized, GLsizei byteSize)
+	{
+		_attributes.push_back({ index, numComponents, type, normalized, byteSize, size_t(_vertexByteSize) });
+		_vertexByteSize += byteSize;
+	};
+
+	if (_hasPositions)
+	{
+		switch (_encoding.positions)
+		{
+		case PositionEncoding::Half:
+			addAttribute(StaticMesh3D::POSITION_ATTRIBUTE_INDEX, 3, GL_HALF_FLOAT, GL_FALSE, 8);
+			break;
+		case PositionEncoding::Snorm16:
+			addAttribute(StaticMesh3D::POSITION_ATTRIBUTE_INDEX, 3, GL_SHORT, GL_TRUE, 8);
+			break;
+		default:
+			addAttribute(StaticMesh3D::POSITION_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3));
+			break;
+		}
+	}
+
+	if (_hasTextureCoordinates)
+	{
+		switch (_encoding.texCoords)
+		{
+		case TexCoordEncoding::Half:
+			addAttribute(StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX, 2, GL_HALF_FLOAT, GL_FALSE, 4);
+			break;
+		case TexCoordEncoding::Unorm16:
+			addAttribute(StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX, 2, GL_UNSIGNED_SHORT, GL_TRUE, 4);
+			break;
+		default:
+			addAttribute(StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2));
+			break;
+		}
+	}
+
+	if (_hasNormals)
+	{
+		// Packed type needs all 4 components, shaders read only x, y and z of them
+		if (_encoding.normals == NormalEncoding::Packed) {
+			addAttribute(StaticMesh3D::NORMAL_ATTRIBUTE_INDEX, 4, GL_INT_2_10_10_10_REV, GL_TRUE, 4);
+		}
+		else {
+			addAttribute(StaticMesh3D::NORMAL_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3));
+		}
+	}
+}
+
+VertexLayout VertexFormat::getLayout() const
+{
+	return _layout;
+}
+
+const VertexEncoding& VertexFormat::getEncoding() const
+{
+	return _encoding;
+}
+
+glm::mat4 VertexFormat::getPositionDequantization() const
+{
+	switch (_hasPositions ? _encoding.positions : PositionEncoding::Float)
+	{
+	case PositionEncoding::Half:
+		return glm::translate(_positionCenter);
+	case PositionEncoding::Snorm16:
+		return glm::translate(_positionCenter) * glm::scale(glm::vec3(_positionScale));
+	default:
+		return glm::mat4(1.0f);
+	}
+}
+
+GLsizei VertexFormat::getVertexByteSize() const
+{
+	return _vertexByteSize;
+}
+
+const std::vector<VertexFormat::Attribute>& VertexFormat::getAttributes() const
+{
+	return _attributes;
+}
+
+size_t VertexFormat::getAttributeOffset(const Attribute& attribute, size_t numVertices) const
+{
+	// Planar streams are stored one after another, offset of an interleaved attribute is its offset within vertex
+	return _layout == VertexLayout::Interleaved ? attribute.vertexOffset : attribute.vertexOffset * numVertices;
+}
+
+GLsizei VertexFormat::getAttributeStride(const Attribute& attribute) const
+{
+	return _layout == VertexLayout::Interleaved ? _vertexByteSize : attribute.byteSize;
+}
+
+std::vector<unsigned char> VertexFormat::packVertices(size_t numVertices, const glm::vec3* positions, const glm::vec2* texCoords, const glm::vec3* normals)
+{
+	// Positions are quantized relative to the bounds of this mesh, uniformly on all axes
+	if (positions != nullptr && numVertices > 0)
+	{
+		auto boundsMin = positions[0];
+		auto boundsMax = positions[0];
+		for (size_t i = 1; i < numVertices; i++)
+		{
+			boundsMin = glm::min(boundsMin, positions[i]);
+			boundsMax = glm::max(boundsMax, positions[i]);
+		}
+
+		const auto halfSize = (boundsMax - boundsMin) * 0.5f;
+		_positionCenter = boundsMin + halfSize;
+		_positionScale = std::max(std::max(halfSize.x, halfSize.y), halfSize.z);
+		if (_positionScale <= 0.0f) {
+			_positionScale = 1.0f;
+		}
+	}
+
+	// Coordinates repeating the texture (e.g. twice around cylinder) don't fit unorm16, half floats hold them instead
+	if (_encoding.texCoords == TexCoordEncoding::Unorm16 && texCoords != nullptr)
+	{
+		const auto isNormalized = std::all_of(texCoords, texCoords + numVertices, [](const glm::vec2& texCoord) {
+			return texCoord.x >= 0.0f && texCoord.x <= 1.0f && texCoord.y >= 0.0f && texCoord.y <= 1.0f;
+		});
+		if (!isNormalized)
+		{
+			_encoding.texCoords = TexCoordEncoding::Half;
+			buildAttributes();
+		}
+	}
+
+	std::vector<unsigned char> result(size_t(_vertexByteSize) * numVertices);
+	for (const auto& attribute : _attributes)
+	{
+		auto destination = result.data() + getAttributeOffset(attribute, numVertices);
+		const auto stride = getAttributeStride(attribute);
+		if (attribute.index == StaticMesh3D::POSITION_ATTRIBUTE_INDEX && positions != nullptr)
+		{
+			for (size_t i = 0; i < numVertices; i++, destination += stride)
+			{
+				const auto centered = positions[i] - _positionCenter;
+				const auto quantized = centered / _positionScale;
+				switch (_encoding.positions)
+				{
+				case PositionEncoding::Half:
+					writeShorts(destination, &centered.x, 3, glm::packHalf1x16);
+					break;
+				case PositionEncoding::Snorm16:
+					writeShorts(destination, &quantized.x, 3, glm::packSnorm1x16);
+					break;
+				default:
+					memcpy(destination, &positions[i], sizeof(glm::vec3));
+					break;
+				}
+			}
+		}
+		else if (attribute.index == StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX && texCoords != nullptr)
+		{
+			for (size_t i = 0; i < numVertices; i++, destination += stride)
+			{
+				switch (_encoding.texCoords)
+				{
+				case TexCoordEncoding::Half:
+					writeShorts(destination, &texCoords[i].x, 2, glm::packHalf1x16);
+					break;
+				case TexCoordEncoding::Unorm16:
+					writeShorts(destination, &texCoords[i].x, 2, glm::packUnorm1x16);
+					break;
+				default:
+					memcpy(destination, &texCoords[i], sizeof(glm::vec2));
+					break;
+				}
+			}
+		}
+		else if (attribute.index == StaticMesh3D::NORMAL_ATTRIBUTE_INDEX && normals != nullptr)
+		{
+			for (size_t i = 0; i < numVertices; i++, destination += stride)
+			{
+				if (_encoding.normals == NormalEncoding::Packed)
+				{
+					const glm::uint32 packed = glm::packSnorm3x10_1x2(glm::vec4(normals[i], 0.0f));
+					memcpy(destination, &packed, sizeof(packed));
+				}
+				else {
+					memcpy(destination, &normals[i], sizeof(glm::vec3));
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+void VertexFormat::unpackVertices(const unsigned char* data, size_t numVertices, std::vector<glm::vec3>& positions, std::vector<glm::vec2>& texCoords, std::vector<glm::vec3>& normals) const
+{
+	positions.assign(numVertices, glm::vec3(0.0f));
+	texCoords.assign(numVertices, glm::vec2(0.0f));
+	normals.assign(numVertices, glm::vec3(0.0f));
+	for (const auto& attribute : _attributes)
+	{
+		auto source = data + getAttributeOffset(attribute, numVertices);
+		const auto stride = getAttributeStride(attribute);
+		for (size_t i = 0; i < numVertices; i++, source += stride)
+		{
+			if (attribute.index == StaticMesh3D::POSITION_ATTRIBUTE_INDEX)
+			{
+				switch (_encoding.positions)
+				{
+				case PositionEncoding::Half:
+					readShorts(source, &positions[i].x, 3, glm::unpackHalf1x16);
+					positions[i] += _positionCenter;
+					break;
+				case PositionEncoding::Snorm16:
+					readShorts(source, &positions[i].x, 3, glm::unpackSnorm1x16);
+					positions[i] = _positionCenter + positions[i] * _positionScale;
+					break;
+				default:
+					memcpy(&positions[i], source, sizeof(glm::vec3));
+					break;
+				}
+			}
+			else if (attribute.index == StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX)
+			{
+				switch (_encoding.texCoords)
+				{
+				case TexCoordEncoding::Half:
+					readShorts(source, &texCoords[i].x, 2, glm::unpackHalf1x16);
+					break;
+				case TexCoordEncoding::Unorm16:
+					readShorts(source, &texCoords[i].x, 2, glm::unpackUnorm1x16);
+					break;
+				default:
+					memcpy(&texCoords[i], source, sizeof(glm::vec2));
+					break;
+				}
+			}
+			else if (_encoding.normals == NormalEncoding::Packed)
+			{
+				glm::uint32 packed;
+				memcpy(&packed, source, sizeof(packed));
+				normals[i] = glm::vec3(glm::unpackSnorm3x10_1x2(packed));
+			}
+			else {
+				memcpy(&normals[i], source, sizeof(glm::vec3));
+			}
+		}
+	}
+}
+
+void VertexFormat::setupAttributePointers(size_t numVertices) const
+{
+	for (const auto& attribute : _attributes)
+	{
+		glEnableVertexAttribArray(attribute.index);
+		glVertexAttribPointer(attribute.index, attribute.numComponents, attribute.type, attribute.normalized, getAttributeStride(attribute),
+			reinterpret_cast<void*>(getAttributeOffset(attribute, numVertices)));
+	}
+}
+
+} // namespace static_meshes_3D